@@ -0,0 +1,142 @@
+#include "benchfixtures.h"
+#include "fingerprintcache.h"
+#include "hardwarelock.h"
+#include "licenseverifier.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <filesystem>
+
+/**
+ * @brief Runs one hardware probe per iteration.
+ * @param state Benchmark state.
+ * @param probe Probe to time.
+ */
+static void runProbe(benchmark::State &state, std::string (*probe)()) {
+    for (auto _ : state) {
+        std::string value = probe();
+        benchmark::DoNotOptimize(value.data());
+    }
+}
+
+/**
+ * @brief MAC address lookup (native adapter ranking, then the QNetworkInterface walk).
+ */
+static void BM_Probe_MacAddress(benchmark::State &state) {
+    runProbe(state, &HardwareLock::getMacAddress);
+}
+BENCHMARK(BM_Probe_MacAddress)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Disk serial lookup (native call, then command fallbacks).
+ */
+static void BM_Probe_DiskSerial(benchmark::State &state) {
+    runProbe(state, &HardwareLock::getDiskSerialNumber);
+}
+BENCHMARK(BM_Probe_DiskSerial)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief CPU identifier lookup.
+ */
+static void BM_Probe_CpuId(benchmark::State &state) {
+    runProbe(state, &HardwareLock::getCpuId);
+}
+BENCHMARK(BM_Probe_CpuId)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Full fingerprint: all probes plus hashing.
+ */
+static void BM_Probe_HardwareFingerprint(benchmark::State &state) {
+    runProbe(state, &HardwareLock::getHardwareFingerprint);
+}
+BENCHMARK(BM_Probe_HardwareFingerprint)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief HardwareLock::verifyLicense(), which parses the key on every call.
+ * @param state Benchmark state; range(0) is 0 for a HEX and 1 for a Base64 signature.
+ */
+static void BM_HardwareLock_VerifyLicense(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    const std::string &signature = state.range(0) == 0 ? f.rsaSignatureHex : f.rsaSignatureBase64;
+    state.SetLabel(state.range(0) == 0 ? "hex" : "base64");
+
+    for (auto _ : state) {
+        if (!HardwareLock::verifyLicense(f.hardwareId, signature, f.rsaPublicKeyPath)) {
+            state.SkipWithError("signature did not verify");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_HardwareLock_VerifyLicense)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief JSON parse of license.lic as done by the client.
+ */
+static void BM_ParseJsonLicense(benchmark::State &state) {
+    QFile file(QString::fromStdString(BenchFixtures::instance().jsonLicensePath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        state.SkipWithError("could not open license file");
+        return;
+    }
+    const QByteArray data = file.readAll();
+
+    for (auto _ : state) {
+        QJsonObject obj = QJsonDocument::fromJson(data).object();
+        QString fingerprint = obj["hardwareId"].toString();
+        QString signature = obj["signature"].toString();
+        benchmark::DoNotOptimize(fingerprint);
+        benchmark::DoNotOptimize(signature);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ParseJsonLicense);
+
+/**
+ * @brief Client start-up path up to the signature check, without the UI.
+ *
+ * Mirrors main(): fingerprint, read and parse license.lic, load the public
+ * key and verify. range(0) selects a cold start (0: fingerprint cache
+ * disabled) or a warm start (1: fingerprint read from the cache).
+ */
+static void BM_ClientStartup(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    const bool cached = state.range(0) != 0;
+    state.SetLabel(cached ? "cached fingerprint" : "cold");
+
+    const std::filesystem::path dir(f.directory);
+    const QString cachePath = QString::fromStdString((dir / "fingerprint.cache").string());
+    const QString licensePath = QString::fromStdString((dir / "startup.lic").string());
+    QFile::remove(cachePath);
+
+    // License for this machine, so the benchmark exercises the success path
+    std::string fingerprint = FingerprintCache::getFingerprint(cachePath, cached ? FingerprintCache::DefaultMaxAgeSeconds : 0);
+    if (!f.writeRsaLicense(fingerprint, licensePath.toStdString())) {
+        state.SkipWithError("could not write license");
+        return;
+    }
+
+    for (auto _ : state) {
+        std::string local = FingerprintCache::getFingerprint(cachePath, cached ? FingerprintCache::DefaultMaxAgeSeconds : 0);
+
+        QFile file(licensePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            state.SkipWithError("could not open license file");
+            break;
+        }
+        QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+        std::string licenseFingerprint = obj["hardwareId"].toString().toStdString();
+        std::string signature = obj["signature"].toString().toStdString();
+
+        LicenseVerifier verifier;
+        if (local != licenseFingerprint || !verifier.loadPublicKey(f.rsaPublicKeyPath) ||
+            !verifier.verify(licenseFingerprint, signature, obj["alg"].toString().toStdString())) {
+            state.SkipWithError("license did not verify");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ClientStartup)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
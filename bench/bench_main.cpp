@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+
+#ifdef CRYPTOBENCH_WITH_QT
+#include <QCoreApplication>
+#endif
+
+/**
+ * @brief Benchmark entry point.
+ *
+ * Creates a QCoreApplication when the client benchmarks are built, since the
+ * hardware probes use QProcess and QtConcurrent, then runs the benchmarks
+ * selected on the command line. Use `--benchmark_out=<file>
+ * --benchmark_out_format=json` (or the `bench` target) for machine-readable
+ * results.
+ *
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return int Exit code
+ */
+int main(int argc, char **argv) {
+#ifdef CRYPTOBENCH_WITH_QT
+    QCoreApplication app(argc, argv);
+#endif
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "benchfixtures.h"
+#include "licensegenerator.h"
+#include "licensesigner.h"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <iostream>
+
+/**
+ * @brief Path of the license file written by the generator benchmarks.
+ * @return Output file inside the fixture directory.
+ */
+static std::string outputLicensePath() {
+    return (std::filesystem::path(BenchFixtures::instance().directory) / "generated.lic").string();
+}
+
+/**
+ * @brief Selects the private key for a benchmark argument.
+ * @param arg 0 for RSA-2048, 1 for Ed25519.
+ * @return Private key path.
+ */
+static const std::string &privateKeyFor(int64_t arg) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    return arg == 0 ? f.rsaPrivateKeyPath : f.ed25519PrivateKeyPath;
+}
+
+/**
+ * @brief generateLicense() as called by the CLI: key parsed on every call.
+ */
+static void BM_GenerateLicense_ReloadKey(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    const std::string &key = privateKeyFor(state.range(0));
+    const std::string output = outputLicensePath();
+    state.SetLabel(state.range(0) == 0 ? "RS256" : "EdDSA");
+
+    for (auto _ : state) {
+        // The path-based overload prints a line per license; keep it out of the timing noise
+        std::streambuf *saved = std::cout.rdbuf(nullptr);
+        bool ok = LicenseGenerator::generateLicense(f.hardwareId, key, output);
+        std::cout.rdbuf(saved);
+        if (!ok) {
+            state.SkipWithError("generateLicense failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateLicense_ReloadKey)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief generateLicense() with a resident signer, as used by the batch pipeline.
+ */
+static void BM_GenerateLicense_LoadedKey(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    const std::string output = outputLicensePath();
+    LicenseSigner signer;
+    if (!signer.loadPrivateKey(privateKeyFor(state.range(0)))) {
+        state.SkipWithError("could not load private key");
+        return;
+    }
+    state.SetLabel(signer.algorithm());
+
+    for (auto _ : state) {
+        if (!LicenseGenerator::generateLicense(f.hardwareId, signer, output, LicenseFormat::Json)) {
+            state.SkipWithError("generateLicense failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateLicense_LoadedKey)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Signing alone, without file output or JSON serialization.
+ */
+static void BM_SignRaw(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    LicenseSigner signer;
+    if (!signer.loadPrivateKey(privateKeyFor(state.range(0)))) {
+        state.SkipWithError("could not load private key");
+        return;
+    }
+    state.SetLabel(signer.algorithm());
+
+    std::string signature;
+    for (auto _ : state) {
+        signer.signRaw(f.hardwareId, signature);
+        benchmark::DoNotOptimize(signature.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SignRaw)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,96 @@
+#include "signaturedecoder.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Builds a random HEX-encoded signature.
+ * @param bytes Raw signature size.
+ * @return HEX string of 2 * @p bytes characters.
+ */
+static std::string randomHexSignature(std::size_t bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::mt19937 rng(42);
+    std::string hex;
+    for (std::size_t i = 0; i < bytes * 2; ++i)
+        hex += digits[rng() % 16];
+    return hex;
+}
+
+/**
+ * @brief Builds a random padded Base64-encoded signature.
+ * @param bytes Raw signature size.
+ * @return Base64 string.
+ */
+static std::string randomBase64Signature(std::size_t bytes) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::mt19937 rng(42);
+    std::vector<unsigned char> raw(bytes);
+    for (unsigned char &b : raw)
+        b = static_cast<unsigned char>(rng());
+
+    std::string out;
+    for (std::size_t i = 0; i < raw.size(); i += 3) {
+        unsigned value = raw[i] << 16;
+        if (i + 1 < raw.size()) value |= raw[i + 1] << 8;
+        if (i + 2 < raw.size()) value |= raw[i + 2];
+        out += alphabet[(value >> 18) & 0x3F];
+        out += alphabet[(value >> 12) & 0x3F];
+        out += i + 1 < raw.size() ? alphabet[(value >> 6) & 0x3F] : '=';
+        out += i + 2 < raw.size() ? alphabet[value & 0x3F] : '=';
+    }
+    return out;
+}
+
+/**
+ * @brief The HEX decoding used by verifyLicense before SignatureDecoder, kept as a baseline.
+ */
+static void BM_LegacyHexDecode(benchmark::State &state) {
+    std::string signature = randomHexSignature(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<unsigned char> decoded(signature.length() / 2);
+        for (size_t i = 0; i < signature.length(); i += 2) {
+            std::string byteString = signature.substr(i, 2);
+            decoded[i / 2] = (unsigned char)strtol(byteString.c_str(), nullptr, 16);
+        }
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    state.SetBytesProcessed(state.iterations() * signature.size());
+}
+BENCHMARK(BM_LegacyHexDecode)->Arg(64)->Arg(256)->Arg(384)->Arg(512);
+
+/**
+ * @brief Table-driven HEX decoding into a fixed buffer.
+ */
+static void BM_HexDecode(benchmark::State &state) {
+    std::string signature = randomHexSignature(static_cast<std::size_t>(state.range(0)));
+    SignatureDecoder::Buffer decoded;
+    std::size_t length = 0;
+    for (auto _ : state) {
+        bool ok = SignatureDecoder::decode(signature, decoded, length);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    state.SetBytesProcessed(state.iterations() * signature.size());
+}
+BENCHMARK(BM_HexDecode)->Arg(64)->Arg(256)->Arg(384)->Arg(512);
+
+/**
+ * @brief Table-driven Base64 decoding into a fixed buffer.
+ */
+static void BM_Base64Decode(benchmark::State &state) {
+    std::string signature = randomBase64Signature(static_cast<std::size_t>(state.range(0)));
+    SignatureDecoder::Buffer decoded;
+    std::size_t length = 0;
+    for (auto _ : state) {
+        bool ok = SignatureDecoder::decode(signature, decoded, length);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(decoded.data());
+    }
+    state.SetBytesProcessed(state.iterations() * signature.size());
+}
+BENCHMARK(BM_Base64Decode)->Arg(64)->Arg(256)->Arg(384)->Arg(512);
@@ -0,0 +1,114 @@
+#include "benchfixtures.h"
+#include "licenseparser.h"
+#include "licenseverifier.h"
+
+#include <binarylicense.h>
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <iterator>
+
+/**
+ * @brief Parsing the public key, as done once per client start.
+ */
+static void BM_LoadPublicKey(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    for (auto _ : state) {
+        LicenseVerifier verifier;
+        if (!verifier.loadPublicKey(f.rsaPublicKeyPath)) {
+            state.SkipWithError("could not load public key");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_LoadPublicKey)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Runs LicenseVerifier::verify() on a prepared signature.
+ * @param state Benchmark state.
+ * @param publicKeyPath Public key to load.
+ * @param signature Encoded signature.
+ */
+static void runVerify(benchmark::State &state, const std::string &publicKeyPath, const std::string &signature) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    LicenseVerifier verifier;
+    if (!verifier.loadPublicKey(publicKeyPath)) {
+        state.SkipWithError("could not load public key");
+        return;
+    }
+    state.SetLabel(verifier.algorithm());
+
+    for (auto _ : state) {
+        if (!verifier.verify(f.hardwareId, signature, verifier.algorithm())) {
+            state.SkipWithError("signature did not verify");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief RSA verification of a HEX signature.
+ */
+static void BM_Verify_Hex(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    runVerify(state, f.rsaPublicKeyPath, f.rsaSignatureHex);
+}
+BENCHMARK(BM_Verify_Hex)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief RSA verification of a Base64 signature.
+ */
+static void BM_Verify_Base64(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    runVerify(state, f.rsaPublicKeyPath, f.rsaSignatureBase64);
+}
+BENCHMARK(BM_Verify_Base64)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Ed25519 verification of a HEX signature.
+ */
+static void BM_Verify_Ed25519(benchmark::State &state) {
+    const BenchFixtures &f = BenchFixtures::instance();
+    runVerify(state, f.ed25519PublicKeyPath, f.ed25519SignatureHex);
+}
+BENCHMARK(BM_Verify_Ed25519)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief In-place parse of a binary license.
+ */
+static void BM_ParseBinaryLicense(benchmark::State &state) {
+    std::ifstream in(BenchFixtures::instance().binaryLicensePath, std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    for (auto _ : state) {
+        BinaryLicense::View view;
+        if (!BinaryLicense::parse(data.data(), data.size(), view)) {
+            state.SkipWithError("binary license did not parse");
+            break;
+        }
+        benchmark::DoNotOptimize(view);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_ParseBinaryLicense);
+
+/**
+ * @brief In-place parse of a JSON license, as done by the client's LicenseValidator.
+ */
+static void BM_ParseJsonLicense(benchmark::State &state) {
+    std::ifstream in(BenchFixtures::instance().jsonLicensePath, std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    for (auto _ : state) {
+        LicenseParser::View view;
+        if (!LicenseParser::parse(data.data(), data.size(), view) || !view.isComplete()) {
+            state.SkipWithError("JSON license did not parse");
+            break;
+        }
+        benchmark::DoNotOptimize(view);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_ParseJsonLicense);
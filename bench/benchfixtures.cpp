@@ -0,0 +1,113 @@
+#include "benchfixtures.h"
+
+#include "licensegenerator.h"
+#include "licensesigner.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+
+/**
+ * @brief Generates a key pair and writes it as PEM files.
+ * @param keyType EVP_PKEY_RSA or EVP_PKEY_ED25519.
+ * @param privatePath Output private key file.
+ * @param publicPath Output public key file.
+ */
+static void writeKeyPair(int keyType, const std::string &privatePath, const std::string &publicPath)
+{
+    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(keyType, nullptr);
+    EVP_PKEY *key = nullptr;
+    if (!ctx || EVP_PKEY_keygen_init(ctx) != 1 ||
+        (keyType == EVP_PKEY_RSA && EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, 2048) != 1) ||
+        EVP_PKEY_keygen(ctx, &key) != 1) {
+        EVP_PKEY_CTX_free(ctx);
+        throw std::runtime_error("key generation failed");
+    }
+    EVP_PKEY_CTX_free(ctx);
+
+    FILE *privateFile = fopen(privatePath.c_str(), "w");
+    FILE *publicFile = fopen(publicPath.c_str(), "w");
+    bool ok = privateFile && publicFile &&
+              PEM_write_PrivateKey(privateFile, key, nullptr, nullptr, 0, nullptr, nullptr) == 1 &&
+              PEM_write_PUBKEY(publicFile, key) == 1;
+    if (privateFile) fclose(privateFile);
+    if (publicFile) fclose(publicFile);
+    EVP_PKEY_free(key);
+    if (!ok)
+        throw std::runtime_error("could not write key pair");
+}
+
+/**
+ * @brief Base64-encodes raw bytes.
+ * @param raw Raw bytes.
+ * @return Padded Base64 text.
+ */
+static std::string toBase64(const std::string &raw)
+{
+    std::string out(4 * ((raw.size() + 2) / 3) + 1, '\0');
+    int length = EVP_EncodeBlock(reinterpret_cast<unsigned char *>(&out[0]),
+                                 reinterpret_cast<const unsigned char *>(raw.data()), static_cast<int>(raw.size()));
+    out.resize(static_cast<size_t>(length));
+    return out;
+}
+
+/**
+ * @brief Returns the process-wide fixtures, creating them on first use.
+ * @return Shared fixtures.
+ */
+const BenchFixtures &BenchFixtures::instance()
+{
+    static const BenchFixtures fixtures = [] {
+        BenchFixtures f;
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "cryptobench";
+        std::filesystem::create_directories(dir);
+        f.directory = dir.string();
+        f.hardwareId = "3f8a1c9e5b7d2f4a6c8e0b1d3f5a7c9e1b3d5f7a9c1e3b5d7f9a1c3e5b7d9f1a";
+
+        f.rsaPrivateKeyPath = (dir / "rsa_private.pem").string();
+        f.rsaPublicKeyPath = (dir / "rsa_public.pem").string();
+        f.ed25519PrivateKeyPath = (dir / "ed25519_private.pem").string();
+        f.ed25519PublicKeyPath = (dir / "ed25519_public.pem").string();
+        writeKeyPair(EVP_PKEY_RSA, f.rsaPrivateKeyPath, f.rsaPublicKeyPath);
+        writeKeyPair(EVP_PKEY_ED25519, f.ed25519PrivateKeyPath, f.ed25519PublicKeyPath);
+
+        LicenseSigner rsa;
+        LicenseSigner ed25519;
+        std::string rsaSignature;
+        std::string ed25519Signature;
+        if (!rsa.loadPrivateKey(f.rsaPrivateKeyPath) || !rsa.signRaw(f.hardwareId, rsaSignature) ||
+            !ed25519.loadPrivateKey(f.ed25519PrivateKeyPath) || !ed25519.signRaw(f.hardwareId, ed25519Signature))
+            throw std::runtime_error("could not sign fixtures");
+
+        f.rsaSignatureHex = LicenseSigner::toHex(rsaSignature);
+        f.rsaSignatureBase64 = toBase64(rsaSignature);
+        f.ed25519SignatureHex = LicenseSigner::toHex(ed25519Signature);
+
+        f.jsonLicensePath = (dir / "license.lic").string();
+        f.binaryLicensePath = (dir / "license.bin").string();
+        std::ofstream(f.jsonLicensePath, std::ios::binary)
+            << LicenseGenerator::buildLicense(f.hardwareId, rsaSignature, rsa.algorithm(), LicenseFormat::Json);
+        std::ofstream(f.binaryLicensePath, std::ios::binary)
+            << LicenseGenerator::buildLicense(f.hardwareId, rsaSignature, rsa.algorithm(), LicenseFormat::Binary);
+        return f;
+    }();
+    return fixtures;
+}
+
+/**
+ * @brief Signs a hardware ID and writes a JSON license for it.
+ * @param hardwareId Hardware ID to license.
+ * @param path Output license file.
+ * @return true if the license was written.
+ */
+bool BenchFixtures::writeRsaLicense(const std::string &hardwareId, const std::string &path) const
+{
+    LicenseSigner signer;
+    return signer.loadPrivateKey(rsaPrivateKeyPath) &&
+           LicenseGenerator::generateLicense(hardwareId, signer, path, LicenseFormat::Json);
+}
@@ -0,0 +1,42 @@
+#ifndef BENCHFIXTURES_H
+#define BENCHFIXTURES_H
+
+#include <string>
+
+/**
+ * @brief Keys and license files shared by all benchmarks.
+ *
+ * Created once per process in a temporary directory: an RSA-2048 and an
+ * Ed25519 key pair, signatures of a fixed hardware ID in HEX and Base64,
+ * and the corresponding JSON and binary license files.
+ */
+struct BenchFixtures
+{
+    std::string directory;              ///< Temporary working directory
+    std::string hardwareId;             ///< Hardware ID that was signed
+    std::string rsaPrivateKeyPath;      ///< RSA-2048 private key (PEM)
+    std::string rsaPublicKeyPath;       ///< RSA-2048 public key (PEM)
+    std::string ed25519PrivateKeyPath;  ///< Ed25519 private key (PEM)
+    std::string ed25519PublicKeyPath;   ///< Ed25519 public key (PEM)
+    std::string rsaSignatureHex;        ///< RSA signature of hardwareId, HEX
+    std::string rsaSignatureBase64;     ///< RSA signature of hardwareId, Base64
+    std::string ed25519SignatureHex;    ///< Ed25519 signature of hardwareId, HEX
+    std::string jsonLicensePath;        ///< RSA license in JSON format
+    std::string binaryLicensePath;      ///< RSA license in binary format
+
+    /**
+     * @brief Returns the process-wide fixtures, creating them on first use.
+     * @return Shared fixtures.
+     */
+    static const BenchFixtures &instance();
+
+    /**
+     * @brief Signs a hardware ID and writes a JSON license for it.
+     * @param hardwareId Hardware ID to license.
+     * @param path Output license file.
+     * @return true if the license was written.
+     */
+    bool writeRsaLicense(const std::string &hardwareId, const std::string &path) const;
+};
+
+#endif // BENCHFIXTURES_H
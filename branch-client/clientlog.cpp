@@ -0,0 +1,7 @@
+#include "clientlog.h"
+
+// Probe output is verbose (one line per network interface) and sensitive:
+// debug messages are only shown when enabled through QT_LOGGING_RULES.
+Q_LOGGING_CATEGORY(lcProbe, "cryptobranch.probe", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcLicense, "cryptobranch.license")
+Q_LOGGING_CATEGORY(lcStartup, "cryptobranch.startup")
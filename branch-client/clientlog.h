@@ -0,0 +1,20 @@
+#ifndef CLIENTLOG_H
+#define CLIENTLOG_H
+
+#include <QLoggingCategory>
+
+/**
+ * @brief Logging categories of CryptoBranch.
+ *
+ * Builds other than Debug define `QT_NO_DEBUG_OUTPUT` (see CMakeLists.txt),
+ * which turns every qCDebug() into dead code: its arguments are neither
+ * evaluated nor formatted, so release binaries pay nothing for diagnostics
+ * and never log fingerprint inputs. Info messages and warnings remain and
+ * can be filtered at runtime with `QT_LOGGING_RULES`, e.g.
+ * `QT_LOGGING_RULES="cryptobranch.probe.debug=true"` in a Debug build.
+ */
+Q_DECLARE_LOGGING_CATEGORY(lcProbe)   ///< Hardware probes and fingerprint inputs (debug off by default)
+Q_DECLARE_LOGGING_CATEGORY(lcLicense) ///< License verification, activation and revocation
+Q_DECLARE_LOGGING_CATEGORY(lcStartup) ///< Start-up sequence
+
+#endif // CLIENTLOG_H
@@ -0,0 +1,217 @@
+#include "fingerprintcache.h"
+#include "clientlog.h"
+#include "hardwarefingerprint.h"
+#include "hardwarelock.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMessageAuthenticationCode>
+#include <QSaveFile>
+#include <QSysInfo>
+
+/// Format version of the cache record (1 stored the fingerprint itself and is ignored).
+static const int CacheVersion = 2;
+
+/// Application-specific salt mixed into the HMAC key.
+static const char CacheKeySalt[] = "CryptoBranch/fingerprint-cache/v1";
+
+/**
+ * @brief Serializes the fields covered by the HMAC.
+ * @param disk Cached disk serial number.
+ * @param cpu Cached CPU ID.
+ * @param legacyMac Legacy adapter choice flag.
+ * @param machineId Machine ID the record is bound to.
+ * @param createdAt Creation time in seconds since epoch.
+ * @return Canonical byte string to authenticate.
+ */
+static QByteArray cachePayload(const QByteArray &disk, const QByteArray &cpu, bool legacyMac,
+                               const QByteArray &machineId, qint64 createdAt)
+{
+    return QByteArray::number(CacheVersion) + '|' + disk + '|' + cpu + '|' + (legacyMac ? '1' : '0') + '|' +
+           machineId + '|' + QByteArray::number(createdAt);
+}
+
+/**
+ * @brief Computes the HMAC that seals a cache record.
+ *
+ * The key is derived from the application salt and the machine ID, so a
+ * cache file copied to another machine does not validate there. Anyone on
+ * the machine can derive it as well; the cached values are never trusted
+ * on their own (see load()).
+ *
+ * @param payload Serialized record fields.
+ * @param machineId Machine ID the key is bound to.
+ * @return Hex-encoded HMAC-SHA256.
+ */
+QByteArray FingerprintCache::computeMac(const QByteArray &payload, const QByteArray &machineId)
+{
+    QByteArray key = QCryptographicHash::hash(QByteArray(CacheKeySalt) + machineId, QCryptographicHash::Sha256);
+    return QMessageAuthenticationCode::hash(payload, key, QCryptographicHash::Sha256).toHex();
+}
+
+/**
+ * @brief Reads the maximum cache age from `CRYPTOBRANCH_FINGERPRINT_MAX_AGE`.
+ *
+ * A value of 0 disables the cache so that every launch re-probes.
+ *
+ * @return Age in seconds, or DefaultMaxAgeSeconds if the variable is unset or invalid.
+ */
+qint64 FingerprintCache::maxAgeFromEnvironment()
+{
+    bool ok = false;
+    qint64 value = qEnvironmentVariable("CRYPTOBRANCH_FINGERPRINT_MAX_AGE").toLongLong(&ok);
+    return (ok && value >= 0) ? value : DefaultMaxAgeSeconds;
+}
+
+/**
+ * @brief Rebuilds the fingerprint from live probes and the cached slow probe results.
+ *
+ * The record is rejected if the file is missing or malformed, the HMAC does
+ * not match, the machine ID differs, or the record is older than
+ * @p maxAgeSeconds (or dated in the future).
+ *
+ * The MAC address is always read live, and the native disk and CPU queries
+ * (no subprocess) are re-run; a cached value is only used where the native
+ * query returns nothing, i.e. where a command line fallback would be needed.
+ * Records of a legacy fingerprint re-read the legacy disk source instead.
+ *
+ * @param cachePath Path of the cache file.
+ * @param maxAgeSeconds Maximum accepted cache age in seconds.
+ * @param fingerprint Receives the fingerprint of this machine on success.
+ * @return true if the cached values could be used.
+ */
+bool FingerprintCache::load(const QString &cachePath, qint64 maxAgeSeconds, std::string &fingerprint)
+{
+    QByteArray machineId = QSysInfo::machineUniqueId();
+    if (machineId.isEmpty() || maxAgeSeconds <= 0)
+        return false;
+
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    if (!doc.isObject())
+        return false;
+
+    QJsonObject obj = doc.object();
+    if (obj["version"].toInt() != CacheVersion)
+        return false;
+
+    QByteArray cachedDisk = obj["disk"].toString().toUtf8();
+    QByteArray cachedCpu = obj["cpu"].toString().toUtf8();
+    bool legacyMac = obj["legacyMac"].toBool();
+    QByteArray cachedMachineId = obj["machineId"].toString().toUtf8();
+    qint64 createdAt = static_cast<qint64>(obj["createdAt"].toDouble());
+    QByteArray mac = obj["mac"].toString().toUtf8();
+
+    if (cachedDisk.isEmpty() || cachedCpu.isEmpty() || cachedMachineId != machineId)
+        return false;
+
+    QByteArray expected = computeMac(cachePayload(cachedDisk, cachedCpu, legacyMac, cachedMachineId, createdAt), machineId);
+    if (mac != expected) {
+        qCWarning(lcProbe) << "Fingerprint cache failed integrity check, re-probing hardware";
+        return false;
+    }
+
+    qint64 now = QDateTime::currentSecsSinceEpoch();
+    if (createdAt > now || now - createdAt > maxAgeSeconds)
+        return false;
+
+    // Live values win; the cache only replaces the slow command line fallbacks
+    std::string disk = legacyMac ? HardwareFingerprint::legacyDiskSerialNumber() : HardwareFingerprint::diskSerialNumber();
+    if (disk.empty())
+        disk = cachedDisk.toStdString();
+    std::string cpu = HardwareFingerprint::cpuId();
+    if (cpu.empty())
+        cpu = cachedCpu.toStdString();
+    std::string macAddress = legacyMac ? HardwareLock::getLegacyMacAddress() : HardwareLock::getMacAddress();
+
+    fingerprint = HardwareFingerprint::combine(macAddress, disk, cpu);
+    return true;
+}
+
+/**
+ * @brief Writes probe results to the cache.
+ *
+ * The file is replaced atomically so that an interrupted write never leaves
+ * a truncated record behind.
+ *
+ * @param cachePath Path of the cache file.
+ * @param probes Probe results of this machine.
+ * @return true if the cache file was written.
+ */
+bool FingerprintCache::store(const QString &cachePath, const Probes &probes)
+{
+    QByteArray machineId = QSysInfo::machineUniqueId();
+    if (machineId.isEmpty() || probes.disk.empty() || probes.cpu.empty())
+        return false;
+
+    QByteArray disk = QByteArray::fromStdString(probes.disk);
+    QByteArray cpu = QByteArray::fromStdString(probes.cpu);
+    qint64 createdAt = QDateTime::currentSecsSinceEpoch();
+
+    QJsonObject obj;
+    obj["version"] = CacheVersion;
+    obj["disk"] = QString::fromUtf8(disk);
+    obj["cpu"] = QString::fromUtf8(cpu);
+    obj["legacyMac"] = probes.legacyMac;
+    obj["machineId"] = QString::fromLatin1(machineId);
+    obj["createdAt"] = static_cast<double>(createdAt);
+    obj["mac"] = QString::fromLatin1(computeMac(cachePayload(disk, cpu, probes.legacyMac, machineId, createdAt), machineId));
+
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+/**
+ * @brief Probes the hardware and rewrites the cache unconditionally.
+ * @param cachePath Path of the cache file.
+ * @param legacyMac Use the legacy adapter and disk choice (HardwareLock::getLegacyHardwareFingerprint()).
+ * @return Freshly probed hardware fingerprint.
+ */
+std::string FingerprintCache::refresh(const QString &cachePath, bool legacyMac)
+{
+    std::string mac;
+    Probes probes;
+    probes.legacyMac = legacyMac;
+    HardwareLock::probeComponents(mac, probes.disk, probes.cpu);
+    if (legacyMac) {
+        mac = HardwareLock::getLegacyMacAddress();
+        probes.disk = HardwareLock::getLegacyDiskSerialNumber();
+    }
+
+    if (!store(cachePath, probes))
+        qCWarning(lcProbe) << "Could not write fingerprint cache:" << cachePath;
+    return HardwareFingerprint::combine(mac, probes.disk, probes.cpu);
+}
+
+/**
+ * @brief Returns the hardware fingerprint, using cached probe results when possible.
+ *
+ * @param cachePath Path of the cache file.
+ * @param maxAgeSeconds Maximum cache age; 0 disables the cache.
+ * @param fromCache Optional; set to true if the value came from the cache.
+ * @return Hexadecimal SHA256 hardware fingerprint.
+ */
+std::string FingerprintCache::getFingerprint(const QString &cachePath, qint64 maxAgeSeconds, bool *fromCache)
+{
+    std::string fingerprint;
+    bool cached = load(cachePath, maxAgeSeconds, fingerprint);
+    if (fromCache)
+        *fromCache = cached;
+    if (cached)
+        return fingerprint;
+
+    if (maxAgeSeconds <= 0)
+        return HardwareLock::getHardwareFingerprint();
+    return refresh(cachePath);
+}
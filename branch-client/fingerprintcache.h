@@ -0,0 +1,93 @@
+#ifndef FINGERPRINTCACHE_H
+#define FINGERPRINTCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <string>
+
+/**
+ * @brief Persisted cache of the slow hardware probe results.
+ *
+ * When a native query fails, probing the hardware spawns external commands,
+ * each of which may block for seconds. The cache keeps the disk serial and
+ * CPU ID that those probes returned, but never the fingerprint itself: on
+ * every launch the fingerprint is rebuilt from the live MAC address and the
+ * cheap native disk and CPU queries, and a cached value only stands in for a
+ * native query that fails on this machine. A forged cache therefore cannot
+ * make a copied license match; it would have to contain the raw identifiers
+ * of the licensed machine, which the license does not reveal.
+ *
+ * Records carry the OS machine ID and a creation time and are sealed with an
+ * HMAC-SHA256 keyed by the machine ID. The key is not secret; the seal only
+ * makes edited, copied or truncated files fall back to a fresh probe.
+ */
+class FingerprintCache {
+public:
+    /// Default time after which the fingerprint is re-probed (7 days).
+    static constexpr qint64 DefaultMaxAgeSeconds = 7 * 24 * 60 * 60;
+
+    /**
+     * @brief Slow probe results kept between launches.
+     */
+    struct Probes {
+        std::string disk;       ///< Disk serial number
+        std::string cpu;        ///< CPU ID
+        bool legacyMac = false; ///< Fingerprint uses the legacy MAC and disk probes (HardwareLock::getLegacyHardwareFingerprint())
+    };
+
+    /**
+     * @brief Returns the hardware fingerprint, using cached probe results when possible.
+     *
+     * Falls back to HardwareLock::getHardwareFingerprint() and refreshes the
+     * cache when it is missing, invalid or expired.
+     *
+     * @param cachePath Path of the cache file.
+     * @param maxAgeSeconds Maximum cache age; 0 disables the cache.
+     * @param fromCache Optional; set to true if the value came from the cache.
+     * @return Hexadecimal SHA256 hardware fingerprint.
+     */
+    static std::string getFingerprint(const QString &cachePath, qint64 maxAgeSeconds, bool *fromCache = nullptr);
+
+    /**
+     * @brief Probes the hardware and rewrites the cache unconditionally.
+     * @param cachePath Path of the cache file.
+     * @param legacyMac Use the legacy adapter and disk choice (HardwareLock::getLegacyHardwareFingerprint()).
+     * @return Freshly probed hardware fingerprint.
+     */
+    static std::string refresh(const QString &cachePath, bool legacyMac = false);
+
+    /**
+     * @brief Rebuilds the fingerprint from live probes and the cached slow probe results.
+     * @param cachePath Path of the cache file.
+     * @param maxAgeSeconds Maximum accepted cache age in seconds.
+     * @param fingerprint Receives the fingerprint of this machine on success.
+     * @return true if the cache exists, is intact, belongs to this machine and is not expired.
+     */
+    static bool load(const QString &cachePath, qint64 maxAgeSeconds, std::string &fingerprint);
+
+    /**
+     * @brief Writes probe results to the cache.
+     * @param cachePath Path of the cache file.
+     * @param probes Probe results of this machine.
+     * @return true if the cache file was written.
+     */
+    static bool store(const QString &cachePath, const Probes &probes);
+
+    /**
+     * @brief Reads the maximum cache age from `CRYPTOBRANCH_FINGERPRINT_MAX_AGE`.
+     * @return Age in seconds, or DefaultMaxAgeSeconds if the variable is unset or invalid.
+     */
+    static qint64 maxAgeFromEnvironment();
+
+private:
+    /**
+     * @brief Computes the HMAC that seals a cache record.
+     * @param payload Serialized record fields.
+     * @param machineId Machine ID the key is bound to.
+     * @return Hex-encoded HMAC-SHA256.
+     */
+    static QByteArray computeMac(const QByteArray &payload, const QByteArray &machineId);
+};
+
+#endif // FINGERPRINTCACHE_H
@@ -1,42 +1,56 @@
 #include "hardwarelock.h"
+#include "clientlog.h"
+#include "hardwarefingerprint.h"
+#include "licenseverifier.h"
+#include "probescheduler.h"
+#include "startuptrace.h"
 #include <QNetworkInterface>
-#include <QCryptographicHash>
 #include <QProcess>
-#include <QStandardPaths>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <memory>
 #include <sstream>
-#include <iomanip>
-
-#include <openssl/pem.h>
-#include <openssl/evp.h>
-#include <openssl/bio.h>
-#include <openssl/buffer.h>
-#include <openssl/err.h>
 
 #ifdef _WIN32
 #include <windows.h>
-#include <intrin.h>
-#elif defined(__linux__)
-#include <fstream>
+#else
+#include <signal.h>
+#include <sys/types.h>
 #include <unistd.h>
-#elif defined(__APPLE__)
-#include <sys/sysctl.h>
 #endif
 
 /**
- * @brief Retrieves the MAC address of the primary active network interface.
+ * @brief Retrieves the MAC address of the primary network adapter.
  *
- * Iterates through all available network interfaces, skipping loopback and empty addresses.
+ * Reads the adapters directly from the OS and picks the highest ranked one
+ * (physical, burned-in, wired; see InterfaceSelector). Falls back to the
+ * QNetworkInterface walk on platforms without native enumeration.
  *
  * @return MAC address string in the format "XX:XX:XX:XX:XX:XX".
  */
 std::string HardwareLock::getMacAddress() {
+    StartupTrace::Scope trace("probe.mac");
+    std::string mac = HardwareFingerprint::macAddress();
+    if (!mac.empty())
+        return mac;
+    return getLegacyMacAddress();
+}
+
+/**
+ * @brief Retrieves the MAC address of the first non-loopback interface Qt enumerates.
+ *
+ * Iterates through all available network interfaces, skipping loopback and empty addresses.
+ *
+ * @return MAC address string in the format "XX:XX:XX:XX:XX:XX".
+ */
+std::string HardwareLock::getLegacyMacAddress() {
     foreach (const QNetworkInterface &netInterface, QNetworkInterface::allInterfaces()) {
-        qDebug() << "Interface Name:" << netInterface.humanReadableName();
-        qDebug() << "Hardware Address:" << netInterface.hardwareAddress();
-        qDebug() << "Type:" << netInterface.type();
-        qDebug() << "IsUp:" << netInterface.flags().testFlag(QNetworkInterface::IsUp);
-        qDebug() << "IsRunning:" << netInterface.flags().testFlag(QNetworkInterface::IsRunning);
-        qDebug() << "------";
+        qCDebug(lcProbe) << "Interface" << netInterface.humanReadableName() << netInterface.hardwareAddress()
+                         << "type" << netInterface.type()
+                         << "up" << netInterface.flags().testFlag(QNetworkInterface::IsUp)
+                         << "running" << netInterface.flags().testFlag(QNetworkInterface::IsRunning);
 
         if (!(netInterface.flags() & QNetworkInterface::IsLoopBack) &&
             netInterface.hardwareAddress() != "00:00:00:00:00:00" &&
@@ -47,174 +61,431 @@ std::string HardwareLock::getMacAddress() {
     return "00:00:00:00:00:00";
 }
 
+/**
+ * @brief Returns the thread pool used for hardware probes.
+ *
+ * A dedicated pool keeps blocking probes off the global pool and leaves
+ * enough threads for every source of every fallback chain to run at once.
+ *
+ * @return Pointer to the shared probe pool.
+ */
+static QThreadPool *probePool() {
+    static QThreadPool *pool = [] {
+        QThreadPool *p = new QThreadPool;
+        p->setMaxThreadCount(16);
+        return p;
+    }();
+    return pool;
+}
+
+/**
+ * @brief A started command together with every process it spawns.
+ *
+ * Commands run through the shell and may be pipelines, so killing only the
+ * shell would leave `wmic`, `lsblk` and friends running. On Windows the
+ * processes are collected in a job object; on Unix (Qt 6) the shell starts
+ * a new process group. kill() terminates the whole tree and reaps the shell.
+ */
+class ProcessTree {
+public:
+    /**
+     * @brief Prepares @p process so its children can be tracked.
+     * @param process Process that has not been started yet.
+     */
+    explicit ProcessTree(QProcess &process) : m_process(process) {
+#ifdef _WIN32
+        m_job = CreateJobObjectW(nullptr, nullptr);
+        if (m_job) {
+            JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+            limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+            SetInformationJobObject(m_job, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+        }
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        process.setChildProcessModifier([] { ::setpgid(0, 0); });
+#endif
+    }
+
+    /**
+     * @brief Kills what is left of the tree (Windows: by closing the job).
+     */
+    ~ProcessTree() {
+#ifdef _WIN32
+        if (m_job)
+            CloseHandle(m_job);
+#endif
+    }
+
+    ProcessTree(const ProcessTree &) = delete;
+    ProcessTree &operator=(const ProcessTree &) = delete;
+
+    /**
+     * @brief Adds the started process to the tree.
+     *
+     * On Windows, children the shell spawns before this call escape the job;
+     * the shell is still starting up at that point, so this is unlikely.
+     */
+    void attach() {
+#ifdef _WIN32
+        if (!m_job)
+            return;
+        HANDLE handle = OpenProcess(PROCESS_SET_QUOTA | PROCESS_TERMINATE, FALSE,
+                                    static_cast<DWORD>(m_process.processId()));
+        if (handle) {
+            AssignProcessToJobObject(m_job, handle);
+            CloseHandle(handle);
+        }
+#endif
+    }
+
+    /**
+     * @brief Kills the shell and all processes it started, then reaps the shell.
+     */
+    void kill() {
+#ifdef _WIN32
+        if (m_job)
+            TerminateJobObject(m_job, 1);
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        if (m_process.processId() > 0)
+            ::kill(-static_cast<pid_t>(m_process.processId()), SIGKILL);
+#endif
+        m_process.kill();
+        m_process.waitForFinished(1000);
+    }
+
+private:
+    QProcess &m_process; ///< Shell process
+#ifdef _WIN32
+    HANDLE m_job = nullptr; ///< Job object holding the shell and its children
+#endif
+};
+
 /**
  * @brief Executes a shell/system command and returns its output.
  *
+ * The command runs through the platform shell (`/bin/sh -c`, `cmd /c`), so
+ * pipelines and shell built-ins such as `vol` work. It must finish within
+ * the time left in the active ProbeScheduler::Budget; the process is polled
+ * so that it can be killed, together with its children, as soon as @p cancel
+ * is raised or the deadline passes. Commands that keep hanging and never
+ * answer are skipped on later launches (see ProbeScheduler).
+ *
  * @param command Command string to execute.
+ * @param cancel Optional flag; the process is killed as soon as it is set.
  * @return Command output as std::string.
  */
-std::string HardwareLock::executeCommand(const std::string &command) {
+std::string HardwareLock::executeCommand(const std::string &command, const std::atomic_bool *cancel) {
+    StartupTrace::Scope trace("executeCommand", command.c_str());
+    const qint64 timeoutMs = ProbeScheduler::remainingMs();
+    if (timeoutMs <= 0 || ProbeScheduler::isKnownBad(command))
+        return "";
+
     QProcess process;
-    process.start(QString::fromStdString(command));
-    process.waitForFinished(5000); // 5 seconds timeout
+    ProcessTree tree(process);
+#ifdef _WIN32
+    process.start("cmd", QStringList() << "/c" << QString::fromStdString(command));
+#else
+    process.start("/bin/sh", QStringList() << "-c" << QString::fromStdString(command));
+#endif
+    if (!process.waitForStarted(static_cast<int>(timeoutMs)))
+        return "";
+    tree.attach();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!process.waitForFinished(50)) {
+        if (process.state() == QProcess::NotRunning)
+            return "";
+        if (cancel && cancel->load()) {
+            tree.kill();
+            return "";
+        }
+        if (timer.hasExpired(timeoutMs)) {
+            tree.kill();
+            // Running into the shared deadline is not the command's fault; only its own run time counts
+            if (timer.elapsed() >= ProbeScheduler::CommandLimitMs)
+                ProbeScheduler::recordTimeout(command);
+            StartupTrace::instant("probe.timeout");
+            return "";
+        }
+    }
 
-    if (process.exitCode() == 0) {
-        QByteArray output = process.readAllStandardOutput();
-        return output.trimmed().toStdString();
+    if (process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0) {
+        std::string output = process.readAllStandardOutput().trimmed().toStdString();
+        if (!output.empty())
+            ProbeScheduler::recordAnswer(command);
+        return output;
     }
 
     return "";
 }
 
+/**
+ * @brief Runs all sources of a fallback chain concurrently.
+ *
+ * Every source is started at once on the probe pool. Results are then taken in
+ * priority order: the chain returns as soon as the highest-priority source that
+ * is still a candidate answers, and the remaining sources are cancelled. The
+ * result is therefore identical to the serial chain while the latency is
+ * bounded by the slowest single source.
+ *
+ * @param sources Sources in descending priority.
+ * @return Answer of the highest-priority successful source, or an empty string.
+ */
+std::string HardwareLock::runFallbackChain(const std::vector<ProbeSource> &sources) {
+    std::shared_ptr<std::atomic_bool> cancel = std::make_shared<std::atomic_bool>(false);
+
+    std::vector<QFuture<std::string>> futures;
+    futures.reserve(sources.size());
+    for (const ProbeSource &source : sources) {
+        futures.push_back(QtConcurrent::run(probePool(), [source, cancel]() {
+            return cancel->load() ? std::string() : source(*cancel);
+        }));
+    }
+
+    std::string result;
+    for (QFuture<std::string> &future : futures) {
+        future.waitForFinished();
+        result = future.result();
+        if (!result.empty())
+            break;
+    }
+
+    // Stop lower-priority sources that are still running
+    cancel->store(true);
+    return result;
+}
+
 /**
  * @brief Retrieves the serial number of the main system disk.
  *
- * Uses platform-specific commands to obtain the disk serial number:
+ * Tries the native OS queries (HardwareFingerprint) first. Only if they fail, falls
+ * back to platform-specific commands:
  * - Windows: `wmic` or `vol C:`
- * - Linux: `lsblk`, `udevadm`, or `/sys/block/...`
+ * - Linux: `lsblk` or `udevadm`
  * - macOS: `system_profiler` or `diskutil`
  *
  * @return Disk serial number or "UNKNOWN_DISK" if not found.
  */
 std::string HardwareLock::getDiskSerialNumber() {
-    std::string serialNumber;
+    StartupTrace::Scope trace("probe.disk");
+    std::string serialNumber = HardwareFingerprint::diskSerialNumber();
+
+    // Last resort: command line tools
+    std::vector<ProbeSource> sources;
 
 #ifdef _WIN32
     // Try using WMIC
-    std::string output = executeCommand("wmic diskdrive get serialnumber");
-    if (!output.empty()) {
-        std::istringstream iss(output);
-        std::string line;
-        std::getline(iss, line); // Skip header
-        while (std::getline(iss, line)) {
-            if (!line.empty()) {
-                serialNumber = line;
-                break;
+    sources.push_back([](const std::atomic_bool &cancel) {
+        std::string serial;
+        std::string output = executeCommand("wmic diskdrive get serialnumber", &cancel);
+        if (!output.empty()) {
+            std::istringstream iss(output);
+            std::string line;
+            std::getline(iss, line); // Skip header
+            while (std::getline(iss, line)) {
+                if (!line.empty()) {
+                    serial = line;
+                    break;
+                }
             }
         }
-    }
+        return serial;
+    });
     // Fallback: "vol C:"
-    if (serialNumber.empty()) {
-        output = executeCommand("vol C:");
+    sources.push_back([](const std::atomic_bool &cancel) {
+        std::string output = executeCommand("vol C:", &cancel);
         size_t pos = output.find("Volume Serial Number is ");
         if (pos != std::string::npos) {
             pos += 24;
-            serialNumber = output.substr(pos, 9);
+            return output.substr(pos, 9);
         }
-    }
+        return std::string();
+    });
 
 #elif defined(__linux__)
-    serialNumber = executeCommand("lsblk -d -n -o serial | head -1");
-    if (serialNumber.empty()) {
-        serialNumber = executeCommand("udevadm info --query=property --name=sda | grep ID_SERIAL= | cut -d'=' -f2");
-    }
-    if (serialNumber.empty()) {
-        std::ifstream file("/sys/block/sda/device/serial");
-        if (file.is_open()) {
-            std::getline(file, serialNumber);
-            file.close();
-        }
-    }
+    sources.push_back([](const std::atomic_bool &cancel) {
+        return executeCommand("lsblk -d -n -o serial | head -1", &cancel);
+    });
+    sources.push_back([](const std::atomic_bool &cancel) {
+        return executeCommand("udevadm info --query=property --name=sda | grep ID_SERIAL= | cut -d'=' -f2", &cancel);
+    });
 
 #elif defined(__APPLE__)
-    serialNumber = executeCommand("system_profiler SPSerialATADataType | grep 'Serial Number' | head -1 | awk '{print $3}'");
-    if (serialNumber.empty()) {
-        serialNumber = executeCommand("diskutil info disk0 | grep 'Device / Media UUID' | awk '{print $5}'");
-    }
+    sources.push_back([](const std::atomic_bool &cancel) {
+        return executeCommand("system_profiler SPSerialATADataType | grep 'Serial Number' | head -1 | awk '{print $3}'", &cancel);
+    });
+    sources.push_back([](const std::atomic_bool &cancel) {
+        return executeCommand("diskutil info disk0 | grep 'Device / Media UUID' | awk '{print $5}'", &cancel);
+    });
 #endif
 
-    // Clean spaces and special characters
-    serialNumber.erase(std::remove_if(serialNumber.begin(), serialNumber.end(),
-                                      [](char c) { return std::isspace(c) || c == '\r' || c == '\n'; }), serialNumber.end());
+    if (serialNumber.empty())
+        serialNumber = HardwareFingerprint::normalize(runFallbackChain(sources));
 
     return serialNumber.empty() ? "UNKNOWN_DISK" : serialNumber;
 }
 
+#if defined(_WIN32) || defined(__APPLE__)
 /**
- * @brief Retrieves the CPU identifier.
+ * @brief Runs a command the way clients before shell execution did.
  *
- * Uses platform-specific methods:
- * - Windows: CPUID instruction
- * - Linux: /proc/cpuinfo
- * - macOS: sysctl or system_profiler
+ * Those clients passed the whole command line to `QProcess::start()`. Qt 5
+ * split it into program and arguments without a shell, so pipelines and
+ * shell built-ins failed; Qt 6 took the whole line as the program name, so
+ * every command failed.
  *
- * @return CPU identifier string or "UNKNOWN_CPU" if not found.
+ * @param command Command line.
+ * @return Trimmed standard output if the command exited with code 0, otherwise an empty string.
  */
-std::string HardwareLock::getCpuId() {
-    std::string cpuId;
+static std::string runUnquotedCommand(const std::string &command) {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QStringList arguments = QProcess::splitCommand(QString::fromStdString(command));
+    if (arguments.isEmpty())
+        return "";
+    QProcess process;
+    process.start(arguments.takeFirst(), arguments);
+    process.waitForFinished(5000);
+    if (process.exitCode() == 0)
+        return process.readAllStandardOutput().trimmed().toStdString();
+#else
+    Q_UNUSED(command);
+#endif
+    return "";
+}
+#endif
 
+/**
+ * @brief Retrieves the disk serial number the way clients before native probing did.
+ *
+ * Licenses issued to those clients are bound to this value, which differs
+ * from getDiskSerialNumber() on most machines. Only the sources that could
+ * succeed without a shell are repeated:
+ * - Windows: `wmic diskdrive get serialnumber` (Qt 5 only)
+ * - Linux: `/sys/block/sda/device/serial` (see HardwareFingerprint::legacyDiskSerialNumber())
+ * - macOS: `system_profiler` and `diskutil` as split by Qt 5
+ *
+ * @return Disk serial number or "UNKNOWN_DISK" if not found.
+ */
+std::string HardwareLock::getLegacyDiskSerialNumber() {
+    StartupTrace::Scope trace("probe.disk.legacy");
+    std::string serialNumber;
 #ifdef _WIN32
-    int cpuInfo[4] = {0};
-    __cpuid(cpuInfo, 0);
-    char vendor[13] = {0};
-    *reinterpret_cast<int*>(vendor) = cpuInfo[1];
-    *reinterpret_cast<int*>(vendor + 4) = cpuInfo[3];
-    *reinterpret_cast<int*>(vendor + 8) = cpuInfo[2];
-    __cpuid(cpuInfo, 1);
-    std::ostringstream oss;
-    oss << vendor << "_" << std::hex << cpuInfo[0];
-    cpuId = oss.str();
-
-#elif defined(__linux__)
-    std::ifstream file("/proc/cpuinfo");
-    if (file.is_open()) {
+    std::string output = runUnquotedCommand("wmic diskdrive get serialnumber");
+    if (!output.empty()) {
+        std::istringstream iss(output);
         std::string line;
-        while (std::getline(file, line)) {
-            if (line.find("processor") == 0) {
-                size_t pos = line.find(":");
-                if (pos != std::string::npos) {
-                    cpuId = line.substr(pos + 1);
-                    break;
-                }
+        std::getline(iss, line); // Skip header
+        while (std::getline(iss, line)) {
+            if (!line.empty()) {
+                serialNumber = line;
+                break;
             }
         }
-        file.close();
     }
-    if (cpuId.empty()) {
-        cpuId = executeCommand("cat /proc/cpuinfo | grep 'model name' | head -1 | cut -d':' -f2");
-    }
-
+#elif defined(__linux__)
+    serialNumber = HardwareFingerprint::legacyDiskSerialNumber();
 #elif defined(__APPLE__)
-    cpuId = executeCommand("sysctl -n machdep.cpu.brand_string");
+    serialNumber = runUnquotedCommand("system_profiler SPSerialATADataType | grep 'Serial Number' | head -1 | awk '{print $3}'");
+    if (serialNumber.empty())
+        serialNumber = runUnquotedCommand("diskutil info disk0 | grep 'Device / Media UUID' | awk '{print $5}'");
+#endif
+    serialNumber = HardwareFingerprint::normalize(serialNumber);
+    return serialNumber.empty() ? "UNKNOWN_DISK" : serialNumber;
+}
+
+/**
+ * @brief Retrieves the CPU identifier.
+ *
+ * Uses platform-specific methods (see HardwareFingerprint::cpuId()):
+ * - Windows: CPUID instruction
+ * - Linux: /proc/cpuinfo (read directly, no subprocess)
+ * - macOS: sysctlbyname, or system_profiler as a last resort
+ *
+ * @return CPU identifier string or "UNKNOWN_CPU" if not found.
+ */
+std::string HardwareLock::getCpuId() {
+    StartupTrace::Scope trace("probe.cpu");
+    std::string cpuId = HardwareFingerprint::cpuId();
+
+#ifdef __APPLE__
     if (cpuId.empty()) {
-        cpuId = executeCommand("system_profiler SPHardwareDataType | grep 'Processor Name' | cut -d':' -f2");
+        // Last resort: command line tool
+        std::vector<ProbeSource> sources;
+        sources.push_back([](const std::atomic_bool &cancel) {
+            return executeCommand("system_profiler SPHardwareDataType | grep 'Processor Name' | cut -d':' -f2", &cancel);
+        });
+        cpuId = HardwareFingerprint::normalize(runFallbackChain(sources));
     }
 #endif
 
-    cpuId.erase(std::remove_if(cpuId.begin(), cpuId.end(),
-                               [](char c) { return std::isspace(c) || c == '\r' || c == '\n'; }), cpuId.end());
-
     return cpuId.empty() ? "UNKNOWN_CPU" : cpuId;
 }
 
 /**
  * @brief Generates a SHA256 hardware fingerprint based on MAC, disk serial, and CPU ID.
  *
+ * The three probes run concurrently, so the total latency is bounded by the
+ * slowest probe instead of their sum.
+ *
  * @return Hexadecimal string of the SHA256 hash.
  */
 std::string HardwareLock::getHardwareFingerprint() {
-    std::string mac = getMacAddress();
-    std::string disk = getDiskSerialNumber();
-    std::string cpu = getCpuId();
+    StartupTrace::Scope trace("fingerprint.probe");
+    std::string mac, disk, cpu;
+    probeComponents(mac, disk, cpu);
 
-    qDebug() << "MAC Address:" << QString::fromStdString(mac);
-    qDebug() << "Disk Serial:" << QString::fromStdString(disk);
-    qDebug() << "CPU ID:" << QString::fromStdString(cpu);
+    qCDebug(lcProbe) << "MAC Address:" << QString::fromStdString(mac);
+    qCDebug(lcProbe) << "Disk Serial:" << QString::fromStdString(disk);
+    qCDebug(lcProbe) << "CPU ID:" << QString::fromStdString(cpu);
 
-    std::string combined = mac + "|" + disk + "|" + cpu;
+    return HardwareFingerprint::combine(mac, disk, cpu);
+}
 
-    QByteArray hash = QCryptographicHash::hash(QByteArray::fromStdString(combined), QCryptographicHash::Sha256);
-    std::ostringstream oss;
-    for (unsigned char byte : hash)
-        oss << std::hex << std::setw(2) << std::setfill('0') << (int)byte;
+/**
+ * @brief Hashes the fingerprint inputs individually.
+ * @param fingerprint Fingerprint the license is (to be) issued for; keys the hashes.
+ * @return Component hashes (see HardwareFingerprint::componentHashes()).
+ */
+LicenseClaims::ComponentHashes HardwareLock::getComponentHashes(const std::string &fingerprint) {
+    StartupTrace::Scope trace("fingerprint.components");
+    std::string mac, disk, cpu;
+    probeComponents(mac, disk, cpu);
+    return HardwareFingerprint::componentHashes(mac, disk, cpu, fingerprint);
+}
 
-    return oss.str();
+/**
+ * @brief Probes the fingerprint inputs concurrently under one probe budget.
+ * @param mac Receives the MAC address.
+ * @param disk Receives the disk serial number.
+ * @param cpu Receives the CPU ID.
+ */
+void HardwareLock::probeComponents(std::string &mac, std::string &disk, std::string &cpu) {
+    ProbeScheduler::Budget budget;
+    QFuture<std::string> macFuture = QtConcurrent::run(probePool(), &HardwareLock::getMacAddress);
+    QFuture<std::string> diskFuture = QtConcurrent::run(probePool(), &HardwareLock::getDiskSerialNumber);
+    cpu = getCpuId();
+    mac = macFuture.result();
+    disk = diskFuture.result();
+}
+
+/**
+ * @brief Generates the hardware fingerprint the way clients before native probing did.
+ * @return Fingerprint based on getLegacyMacAddress() and getLegacyDiskSerialNumber().
+ */
+std::string HardwareLock::getLegacyHardwareFingerprint() {
+    StartupTrace::Scope trace("fingerprint.legacy");
+    ProbeScheduler::Budget budget;
+    QFuture<std::string> diskFuture = QtConcurrent::run(probePool(), &HardwareLock::getLegacyDiskSerialNumber);
+    std::string cpu = getCpuId();
+    std::string mac = getLegacyMacAddress();
+    return HardwareFingerprint::combine(mac, diskFuture.result(), cpu);
 }
 
 /**
  * @brief Verifies a license using the provided hardware hash, digital signature, and public key.
  *
- * Supports both HEX and Base64-encoded signatures.
+ * Supports both HEX and Base64-encoded signatures. The public key is parsed
+ * on every call; use LicenseVerifier directly to verify repeatedly.
  *
  * @param hash Hardware fingerprint hash.
  * @param signatureBase64 Digital signature (HEX or Base64 encoded).
@@ -222,81 +493,14 @@ std::string HardwareLock::getHardwareFingerprint() {
  * @return true if license is valid, false otherwise.
  */
 bool HardwareLock::verifyLicense(const std::string &hash, const std::string &signatureBase64, const std::string &publicKeyPath) {
-    qDebug() << "=== Signature Verification Started ===";
-    qDebug() << "Hash length:" << hash.length();
-    qDebug() << "Signature length:" << signatureBase64.length();
-    qDebug() << "Public key file:" << QString::fromStdString(publicKeyPath);
-
-    bool isHex = true;
-    for (char c : signatureBase64) {
-        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-            isHex = false;
-            break;
-        }
-    }
+    StartupTrace::Scope trace("verifyLicense");
+    qCDebug(lcLicense) << "Verifying signature: hash length" << hash.length()
+                       << "signature length" << signatureBase64.length()
+                       << "public key" << QString::fromStdString(publicKeyPath);
 
-    qDebug() << "Signature format:" << (isHex ? "HEX" : "BASE64");
-
-    std::vector<unsigned char> signature;
-    if (isHex && signatureBase64.length() == 512) {
-        signature.resize(256);
-        for (size_t i = 0; i < signatureBase64.length(); i += 2) {
-            std::string byteString = signatureBase64.substr(i, 2);
-            signature[i / 2] = (unsigned char)strtol(byteString.c_str(), nullptr, 16);
-        }
-    } else {
-        BIO *bio = nullptr;
-        BIO *b64 = nullptr;
-        try {
-            b64 = BIO_new(BIO_f_base64());
-            if (!b64) return false;
-
-            bio = BIO_new_mem_buf(signatureBase64.c_str(), signatureBase64.length());
-            if (!bio) {
-                BIO_free(b64);
-                return false;
-            }
-            bio = BIO_push(b64, bio);
-            BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-
-            std::vector<unsigned char> tempSignature(signatureBase64.length());
-            int actualLen = BIO_read(bio, tempSignature.data(), tempSignature.size());
-            if (actualLen <= 0) {
-                BIO_free_all(bio);
-                return false;
-            }
-            signature.resize(actualLen);
-            std::copy(tempSignature.begin(), tempSignature.begin() + actualLen, signature.begin());
-            BIO_free_all(bio);
-        } catch (...) {
-            if (bio) BIO_free_all(bio);
-            return false;
-        }
-    }
-
-    FILE *pubKeyFile = fopen(publicKeyPath.c_str(), "r");
-    if (!pubKeyFile) return false;
-
-    EVP_PKEY *pubKey = PEM_read_PUBKEY(pubKeyFile, nullptr, nullptr, nullptr);
-    fclose(pubKeyFile);
-    if (!pubKey) return false;
-
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx) {
-        EVP_PKEY_free(pubKey);
+    LicenseVerifier verifier;
+    if (!verifier.loadPublicKey(publicKeyPath))
         return false;
-    }
-
-    if (EVP_VerifyInit_ex(ctx, EVP_sha256(), nullptr) != 1 ||
-        EVP_VerifyUpdate(ctx, hash.c_str(), hash.length()) != 1) {
-        EVP_MD_CTX_free(ctx);
-        EVP_PKEY_free(pubKey);
-        return false;
-    }
-
-    int result = EVP_VerifyFinal(ctx, signature.data(), signature.size(), pubKey);
-    EVP_MD_CTX_free(ctx);
-    EVP_PKEY_free(pubKey);
 
-    return (result == 1);
+    return verifier.verify(hash, signatureBase64);
 }
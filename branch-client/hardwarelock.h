@@ -1,24 +1,59 @@
 #ifndef HARDWARELOCK_H
 #define HARDWARELOCK_H
 
-#include <QString>
 #include <string>
-#include <QDebug>
+#include <atomic>
+#include <functional>
+#include <vector>
 
+#include <licenseclaims.h>
+
+/**
+ * @brief Hardware fingerprinting and license checks of the branch client.
+ *
+ * Extends the Qt-free HardwareFingerprint probes of the cryptolicense library
+ * with command line fallbacks, concurrent probing on a Qt thread pool and
+ * start-up tracing. The public interface uses standard types only.
+ */
 class HardwareLock {
 public:
     /**
      * @brief Retrieves the MAC address of the primary network adapter.
+     *
+     * The adapter is chosen by InterfaceSelector, independently of the order
+     * in which the OS lists interfaces.
+     *
      * @return MAC address as a string.
      */
     static std::string getMacAddress();
 
+    /**
+     * @brief Retrieves the MAC address of the first non-loopback interface Qt enumerates.
+     *
+     * This is how adapters were chosen before InterfaceSelector; it is kept
+     * to recognize licenses issued for such fingerprints.
+     *
+     * @return MAC address as a string.
+     */
+    static std::string getLegacyMacAddress();
+
     /**
      * @brief Retrieves the serial number of the main disk.
      * @return Disk serial number as a string.
      */
     static std::string getDiskSerialNumber();
 
+    /**
+     * @brief Retrieves the disk serial number the way clients before native probing did.
+     *
+     * Those clients started their commands without a shell, so most of them
+     * failed; this repeats the few sources that succeeded. It is kept to
+     * recognize licenses issued for such fingerprints.
+     *
+     * @return Disk serial number as a string.
+     */
+    static std::string getLegacyDiskSerialNumber();
+
     /**
      * @brief Retrieves the CPU ID of the system.
      * @return CPU ID as a string.
@@ -31,6 +66,32 @@ public:
      */
     static std::string getHardwareFingerprint();
 
+    /**
+     * @brief Generates the hardware fingerprint the way clients before native probing did.
+     * @return Fingerprint based on getLegacyMacAddress() and getLegacyDiskSerialNumber().
+     */
+    static std::string getLegacyHardwareFingerprint();
+
+    /**
+     * @brief Hashes the fingerprint inputs individually.
+     *
+     * Probes the same MAC address, disk serial and CPU ID as
+     * getHardwareFingerprint(); used to request and check licenses that
+     * tolerate a change of a single component.
+     *
+     * @param fingerprint Fingerprint the license is (to be) issued for; keys the hashes.
+     * @return Component hashes (see HardwareFingerprint::componentHashes()).
+     */
+    static LicenseClaims::ComponentHashes getComponentHashes(const std::string &fingerprint);
+
+    /**
+     * @brief Probes the fingerprint inputs concurrently under one probe budget.
+     * @param mac Receives the MAC address.
+     * @param disk Receives the disk serial number.
+     * @param cpu Receives the CPU ID.
+     */
+    static void probeComponents(std::string &mac, std::string &disk, std::string &cpu);
+
     /**
      * @brief Verifies the license by checking the hash and digital signature using the given public key.
      * @param hash The hardware fingerprint hash.
@@ -41,12 +102,33 @@ public:
     static bool verifyLicense(const std::string &hash, const std::string &signatureBase64, const std::string &publicKeyPath);
 
 private:
+    /**
+     * @brief One source in a probe fallback chain.
+     *
+     * Receives a cancellation flag that is raised once a higher-priority
+     * source has answered; returns an empty string if it has no answer.
+     */
+    using ProbeSource = std::function<std::string(const std::atomic_bool &cancel)>;
+
+    /**
+     * @brief Runs all sources of a fallback chain concurrently.
+     *
+     * The first non-empty answer in priority order wins, so the result is the
+     * same as running the chain serially. Lower-priority sources still running
+     * at that point are cancelled.
+     *
+     * @param sources Sources in descending priority.
+     * @return Answer of the highest-priority successful source, or an empty string.
+     */
+    static std::string runFallbackChain(const std::vector<ProbeSource> &sources);
+
     /**
      * @brief Executes a system command and returns its output as a string.
      * @param command The system command to execute.
+     * @param cancel Optional flag; the process is killed as soon as it is set.
      * @return Output of the command as a string.
      */
-    static std::string executeCommand(const std::string &command);
+    static std::string executeCommand(const std::string &command, const std::atomic_bool *cancel = nullptr);
 };
 
 #endif // HARDWARELOCK_H
@@ -0,0 +1,279 @@
+#include "licenseactivator.h"
+#include "clientlog.h"
+#include "licensevalidator.h"
+#include "licenseverifier.h"
+
+#include <QDebug>
+#include <QEventLoop>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <algorithm>
+
+/**
+ * @brief Waits without blocking the event loop.
+ * @param ms Delay in milliseconds.
+ */
+static void waitFor(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+/**
+ * @brief Checks that a downloaded license is for this machine, correctly signed and not expired.
+ * @param license License file contents (JSON or binary).
+ * @param fingerprint Local hardware fingerprint.
+ * @param verifier Verifier holding the client's public key.
+ * @param error Receives a failure description.
+ * @return true if the license is valid.
+ */
+static bool validateLicense(const QByteArray &license, const std::string &fingerprint,
+                            const LicenseVerifier &verifier, QString &error)
+{
+    LicenseValidator::License parsed;
+    if (LicenseValidator::parse(license.constData(), static_cast<std::size_t>(license.size()), parsed) !=
+        LicenseValidator::Status::Valid) {
+        error = "Server returned a corrupted license.";
+        return false;
+    }
+
+    switch (LicenseValidator::check(parsed, QString::fromStdString(fingerprint), verifier, LicenseValidator::now())) {
+    case LicenseValidator::Status::Valid:
+        return true;
+    case LicenseValidator::Status::FingerprintMismatch:
+        error = "Server returned a license for a different hardware fingerprint.";
+        return false;
+    case LicenseValidator::Status::Expired:
+        error = "Server returned an expired license.";
+        return false;
+    default:
+        error = "License signature from server could not be verified.";
+        return false;
+    }
+}
+
+LicenseActivator::LicenseActivator(const Options &options) : m_options(options) {}
+
+/**
+ * @brief Reads the service URL from `CRYPTOBRANCH_ACTIVATION_URL`.
+ * @return Service URL, or an empty URL if online activation is not configured.
+ */
+QUrl LicenseActivator::serverUrlFromEnvironment()
+{
+    QUrl url(qEnvironmentVariable("CRYPTOBRANCH_ACTIVATION_URL"), QUrl::StrictMode);
+    return url.isValid() && !url.host().isEmpty() ? url : QUrl();
+}
+
+/**
+ * @brief Reads the service's bearer token from `CRYPTOBRANCH_ACTIVATION_TOKEN`.
+ * @return Token, or an empty array if none is set.
+ */
+QByteArray LicenseActivator::tokenFromEnvironment()
+{
+    return qgetenv("CRYPTOBRANCH_ACTIVATION_TOKEN").trimmed();
+}
+
+/**
+ * @brief Computes the delay before a retry.
+ *
+ * Uses "full jitter": a uniformly random delay between 0 and
+ * `min(maxBackoffMs, initialBackoffMs * 2^(attempt - 1))`, so clients that
+ * failed together do not retry together. A server-supplied `Retry-After`
+ * takes precedence, capped at maxBackoffMs.
+ *
+ * @param attempt Number of attempts made so far (1 after the first failure).
+ * @param retryAfterMs Server-requested delay, or -1.
+ * @return Delay in milliseconds.
+ */
+int LicenseActivator::backoffDelay(int attempt, int retryAfterMs) const
+{
+    if (retryAfterMs >= 0)
+        return std::min(retryAfterMs, m_options.maxBackoffMs);
+
+    qint64 cap = static_cast<qint64>(m_options.initialBackoffMs) << std::min(attempt - 1, 20);
+    cap = std::min<qint64>(cap, m_options.maxBackoffMs);
+    return static_cast<int>(QRandomGenerator::global()->bounded(cap + 1));
+}
+
+/**
+ * @brief Performs one activation request.
+ * @param payload JSON request body.
+ * @param license Receives the license file contents on success.
+ * @param retryAfterMs Receives the server's `Retry-After` delay, or -1.
+ * @param error Receives a failure description.
+ * @return Whether the attempt succeeded, may be retried or failed permanently.
+ */
+LicenseActivator::Outcome LicenseActivator::requestLicense(const QByteArray &payload, QByteArray &license,
+                                                           int &retryAfterMs, QString &error)
+{
+    QUrl url = m_options.serverUrl;
+    if (url.path().isEmpty() || url.path() == "/")
+        url.setPath("/v1/licenses");
+
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    if (!m_options.token.isEmpty())
+        request.setRawHeader("Authorization", "Bearer " + m_options.token);
+    request.setTransferTimeout(m_options.timeoutMs);
+
+    QNetworkReply *reply = m_network.post(request, payload);
+    QEventLoop loop;
+    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const QNetworkReply::NetworkError networkError = reply->error();
+    const QByteArray body = reply->readAll();
+    bool retryAfterOk = false;
+    const int retryAfterSeconds = reply->rawHeader("Retry-After").toInt(&retryAfterOk);
+    retryAfterMs = retryAfterOk && retryAfterSeconds >= 0 ? retryAfterSeconds * 1000 : -1;
+    error = reply->errorString();
+    reply->deleteLater();
+
+    if (status == 200 && networkError == QNetworkReply::NoError) {
+        license = body;
+        return Outcome::Success;
+    }
+    if (status == 0) {
+        // No HTTP response: timeout, refused connection, DNS failure...
+        return networkError == QNetworkReply::SslHandshakeFailedError ||
+                       networkError == QNetworkReply::ProtocolUnknownError
+                   ? Outcome::Fail
+                   : Outcome::Retry;
+    }
+
+    QString serverMessage = QJsonDocument::fromJson(body).object()["error"].toString();
+    error = QString("HTTP %1%2").arg(status).arg(serverMessage.isEmpty() ? QString() : ": " + serverMessage);
+    return (status == 429 || status >= 500) ? Outcome::Retry : Outcome::Fail;
+}
+
+/**
+ * @brief Requests, verifies and stores a license for this machine.
+ * @param fingerprint Local hardware fingerprint.
+ * @param verifier Verifier holding the client's public key.
+ * @param licensePath Where to store the license (`license.lic`).
+ * @param errorMessage Receives a description of the last failure; may be null.
+ * @param components Component hashes to bind into the license; may be null or incomplete (see requestPayload()).
+ * @return true if a valid license was stored at @p licensePath.
+ */
+bool LicenseActivator::activate(const std::string &fingerprint, const LicenseVerifier &verifier,
+                                const QString &licensePath, QString *errorMessage,
+                                const LicenseClaims::ComponentHashes *components)
+{
+    QString error = "Online activation is not configured.";
+    if (m_options.serverUrl.isEmpty() || !verifier.isLoaded()) {
+        if (!verifier.isLoaded())
+            error = "No public key available to verify the license.";
+        if (errorMessage)
+            *errorMessage = error;
+        return false;
+    }
+
+    const QByteArray payload = requestPayload(fingerprint, components);
+
+    for (int attempt = 1; attempt <= m_options.maxAttempts; ++attempt) {
+        QByteArray license;
+        int retryAfterMs = -1;
+        Outcome outcome = requestLicense(payload, license, retryAfterMs, error);
+
+        if (outcome == Outcome::Success) {
+            if (!validateLicense(license, fingerprint, verifier, error))
+                break; // A bad license will not get better by asking again
+
+            QSaveFile file(licensePath);
+            if (!file.open(QIODevice::WriteOnly) || file.write(license) != license.size() || !file.commit()) {
+                error = "Could not write " + licensePath + ".";
+                break;
+            }
+            qCInfo(lcLicense) << "License activated online and saved to" << licensePath;
+            return true;
+        }
+        if (outcome == Outcome::Fail || attempt == m_options.maxAttempts)
+            break;
+
+        int delay = backoffDelay(attempt, retryAfterMs);
+        qCWarning(lcLicense) << "Activation attempt" << attempt << "failed:" << error << "- retrying in" << delay << "ms";
+        waitFor(delay);
+    }
+
+    if (errorMessage)
+        *errorMessage = error;
+    return false;
+}
+
+/**
+ * @brief Builds the body of a license request.
+ * @param fingerprint Local hardware fingerprint.
+ * @param components Component hashes to bind into the license; may be null.
+ * @return Compact JSON; `components` is left out unless all of them are set.
+ */
+QByteArray LicenseActivator::requestPayload(const std::string &fingerprint,
+                                            const LicenseClaims::ComponentHashes *components)
+{
+    QJsonObject requestBody;
+    requestBody["hardwareId"] = QString::fromStdString(fingerprint);
+    LicenseClaims requested;
+    if (components)
+        requested.components = *components;
+    if (requested.hasAllComponents()) {
+        QJsonObject componentObject;
+        for (int i = 0; i < LicenseClaims::ComponentCount; ++i)
+            componentObject[LicenseClaims::componentName(i)] = QString::fromStdString(requested.components[i]);
+        requestBody["components"] = componentObject;
+    }
+    return QJsonDocument(requestBody).toJson(QJsonDocument::Compact);
+}
+
+/**
+ * @brief Fetches the revocation updates published since a list sequence.
+ *
+ * Makes a single attempt: callers that poll periodically simply try again
+ * on their next round.
+ *
+ * @param sinceSequence Sequence of the local list (0 if there is none).
+ * @param update Receives a delta or full list, or is cleared when up to date.
+ * @param errorMessage Receives a failure description; may be null.
+ * @return true if the request succeeded (including "up to date").
+ */
+bool LicenseActivator::fetchRevocationUpdate(quint64 sinceSequence, QByteArray &update, QString *errorMessage)
+{
+    update.clear();
+    if (m_options.serverUrl.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = "Online activation is not configured.";
+        return false;
+    }
+
+    QUrl url = m_options.serverUrl;
+    url.setPath("/v1/revocations");
+    if (sinceSequence > 0) {
+        QUrlQuery query;
+        query.addQueryItem("since", QString::number(sinceSequence));
+        url.setQuery(query);
+    }
+
+    QNetworkRequest request(url);
+    request.setTransferTimeout(m_options.timeoutMs);
+
+    QNetworkReply *reply = m_network.get(request);
+    QEventLoop loop;
+    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const bool ok = reply->error() == QNetworkReply::NoError && (status == 200 || status == 204);
+    if (ok && status == 200)
+        update = reply->readAll();
+    if (!ok && errorMessage)
+        *errorMessage = status != 0 ? QString("HTTP %1").arg(status) : reply->errorString();
+    reply->deleteLater();
+    return ok;
+}
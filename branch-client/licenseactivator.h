@@ -0,0 +1,127 @@
+#ifndef LICENSEACTIVATOR_H
+#define LICENSEACTIVATOR_H
+
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QString>
+#include <QUrl>
+
+#include <string>
+
+#include <licenseclaims.h>
+
+class LicenseVerifier;
+
+/**
+ * @brief Online license activation against the license issuance service.
+ *
+ * Posts the local hardware fingerprint to `POST /v1/licenses`, verifies the
+ * returned license against the client's public key and stores it as the
+ * license file. Revocation list updates are fetched from `GET /v1/revocations`. A single QNetworkAccessManager is reused for all attempts so
+ * keep-alive connections are shared. Every attempt has a transfer timeout;
+ * network errors, `429` and `5xx` responses are retried with capped
+ * exponential backoff and full jitter (or the server's `Retry-After`), so a
+ * fleet of clients activating at once spreads its load over time.
+ */
+class LicenseActivator {
+public:
+    /**
+     * @brief Server location, timeouts and retry policy.
+     */
+    struct Options {
+        QUrl serverUrl;              ///< Service base URL (e.g. `http://licenses:8080`) or full endpoint URL
+        QByteArray token;            ///< Bearer token sent with license requests
+        int timeoutMs = 10000;       ///< Per-attempt transfer timeout
+        int maxAttempts = 5;         ///< Total attempts including the first one
+        int initialBackoffMs = 1000; ///< Backoff cap before the first retry
+        int maxBackoffMs = 60000;    ///< Upper bound of any single backoff delay
+    };
+
+    /**
+     * @brief Creates an activator.
+     * @param options Server URL, timeouts and retry policy.
+     */
+    explicit LicenseActivator(const Options &options);
+
+    /**
+     * @brief Reads the service URL from `CRYPTOBRANCH_ACTIVATION_URL`.
+     * @return Service URL, or an empty URL if online activation is not configured.
+     */
+    static QUrl serverUrlFromEnvironment();
+
+    /**
+     * @brief Reads the service's bearer token from `CRYPTOBRANCH_ACTIVATION_TOKEN`.
+     * @return Token, or an empty array if none is set.
+     */
+    static QByteArray tokenFromEnvironment();
+
+    /**
+     * @brief Requests, verifies and stores a license for this machine.
+     *
+     * Blocks until a license was stored or all attempts failed, running a
+     * local event loop meanwhile.
+     *
+     * @param fingerprint Local hardware fingerprint.
+     * @param verifier Verifier holding the client's public key.
+     * @param licensePath Where to store the license (`license.lic`).
+     * @param errorMessage Receives a description of the last failure; may be null.
+     * @param components Component hashes to bind into the license; may be null or incomplete (see requestPayload()).
+     * @return true if a valid license was stored at @p licensePath.
+     */
+    bool activate(const std::string &fingerprint, const LicenseVerifier &verifier,
+                  const QString &licensePath, QString *errorMessage = nullptr,
+                  const LicenseClaims::ComponentHashes *components = nullptr);
+
+    /**
+     * @brief Builds the body of a license request.
+     *
+     * Components are only sent as a complete set; the server refuses partial
+     * sets, so a machine with a constant component asks for an exact-match
+     * license instead.
+     *
+     * @param fingerprint Local hardware fingerprint.
+     * @param components Component hashes to bind into the license; may be null.
+     * @return Compact JSON `{"hardwareId": ..., "components": {...}}`.
+     */
+    static QByteArray requestPayload(const std::string &fingerprint, const LicenseClaims::ComponentHashes *components);
+
+    /**
+     * @brief Fetches the revocation updates published since a list sequence.
+     *
+     * Calls `GET /v1/revocations?since=<sequence>` once, blocking on a local
+     * event loop. Apply the result with RevocationChecker::applyUpdate().
+     *
+     * @param sinceSequence Sequence of the local list (0 if there is none).
+     * @param update Receives a delta or full list, or is cleared when up to date.
+     * @param errorMessage Receives a failure description; may be null.
+     * @return true if the request succeeded (including "up to date").
+     */
+    bool fetchRevocationUpdate(quint64 sinceSequence, QByteArray &update, QString *errorMessage = nullptr);
+
+private:
+    /// Result of one request attempt.
+    enum class Outcome { Success, Retry, Fail };
+
+    /**
+     * @brief Performs one activation request.
+     * @param payload JSON request body.
+     * @param license Receives the license file contents on success.
+     * @param retryAfterMs Receives the server's `Retry-After` delay, or -1.
+     * @param error Receives a failure description.
+     * @return Whether the attempt succeeded, may be retried or failed permanently.
+     */
+    Outcome requestLicense(const QByteArray &payload, QByteArray &license, int &retryAfterMs, QString &error);
+
+    /**
+     * @brief Computes the delay before a retry.
+     * @param attempt Number of attempts made so far (1 after the first failure).
+     * @param retryAfterMs Server-requested delay, or -1.
+     * @return Delay in milliseconds.
+     */
+    int backoffDelay(int attempt, int retryAfterMs) const;
+
+    Options m_options;               ///< Activation settings
+    QNetworkAccessManager m_network; ///< Shared for all attempts (connection reuse)
+};
+
+#endif // LICENSEACTIVATOR_H
@@ -0,0 +1,82 @@
+#include "licenseloader.h"
+#include "startuptrace.h"
+
+#include <QResource>
+
+LicenseLoader::LicenseLoader() : m_data(nullptr), m_size(0), m_static(false) {}
+
+/**
+ * @brief Maps a license file or resource.
+ *
+ * Uncompressed resources are used in place; they are part of the binary
+ * image, so the OS pages them in on first access just like a mapped file.
+ *
+ * @param licensePath File path, or a resource path such as `:/license.lic`.
+ * @return Status::Ok if data() and size() describe the license contents.
+ */
+LicenseLoader::Status LicenseLoader::open(const QString &licensePath)
+{
+    StartupTrace::Scope trace("license.read");
+    m_file.close();
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_static = false;
+
+    if (licensePath.startsWith(":/")) {
+        QResource resource(licensePath);
+        if (!resource.isValid())
+            return Status::Missing;
+        if (resource.compressionAlgorithm() == QResource::NoCompression && resource.data()) {
+            m_data = reinterpret_cast<const char *>(resource.data());
+            m_size = static_cast<std::size_t>(resource.size());
+            m_static = true;
+            return Status::Ok;
+        }
+        // Compressed resource: QFile decompresses it into m_buffer below
+    }
+
+    m_file.setFileName(licensePath);
+    if (!m_file.exists())
+        return Status::Missing;
+    if (!m_file.open(QIODevice::ReadOnly))
+        return Status::Unreadable;
+
+    qint64 size = m_file.size();
+    if (uchar *mapped = size > 0 ? m_file.map(0, size) : nullptr) {
+        m_data = reinterpret_cast<const char *>(mapped);
+        m_size = static_cast<std::size_t>(size);
+    } else {
+        m_buffer = m_file.readAll();
+        m_data = m_buffer.constData();
+        m_size = static_cast<std::size_t>(m_buffer.size());
+    }
+    return Status::Ok;
+}
+
+/**
+ * @brief Returns the license contents.
+ * @return Pointer to size() bytes.
+ */
+const char *LicenseLoader::data() const
+{
+    return m_data;
+}
+
+/**
+ * @brief Returns the size of the license contents.
+ * @return Size in bytes.
+ */
+std::size_t LicenseLoader::size() const
+{
+    return m_size;
+}
+
+/**
+ * @brief Checks whether data() outlives the loader.
+ * @return true for uncompressed resources.
+ */
+bool LicenseLoader::isStatic() const
+{
+    return m_static;
+}
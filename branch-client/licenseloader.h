@@ -0,0 +1,63 @@
+#ifndef LICENSELOADER_H
+#define LICENSELOADER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <cstddef>
+
+/**
+ * @brief Read-only access to the bytes of a license without copying them.
+ *
+ * License files are memory-mapped; licenses compiled into the binary as Qt
+ * resources (paths starting with `:/`, see CRYPTOBRANCH_EMBEDDED_LICENSE)
+ * are read in place from the resource data. Only when neither is possible,
+ * e.g. for compressed resources or files on filesystems without mmap, are the
+ * contents read into memory. Either way LicenseParser then works on data().
+ */
+class LicenseLoader {
+public:
+    /// Outcome of open().
+    enum class Status {
+        Ok,        ///< data() holds the license
+        Missing,   ///< File or resource does not exist
+        Unreadable ///< File exists but could not be read
+    };
+
+    LicenseLoader();
+
+    /**
+     * @brief Maps a license file or resource.
+     * @param licensePath File path, or a resource path such as `:/license.lic`.
+     * @return Status::Ok if data() and size() describe the license contents.
+     */
+    Status open(const QString &licensePath);
+
+    /**
+     * @brief Returns the license contents.
+     * @return Pointer to size() bytes; valid until the loader is destroyed or reopened (see isStatic()).
+     */
+    const char *data() const;
+
+    /**
+     * @brief Returns the size of the license contents.
+     * @return Size in bytes.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether data() outlives the loader.
+     * @return true for uncompressed resources, whose data is part of the binary.
+     */
+    bool isStatic() const;
+
+private:
+    QFile m_file;          ///< Mapped license file
+    QByteArray m_buffer;   ///< License contents when they cannot be mapped
+    const char *m_data;    ///< Start of the license contents
+    std::size_t m_size;    ///< Size of the license contents
+    bool m_static;         ///< true if m_data points into a compiled-in resource
+};
+
+#endif // LICENSELOADER_H
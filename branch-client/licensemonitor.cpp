@@ -0,0 +1,157 @@
+#include "licensemonitor.h"
+#include "clientlog.h"
+#include "licenseactivator.h"
+#include "licenseverifier.h"
+#include "revocationchecker.h"
+
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <climits>
+
+/**
+ * @brief Runs one re-validation; executed on a QThreadPool worker.
+ *
+ * When a service URL is configured, revocation updates since the local list
+ * are fetched and applied first (a failed download keeps the current list).
+ *
+ * @param fingerprint Local hardware fingerprint from start-up.
+ * @param verifier Shared verifier.
+ * @param options Monitor settings.
+ * @return Validation result.
+ */
+static LicenseValidator::Result revalidate(const QString &fingerprint, const LicenseVerifier &verifier,
+                                           const LicenseMonitor::Options &options) {
+    if (!options.serverUrl.isEmpty()) {
+        quint64 sequence = 0;
+        {
+            // Unmapped again before the file is replaced
+            RevocationChecker current;
+            if (current.load(options.revocationListPath, verifier))
+                sequence = current.sequence();
+        }
+
+        LicenseActivator::Options activationOptions;
+        activationOptions.serverUrl = options.serverUrl;
+        LicenseActivator activator(activationOptions);
+        QByteArray update;
+        QString error;
+        if (!activator.fetchRevocationUpdate(sequence, update, &error))
+            qCWarning(lcLicense) << "Revocation update failed:" << error;
+        else if (!update.isEmpty())
+            RevocationChecker::applyUpdate(options.revocationListPath, update, verifier);
+    }
+
+    return LicenseValidator::validate(options.licensePath, fingerprint, verifier, options.revocationListPath);
+}
+
+/**
+ * @brief Creates a monitor.
+ * @param fingerprint Local hardware fingerprint established at start-up.
+ * @param verifier Loaded verifier; must outlive the monitor.
+ * @param options Files, update source and interval.
+ */
+LicenseMonitor::LicenseMonitor(const QString &fingerprint, const LicenseVerifier &verifier, const Options &options)
+    : m_fingerprint(fingerprint), m_verifier(verifier), m_options(options), m_active(false) {
+    m_timer.setSingleShot(true);
+    QObject::connect(&m_timer, &QTimer::timeout, [this]() { checkNow(); });
+    QObject::connect(&m_watcher, &QFutureWatcherBase::finished, [this]() { onCheckFinished(); });
+}
+
+/**
+ * @brief Stops the timer and waits for a running check.
+ */
+LicenseMonitor::~LicenseMonitor() {
+    stop();
+    m_watcher.waitForFinished();
+}
+
+/**
+ * @brief Reads the check interval from `CRYPTOBRANCH_REVALIDATE_INTERVAL`.
+ * @return Interval in seconds, or DefaultIntervalSeconds if the variable is unset or invalid.
+ */
+int LicenseMonitor::intervalFromEnvironment() {
+    bool ok = false;
+    int value = qEnvironmentVariable("CRYPTOBRANCH_REVALIDATE_INTERVAL").toInt(&ok);
+    return (ok && value >= 0) ? value : DefaultIntervalSeconds;
+}
+
+/**
+ * @brief Starts periodic checks.
+ * @param expiresAt Signed expiry of the current license (0 = never expires).
+ * @param onInvalid Called once when the license stops being valid; checks stop afterwards.
+ */
+void LicenseMonitor::start(std::int64_t expiresAt, InvalidHandler onInvalid) {
+    m_onInvalid = std::move(onInvalid);
+    m_active = true;
+    schedule(expiresAt);
+}
+
+/**
+ * @brief Stops periodic checks; a running check is allowed to finish but not reported.
+ */
+void LicenseMonitor::stop() {
+    m_active = false;
+    m_timer.stop();
+}
+
+/**
+ * @brief Arms the timer for the next check.
+ *
+ * The next check runs after the configured interval or one second after the
+ * license expires, whichever comes first. Without an interval only the
+ * expiry is watched.
+ *
+ * @param expiresAt Signed expiry of the current license (0 = never expires).
+ */
+void LicenseMonitor::schedule(std::int64_t expiresAt) {
+    if (!m_active)
+        return;
+
+    std::int64_t delaySeconds = m_options.intervalSeconds > 0 ? m_options.intervalSeconds : -1;
+    if (expiresAt != 0) {
+        std::int64_t untilExpiry = std::max<std::int64_t>(expiresAt - LicenseValidator::now() + 1, 1);
+        delaySeconds = delaySeconds < 0 ? untilExpiry : std::min(delaySeconds, untilExpiry);
+    }
+    if (delaySeconds < 0)
+        return;
+
+    // QTimer takes an int; far-away expiries are reached through several shorter waits
+    m_timer.start(static_cast<int>(std::min<std::int64_t>(delaySeconds * 1000, INT_MAX)));
+}
+
+/**
+ * @brief Starts a check on a worker thread unless one is still running.
+ */
+void LicenseMonitor::checkNow() {
+    if (!m_active || m_watcher.isRunning())
+        return;
+
+    const QString fingerprint = m_fingerprint;
+    const LicenseVerifier *verifier = &m_verifier;
+    const Options options = m_options;
+    m_watcher.setFuture(QtConcurrent::run([fingerprint, verifier, options]() {
+        return revalidate(fingerprint, *verifier, options);
+    }));
+}
+
+/**
+ * @brief Handles a finished check on the GUI thread.
+ */
+void LicenseMonitor::onCheckFinished() {
+    if (!m_active)
+        return;
+
+    const LicenseValidator::Result result = m_watcher.result();
+    if (result.status == LicenseValidator::Status::Valid) {
+        // The license file may have been renewed since the last check
+        schedule(result.license.claims.expiresAt);
+        return;
+    }
+
+    qCWarning(lcLicense) << "Background license check failed with status" << static_cast<int>(result.status);
+    stop();
+    if (m_onInvalid)
+        m_onInvalid(result);
+}
@@ -0,0 +1,107 @@
+#ifndef LICENSEMONITOR_H
+#define LICENSEMONITOR_H
+
+#include <QFutureWatcher>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+
+#include <cstdint>
+#include <functional>
+
+#include "licensevalidator.h"
+
+class LicenseVerifier;
+
+/**
+ * @brief Periodic background re-validation of the license while the application runs.
+ *
+ * A QTimer on the GUI thread schedules each check; the check itself runs on a
+ * QThreadPool worker via QtConcurrent, so file I/O, signature verification and
+ * the optional revocation download never block the UI. The fingerprint and
+ * LicenseVerifier from start-up are reused: hardware is not probed again and
+ * the public key is not parsed again. A check is also scheduled for the
+ * moment the license's signed expiry passes.
+ */
+class LicenseMonitor {
+public:
+    /// Default interval between checks in seconds.
+    static constexpr int DefaultIntervalSeconds = 3600;
+
+    /**
+     * @brief Files, update source and interval.
+     */
+    struct Options {
+        QString licensePath = "license.lic";             ///< License file to re-read
+        QString revocationListPath = "revocations.lst";  ///< Signed revocation list
+        QUrl serverUrl;                                  ///< Issuance service for revocation updates; empty for offline
+        int intervalSeconds = DefaultIntervalSeconds;    ///< Time between checks (0 = disabled)
+    };
+
+    /// Called on the GUI thread when a check fails.
+    using InvalidHandler = std::function<void(const LicenseValidator::Result &)>;
+
+    /**
+     * @brief Creates a monitor.
+     * @param fingerprint Local hardware fingerprint established at start-up.
+     * @param verifier Loaded verifier; must outlive the monitor.
+     * @param options Files, update source and interval.
+     */
+    LicenseMonitor(const QString &fingerprint, const LicenseVerifier &verifier, const Options &options);
+
+    /**
+     * @brief Stops the timer and waits for a running check.
+     */
+    ~LicenseMonitor();
+
+    LicenseMonitor(const LicenseMonitor &) = delete;
+    LicenseMonitor &operator=(const LicenseMonitor &) = delete;
+
+    /**
+     * @brief Reads the check interval from `CRYPTOBRANCH_REVALIDATE_INTERVAL`.
+     *
+     * A value of 0 disables periodic re-validation.
+     *
+     * @return Interval in seconds, or DefaultIntervalSeconds if the variable is unset or invalid.
+     */
+    static int intervalFromEnvironment();
+
+    /**
+     * @brief Starts periodic checks.
+     * @param expiresAt Signed expiry of the current license (0 = never expires).
+     * @param onInvalid Called once when the license stops being valid; checks stop afterwards.
+     */
+    void start(std::int64_t expiresAt, InvalidHandler onInvalid);
+
+    /**
+     * @brief Stops periodic checks; a running check is allowed to finish but not reported.
+     */
+    void stop();
+
+private:
+    /**
+     * @brief Arms the timer for the next check.
+     * @param expiresAt Signed expiry of the current license (0 = never expires).
+     */
+    void schedule(std::int64_t expiresAt);
+
+    /**
+     * @brief Starts a check on a worker thread unless one is still running.
+     */
+    void checkNow();
+
+    /**
+     * @brief Handles a finished check on the GUI thread.
+     */
+    void onCheckFinished();
+
+    QString m_fingerprint;                                 ///< Fingerprint from start-up
+    const LicenseVerifier &m_verifier;                     ///< Shared, thread-safe verifier
+    Options m_options;                                     ///< Monitor settings
+    InvalidHandler m_onInvalid;                            ///< Failure callback
+    QTimer m_timer;                                        ///< Next check (GUI thread)
+    QFutureWatcher<LicenseValidator::Result> m_watcher;    ///< Running check
+    bool m_active;                                         ///< false after stop() or a failure
+};
+
+#endif // LICENSEMONITOR_H
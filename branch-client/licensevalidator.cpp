@@ -0,0 +1,238 @@
+#include "licensevalidator.h"
+#include "clientlog.h"
+#include "licenseloader.h"
+#include "revocationchecker.h"
+#include "revocationstate.h"
+#include "startuptrace.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+
+/**
+ * @brief Parses a license held in memory.
+ *
+ * Binary and JSON licenses are both parsed in place by LicenseParser; JSON
+ * licenses accept both the `hardwareFingerprint` and the older `hardwareId`
+ * field.
+ *
+ * @param data License file contents (JSON or binary).
+ * @param size Size of @p data in bytes.
+ * @param license Receives the parsed fields; they point into @p data.
+ * @param detail Receives the parser error for Status::Malformed; may be null.
+ * @return Status::Valid, Status::Malformed or Status::MissingFields.
+ */
+LicenseValidator::Status LicenseValidator::parse(const char *data, std::size_t size, License &license, QString *detail) {
+    StartupTrace::Scope trace("license.parse");
+    license = License();
+
+    std::string error;
+    if (!LicenseParser::parse(data, size, license, &error)) {
+        if (detail)
+            *detail = QString::fromStdString(error);
+        return Status::Malformed;
+    }
+    if (!license.isComplete())
+        return Status::MissingFields;
+    return Status::Valid;
+}
+
+/**
+ * @brief Verifies a license's signature over its fingerprint and claims.
+ * @param license Parsed license.
+ * @param verifier Verifier holding the license public key.
+ * @return true if the signature is valid.
+ */
+bool LicenseValidator::verifySignature(const License &license, const LicenseVerifier &verifier) {
+    StartupTrace::Scope trace("license.verify");
+    return LicenseParser::verify(license, verifier);
+}
+
+/**
+ * @brief Checks a license against this machine.
+ *
+ * Expiry is checked after the signature, so an edited `expiresAt` is
+ * reported as an invalid signature rather than as a valid date. The
+ * component hashes are covered by the same signature, so a license cannot be
+ * made to match by editing them.
+ *
+ * @param license Parsed license.
+ * @param fingerprint Local hardware fingerprint.
+ * @param verifier Verifier holding the license public key.
+ * @param now Current Unix time in seconds.
+ * @param components Local component hashes; null to require an exact fingerprint match.
+ * @return Status::Valid, Status::FingerprintMismatch, Status::InvalidSignature or Status::Expired.
+ */
+LicenseValidator::Status LicenseValidator::check(const License &license, const QString &fingerprint,
+                                                 const LicenseVerifier &verifier, std::int64_t now,
+                                                 const LicenseClaims::ComponentHashes *components) {
+    if (license.fingerprintString() != fingerprint && (!components || !license.claims.componentsMatch(*components)))
+        return Status::FingerprintMismatch;
+    if (!verifySignature(license, verifier))
+        return Status::InvalidSignature;
+    if (license.claims.isExpired(now))
+        return Status::Expired;
+    return Status::Valid;
+}
+
+/**
+ * @brief Maps and parses a license file.
+ * @param licensePath Path of the license file or resource.
+ * @param loader Holds the mapping the parsed license points into.
+ * @param result Receives the status, parsed license and parser error.
+ * @return true if the license was parsed and can be checked further.
+ */
+bool LicenseValidator::read(const QString &licensePath, LicenseLoader &loader, Result &result) {
+    switch (loader.open(licensePath)) {
+    case LicenseLoader::Status::Ok:
+        break;
+    case LicenseLoader::Status::Missing:
+        result.status = Status::Missing;
+        return false;
+    case LicenseLoader::Status::Unreadable:
+        result.status = Status::Unreadable;
+        return false;
+    }
+
+    result.status = parse(loader.data(), loader.size(), result.license, &result.detail);
+    return result.status == Status::Valid;
+}
+
+/**
+ * @brief Copies the viewed fields of a license into License::storage.
+ * @param license License whose views are rebased onto its own storage.
+ */
+void LicenseValidator::detach(License &license) {
+    std::string_view *fields[] = {&license.fingerprint, &license.signature, &license.rawSignature,
+                                  &license.algorithm, &license.keyId};
+    std::size_t offsets[sizeof(fields) / sizeof(fields[0])];
+
+    std::shared_ptr<std::string> storage = std::make_shared<std::string>();
+    for (std::size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++i) {
+        offsets[i] = storage->size();
+        storage->append(fields[i]->data(), fields[i]->size());
+    }
+    for (std::size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++i)
+        *fields[i] = std::string_view(storage->data() + offsets[i], fields[i]->size());
+    license.storage = storage;
+}
+
+/**
+ * @brief Checks a license against the local revocation list.
+ *
+ * Fails closed once a list has been accepted on this machine: a list that
+ * is missing, not correctly signed or older than the newest one recorded in
+ * RevocationState is Status::RevocationUnavailable, as is a tampered state.
+ * Only a machine that never had a list skips the check.
+ *
+ * @param license License that passed all other checks.
+ * @param verifier Verifier holding the license public key.
+ * @param revocationListPath Signed revocation list.
+ * @return Status::Valid, Status::Revoked or Status::RevocationUnavailable.
+ */
+LicenseValidator::Status LicenseValidator::checkRevocation(const License &license, const LicenseVerifier &verifier,
+                                                           const QString &revocationListPath) {
+    RevocationChecker revocations;
+    if (!revocations.load(revocationListPath, verifier)) {
+        if (QFile::exists(revocationListPath) || RevocationState::exists(revocationListPath)) {
+            qCWarning(lcLicense) << "Revocation list" << revocationListPath << "is missing or invalid";
+            return Status::RevocationUnavailable;
+        }
+        return Status::Valid;
+    }
+
+    quint64 newest = 0;
+    if (!RevocationState::read(revocationListPath, newest) || revocations.sequence() < newest) {
+        qCWarning(lcLicense) << "Revocation list" << revocationListPath << "is older than sequence" << newest;
+        return Status::RevocationUnavailable;
+    }
+    RevocationState::record(revocationListPath, revocations.sequence());
+
+    // Revocations name the licensed fingerprint, which differs from the local one after a component match
+    return revocations.isRevoked(license.fingerprint) ? Status::Revoked : Status::Valid;
+}
+
+/**
+ * @brief Reads and fully validates a license file.
+ *
+ * All checks run on views into the mapped file; the parsed license is
+ * detached from the mapping only before it is returned.
+ *
+ * @param licensePath Path of the license file (`license.lic`) or resource.
+ * @param fingerprint Local hardware fingerprint.
+ * @param verifier Verifier holding the license public key.
+ * @param revocationListPath Signed revocation list; skipped if empty, or absent and never seen before.
+ * @param components Local component hashes; null to require an exact fingerprint match.
+ * @return Outcome and parsed license.
+ */
+LicenseValidator::Result LicenseValidator::validate(const QString &licensePath, const QString &fingerprint,
+                                                    const LicenseVerifier &verifier, const QString &revocationListPath,
+                                                    const LicenseClaims::ComponentHashes *components) {
+    Result result;
+    StartupTrace::Scope trace("license.validate");
+
+    LicenseLoader loader;
+    if (read(licensePath, loader, result)) {
+        result.status = check(result.license, fingerprint, verifier, now(), components);
+        if (result.status == Status::Valid && !revocationListPath.isEmpty()) {
+            StartupTrace::Scope revocationTrace("revocation.check");
+            result.status = checkRevocation(result.license, verifier, revocationListPath);
+        }
+    }
+
+    if (!loader.isStatic())
+        detach(result.license);
+    return result;
+}
+
+/**
+ * @brief Checks a license file on its own, without a local fingerprint.
+ * @param licensePath Path of the license file.
+ * @param verifier Verifier holding the license public key.
+ * @param revocations Loaded revocation list; may be null.
+ * @param now Reference Unix time in seconds for the expiry check.
+ * @return Outcome and parsed license; never Status::FingerprintMismatch.
+ */
+LicenseValidator::Result LicenseValidator::audit(const QString &licensePath, const LicenseVerifier &verifier,
+                                                 const RevocationChecker *revocations, std::int64_t now) {
+    Result result;
+    LicenseLoader loader;
+    if (read(licensePath, loader, result)) {
+        result.status = check(result.license, result.license.fingerprintString(), verifier, now);
+        if (result.status == Status::Valid && revocations && revocations->isRevoked(result.license.fingerprint))
+            result.status = Status::Revoked;
+    }
+
+    if (!loader.isStatic())
+        detach(result.license);
+    return result;
+}
+
+/**
+ * @brief Returns a stable, machine-readable name for a status.
+ * @param status Outcome of a check.
+ * @return Name such as "valid" or "invalid-signature".
+ */
+const char *LicenseValidator::statusName(Status status) {
+    switch (status) {
+    case Status::Valid: return "valid";
+    case Status::Missing: return "missing";
+    case Status::Unreadable: return "unreadable";
+    case Status::Malformed: return "malformed";
+    case Status::MissingFields: return "missing-fields";
+    case Status::FingerprintMismatch: return "fingerprint-mismatch";
+    case Status::InvalidSignature: return "invalid-signature";
+    case Status::Expired: return "expired";
+    case Status::Revoked: return "revoked";
+    case Status::RevocationUnavailable: return "revocation-unavailable";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Returns the current time as used for expiry checks.
+ * @return Unix time in seconds.
+ */
+std::int64_t LicenseValidator::now() {
+    return QDateTime::currentSecsSinceEpoch();
+}
@@ -0,0 +1,185 @@
+#ifndef LICENSEVALIDATOR_H
+#define LICENSEVALIDATOR_H
+
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <licenseclaims.h>
+
+#include "licenseparser.h"
+
+class LicenseLoader;
+class LicenseVerifier;
+class RevocationChecker;
+
+/**
+ * @brief The complete license check: parsing, fingerprint, signature, expiry and revocation.
+ *
+ * Shared by start-up, online activation and the background LicenseMonitor so
+ * every path applies the same rules. Nothing here probes hardware or touches
+ * the GUI: the caller passes the fingerprint and a loaded LicenseVerifier, so
+ * validate() can run on a worker thread.
+ *
+ * License files are read through LicenseLoader and LicenseParser: the file is
+ * mapped, and fingerprint and signature go from the mapping into the verifier
+ * as views. Only the few bytes of a returned License are copied, once all
+ * checks are done, so the mapping can be released.
+ */
+class LicenseValidator {
+public:
+    /// Outcome of a license check, in the order the checks are made.
+    enum class Status {
+        Valid,               ///< License accepted
+        Missing,             ///< License file does not exist
+        Unreadable,          ///< License file could not be opened
+        Malformed,           ///< Not a valid JSON or binary license
+        MissingFields,       ///< Hardware fingerprint or signature missing
+        FingerprintMismatch, ///< License belongs to another machine
+        InvalidSignature,    ///< Signature does not match fingerprint and claims
+        Expired,             ///< Signed `expiresAt` has passed
+        Revoked,             ///< Fingerprint is on the signed revocation list
+        RevocationUnavailable ///< Revocation list missing, invalid or older than one accepted before
+    };
+
+    /**
+     * @brief Fields read from a license file.
+     *
+     * The views of LicenseParser::View point into #storage, into a compiled-in
+     * resource or, for licenses passed to parse(), into the caller's buffer.
+     */
+    struct License : LicenseParser::View {
+        std::shared_ptr<const std::string> storage; ///< Owns the viewed bytes once the source is released
+
+        /**
+         * @brief Returns the licensed fingerprint for display and comparison.
+         * @return Fingerprint as a QString.
+         */
+        QString fingerprintString() const {
+            return QString::fromLatin1(fingerprint.data(), static_cast<int>(fingerprint.size()));
+        }
+    };
+
+    /**
+     * @brief Result of validate().
+     */
+    struct Result {
+        Status status = Status::Missing; ///< Outcome
+        License license;                 ///< Parsed license (partially filled on early failures)
+        QString detail;                  ///< Parser error text for Status::Malformed
+    };
+
+    /**
+     * @brief Parses a license held in memory.
+     * @param data License file contents (JSON or binary).
+     * @param size Size of @p data in bytes.
+     * @param license Receives the parsed fields; they point into @p data.
+     * @param detail Receives the parser error for Status::Malformed; may be null.
+     * @return Status::Valid, Status::Malformed or Status::MissingFields.
+     */
+    static Status parse(const char *data, std::size_t size, License &license, QString *detail = nullptr);
+
+    /**
+     * @brief Verifies a license's signature over its fingerprint and claims.
+     * @param license Parsed license.
+     * @param verifier Verifier holding the license public key.
+     * @return true if the signature is valid.
+     */
+    static bool verifySignature(const License &license, const LicenseVerifier &verifier);
+
+    /**
+     * @brief Checks a license against this machine.
+     *
+     * A license whose fingerprint differs is still accepted if it carries
+     * component hashes and enough of them match @p components (see
+     * LicenseClaims::componentsMatch()).
+     *
+     * @param license Parsed license.
+     * @param fingerprint Local hardware fingerprint.
+     * @param verifier Verifier holding the license public key.
+     * @param now Current Unix time in seconds.
+     * @param components Local component hashes; null to require an exact fingerprint match.
+     * @return Status::Valid, Status::FingerprintMismatch, Status::InvalidSignature or Status::Expired.
+     */
+    static Status check(const License &license, const QString &fingerprint, const LicenseVerifier &verifier,
+                        std::int64_t now, const LicenseClaims::ComponentHashes *components = nullptr);
+
+    /**
+     * @brief Reads and fully validates a license file.
+     * @param licensePath Path of the license file (`license.lic`).
+     * @param fingerprint Local hardware fingerprint.
+     * @param verifier Verifier holding the license public key.
+     * @param revocationListPath Signed revocation list; skipped if empty, or absent and never seen before.
+     * @param components Local component hashes; null to require an exact fingerprint match.
+     * @return Outcome and parsed license.
+     */
+    static Result validate(const QString &licensePath, const QString &fingerprint, const LicenseVerifier &verifier,
+                           const QString &revocationListPath,
+                           const LicenseClaims::ComponentHashes *components = nullptr);
+
+    /**
+     * @brief Checks a license file on its own, without a local fingerprint.
+     *
+     * The signature is verified over the fingerprint stored in the license,
+     * followed by expiry and revocation. Used by CryptoAudit to check an
+     * issued corpus; safe to call concurrently with a shared verifier and
+     * revocation list.
+     *
+     * @param licensePath Path of the license file.
+     * @param verifier Verifier holding the license public key.
+     * @param revocations Loaded revocation list; may be null.
+     * @param now Reference Unix time in seconds for the expiry check.
+     * @return Outcome and parsed license; never Status::FingerprintMismatch.
+     */
+    static Result audit(const QString &licensePath, const LicenseVerifier &verifier,
+                        const RevocationChecker *revocations, std::int64_t now);
+
+    /**
+     * @brief Returns a stable, machine-readable name for a status.
+     * @param status Outcome of a check.
+     * @return Name such as "valid" or "invalid-signature".
+     */
+    static const char *statusName(Status status);
+
+    /**
+     * @brief Returns the current time as used for expiry checks.
+     * @return Unix time in seconds.
+     */
+    static std::int64_t now();
+
+private:
+    /**
+     * @brief Maps and parses a license file.
+     * @param licensePath Path of the license file or resource.
+     * @param loader Holds the mapping the parsed license points into.
+     * @param result Receives the status, parsed license and parser error.
+     * @return true if the license was parsed and can be checked further.
+     */
+    static bool read(const QString &licensePath, LicenseLoader &loader, Result &result);
+
+    /**
+     * @brief Checks a license against the local revocation list.
+     * @param license License that passed all other checks.
+     * @param verifier Verifier holding the license public key.
+     * @param revocationListPath Signed revocation list.
+     * @return Status::Valid, Status::Revoked or Status::RevocationUnavailable.
+     */
+    static Status checkRevocation(const License &license, const LicenseVerifier &verifier,
+                                  const QString &revocationListPath);
+
+    /**
+     * @brief Copies the viewed fields of a license into License::storage.
+     *
+     * Called before returning a license read from a file, so the file's
+     * mapping can be released (and the file replaced) while the license is
+     * still in use.
+     *
+     * @param license License whose views are rebased onto its own storage.
+     */
+    static void detach(License &license);
+};
+
+#endif // LICENSEVALIDATOR_H
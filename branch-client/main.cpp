@@ -1,25 +1,45 @@
 #include <QApplication>
 #include <QMessageBox>
+#include <QDir>
 #include <QFile>
 #include <QTextStream>
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QLabel>
+#include <QDateTime>
+#include <QLocale>
+#include <QFutureWatcher>
+#include <QPixmap>
+#include <QSplashScreen>
+#include <QtConcurrent/QtConcurrent>
 
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonParseError>
+#include <cstring>
+#include <memory>
 
 #include "hardwarelock.h"
+#include "clientlog.h"
+#include "fingerprintcache.h"
+#include "licenseactivator.h"
+#include "licensemonitor.h"
+#include "licensevalidator.h"
+#include "licenseverifier.h"
+#include "revocationchecker.h"
+#include "startuptrace.h"
+
+#ifdef CRYPTOBRANCH_EMBEDDED_PUBLIC_KEY
+#include "embeddedpublickey.h"
+#endif
 
 /**
  * @brief Starts the main licensed application interface.
  *
  * Displays a simple window with a counter that can be incremented via a button.
  * This function is only called if the license verification process is successful.
+ *
+ * @param claims Signed expiry and features of the license, shown below the welcome text.
  */
-void startMainApplication() {
+void startMainApplication(const LicenseClaims &claims) {
     QWidget *window = new QWidget;
     window->setWindowTitle("CryptoBranch | Licensed Application");
 
@@ -29,6 +49,15 @@ void startMainApplication() {
     label->setAlignment(Qt::AlignCenter);
     label->setStyleSheet("QLabel { color: green; font-weight: bold; font-size: 14px; }");
 
+    QString details;
+    if (claims.expiresAt != 0)
+        details += "Valid until: " + QLocale().toString(QDateTime::fromSecsSinceEpoch(claims.expiresAt), QLocale::ShortFormat);
+    if (!claims.features.empty())
+        details += QString(details.isEmpty() ? "" : "\n") + "Features: " + QString::fromStdString(claims.featureList());
+    QLabel *claimsLabel = new QLabel(details);
+    claimsLabel->setAlignment(Qt::AlignCenter);
+    claimsLabel->setVisible(!details.isEmpty());
+
     QPushButton *button = new QPushButton("Increment Counter");
     QLabel *counterLabel = new QLabel("Counter: 0");
     counterLabel->setAlignment(Qt::AlignCenter);
@@ -41,6 +70,7 @@ void startMainApplication() {
     });
 
     layout->addWidget(label);
+    layout->addWidget(claimsLabel);
     layout->addWidget(button);
     layout->addWidget(counterLabel);
 
@@ -50,128 +80,374 @@ void startMainApplication() {
 }
 
 /**
- * @brief Application entry point.
+ * @brief Loads the license verification key.
  *
- * This function:
- * - Retrieves the local hardware fingerprint
- * - Checks for the presence of a license file
- * - If license is missing, creates `hardware_id.txt` for license request
- * - Reads and validates the license file
- * - Compares hardware fingerprints
- * - Verifies digital signature using the public key
- * - Launches the main application if verification passes
+ * Prefers the key compiled into the binary (configured with
+ * `-DCRYPTOBRANCH_EMBEDDED_PUBLIC_KEY=<public_key.pem>`) and falls back to
+ * `public_key.pem`.
+ * Licenses signed with an older or newer key (selected by their `kid`) stay
+ * valid during a key rotation: an embedded key brings its rotation keys with it
+ * (`CRYPTOBRANCH_EMBEDDED_ROTATION_KEYS`), and files on disk are not trusted
+ * then. Otherwise every `*.pem` in `public_keys/` is added to the keyring.
  *
- * @param argc Argument count
- * @param argv Argument values
- * @return int Application exit code
+ * @param verifier Verifier that receives the key.
+ * @return true if a key was loaded.
  */
-int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
+static bool loadVerificationKey(LicenseVerifier &verifier) {
+#ifdef CRYPTOBRANCH_EMBEDDED_PUBLIC_KEY
+    if (verifier.loadPublicKeyFromMemory(EmbeddedPublicKeyPem, sizeof(EmbeddedPublicKeyPem) - 1)) {
+        for (const char *const *pem = EmbeddedRotationKeyPems; *pem; ++pem) {
+            if (!verifier.addPublicKeyFromMemory(*pem, std::strlen(*pem)))
+                qCWarning(lcLicense) << "Ignoring unreadable embedded rotation key";
+        }
+        // Keys placed next to the binary are never trusted for licenses or revocation lists
+        return true;
+    }
+#endif
+    if (QFile::exists("public_key.pem"))
+        verifier.loadPublicKey("public_key.pem");
+
+    const QFileInfoList rotationKeys = QDir("public_keys").entryInfoList(QStringList() << "*.pem", QDir::Files, QDir::Name);
+    for (const QFileInfo &key : rotationKeys) {
+        if (!verifier.addPublicKey(key.filePath().toStdString()))
+            qCWarning(lcLicense) << "Ignoring unreadable public key" << key.fileName();
+    }
+    return verifier.isLoaded();
+}
+
+/**
+ * @brief Explains a failed license check to the user.
+ * @param result Failed validation result.
+ * @param localFingerprint Local hardware fingerprint.
+ */
+static void showLicenseError(const LicenseValidator::Result &result, const QString &localFingerprint) {
+    switch (result.status) {
+    case LicenseValidator::Status::Valid:
+        break;
+    case LicenseValidator::Status::Missing:
+        QMessageBox::critical(nullptr, "License Required", "license.lic file not found.");
+        break;
+    case LicenseValidator::Status::Unreadable:
+        QMessageBox::critical(nullptr, "Error", "Could not open license file.");
+        break;
+    case LicenseValidator::Status::Malformed:
+        QMessageBox::critical(nullptr, "Invalid License",
+                              QString("License file could not be parsed.\nError: %1").arg(result.detail));
+        break;
+    case LicenseValidator::Status::MissingFields:
+        QMessageBox::critical(nullptr, "Invalid License",
+                              "License file is missing hardwareFingerprint or signature.\n\n"
+                              "Required fields:\n"
+                              "- hardwareFingerprint\n"
+                              "- signature");
+        break;
+    case LicenseValidator::Status::FingerprintMismatch:
+        QMessageBox::critical(nullptr, "Hardware Fingerprint Mismatch",
+                              QString("This license is not valid for this machine.\n\n"
+                                      "Local Hardware Fingerprint:\n%1\n\n"
+                                      "License Hardware Fingerprint:\n%2\n\n"
+                                      "Please use the correct license file or request a new license.")
+                                  .arg(localFingerprint, result.license.fingerprintString()));
+        break;
+    case LicenseValidator::Status::InvalidSignature:
+        QMessageBox::critical(nullptr, "Invalid License",
+                              "Signature could not be verified.\n\n"
+                              "Possible reasons:\n"
+                              "- Corrupted license file\n"
+                              "- Incorrect public key\n"
+                              "- License not valid for this machine\n\n"
+                              "Please use a valid license file.");
+        break;
+    case LicenseValidator::Status::Expired:
+        QMessageBox::critical(nullptr, "License Expired",
+                              QString("The license for this machine expired on %1.\n\n"
+                                      "Please request a renewed license.")
+                                  .arg(QLocale().toString(QDateTime::fromSecsSinceEpoch(result.license.claims.expiresAt),
+                                                          QLocale::ShortFormat)));
+        break;
+    case LicenseValidator::Status::Revoked:
+        QMessageBox::critical(nullptr, "License Revoked",
+                              "The license for this machine has been revoked.\n\n"
+                              "Please contact technical support.");
+        break;
+    case LicenseValidator::Status::RevocationUnavailable:
+        QMessageBox::critical(nullptr, "Revocation List Missing",
+                              "The revocation list (revocations.lst) is missing, damaged or older than\n"
+                              "the one previously installed on this machine.\n\n"
+                              "Please restore the current list or contact technical support.");
+        break;
+    }
+}
+
+/**
+ * @brief Returns the license to check.
+ *
+ * `license.lic` next to the executable takes precedence, so a compiled-in
+ * license (CRYPTOBRANCH_EMBEDDED_LICENSE) can be replaced in the field.
+ *
+ * @return `license.lic`, or the embedded license resource if there is no file.
+ */
+static QString licensePath() {
+#ifdef CRYPTOBRANCH_EMBEDDED_LICENSE
+    if (!QFile::exists("license.lic") && QFile::exists(":/license.lic"))
+        return ":/license.lic";
+#endif
+    return "license.lic";
+}
+
+/**
+ * @brief Outcome of the start-up work done off the GUI thread.
+ */
+struct StartupResult {
+    /// What the GUI thread has to do next.
+    enum class Outcome { Verified, LicenseRequired, KeyMissing };
+
+    Outcome outcome = Outcome::Verified; ///< Next step
+    QString fingerprint;                 ///< Local hardware fingerprint
+    QString licensePath;                 ///< License that was checked (file or embedded resource)
+    LicenseValidator::Result validation; ///< License check (Outcome::Verified only)
+};
+
+/**
+ * @brief Runs the blocking part of start-up; executed on a QThreadPool worker.
+ *
+ * Probes (or loads the cached) fingerprint, activates online if needed,
+ * loads the public key into @p verifier and validates the license. Nothing
+ * here touches widgets; the GUI thread reacts to the returned result.
+ *
+ * @param verifier Receives the public key; owned by the GUI thread, which
+ *                 only reads it after this function has returned.
+ * @return Fingerprint and outcome.
+ */
+static StartupResult runStartup(LicenseVerifier &verifier) {
+    StartupResult startup;
+    StartupTrace::Scope trace("startup.worker");
 
     // Debug file existence check
-    qDebug() << "Hardware ID file exists:" << QFile::exists("hardware_id.txt");
-    qDebug() << "Public key file exists:" << QFile::exists("public_key.pem");
-    qDebug() << "License file exists:" << QFile::exists("license.lic");
+    qCDebug(lcStartup) << "Hardware ID file exists:" << QFile::exists("hardware_id.txt");
+    qCDebug(lcStartup) << "Public key file exists:" << QFile::exists("public_key.pem");
+    qCDebug(lcStartup) << "License file exists:" << QFile::exists("license.lic");
 
-    // Get the current machine's hardware fingerprint
-    QString localFingerprint = QString::fromStdString(HardwareLock::getHardwareFingerprint());
-    qDebug() << "Local Hardware Fingerprint:" << localFingerprint;
+    // Get the current machine's hardware fingerprint, skipping the probes when the cache is valid
+    const QString fingerprintCachePath = "fingerprint.cache";
+    bool fingerprintFromCache = false;
+    {
+        StartupTrace::Scope fingerprintTrace("fingerprint");
+        startup.fingerprint = QString::fromStdString(
+            FingerprintCache::getFingerprint(fingerprintCachePath, FingerprintCache::maxAgeFromEnvironment(), &fingerprintFromCache));
+    }
+    qCDebug(lcProbe) << "Local Hardware Fingerprint:" << startup.fingerprint << (fingerprintFromCache ? "(cached)" : "(probed)");
 
-    // License file check
-    QFile licenseFile("license.lic");
-    if (!licenseFile.exists()) {
+    // Load the public key once: the compiled-in key if present, otherwise public_key.pem
+    bool keyLoaded = false;
+    {
+        StartupTrace::Scope keyTrace("key.load");
+        keyLoaded = loadVerificationKey(verifier);
+    }
+
+    // License requests carry the per-component hashes, so the license survives a single hardware change.
+    // Licenses are only issued for all three; a machine with a constant component gets an exact-match license.
+    LicenseClaims::ComponentHashes components;
+    const LicenseClaims::ComponentHashes *requestComponents = nullptr;
+    if (!QFile::exists(licensePath())) {
+        LicenseClaims requested;
+        requested.components = HardwareLock::getComponentHashes(startup.fingerprint.toStdString());
+        if (requested.hasAllComponents()) {
+            components = requested.components;
+            requestComponents = &components;
+        }
+    }
+
+    // Online activation: fetch, verify and store a license from the issuance service
+    const QUrl activationUrl = LicenseActivator::serverUrlFromEnvironment();
+    if (!QFile::exists(licensePath()) && !activationUrl.isEmpty()) {
+        qCInfo(lcLicense) << "license.lic not found, activating online at" << activationUrl.toString();
+        StartupTrace::Scope activationTrace("activation");
+        LicenseActivator::Options activationOptions;
+        activationOptions.serverUrl = activationUrl;
+        activationOptions.token = LicenseActivator::tokenFromEnvironment();
+        LicenseActivator activator(activationOptions);
+        QString activationError;
+        if (!activator.activate(startup.fingerprint.toStdString(), verifier, "license.lic", &activationError,
+                                requestComponents)) {
+            qCWarning(lcLicense) << "Online activation failed:" << activationError;
+        }
+    }
+
+    startup.licensePath = licensePath();
+    if (!QFile::exists(startup.licensePath)) {
         // Create hardware ID file for license request
         QFile out("hardware_id.txt");
         if (out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
             QTextStream stream(&out);
-            stream << localFingerprint << "\n";
+            stream << startup.fingerprint << " "
+                   << QString::fromStdString(LicenseClaims::componentList(components)) << "\n";
             out.close();
-            qDebug() << "Hardware ID file created:" << localFingerprint;
+            qCDebug(lcProbe) << "Hardware ID file created:" << startup.fingerprint;
         }
+        startup.outcome = StartupResult::Outcome::LicenseRequired;
+        return startup;
+    }
 
-        QMessageBox::information(nullptr, "License Required",
-                                 QString("license.lic file not found.\n\n"
-                                         "hardware_id.txt file has been created.\n"
-                                         "Send this file to technical support to request a license.\n\n"
-                                         "Hardware Fingerprint:\n%1").arg(localFingerprint));
-        return 1;
+    if (!keyLoaded && !QFile::exists("public_key.pem")) {
+        startup.outcome = StartupResult::Outcome::KeyMissing;
+        return startup;
     }
 
-    // Read license file
-    QFile file("license.lic");
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(nullptr, "Error", "Could not open license file.");
-        return 1;
+    // Revocation updates delivered next to the license are applied before the check
+    QFile delta("revocations.delta");
+    if (delta.open(QIODevice::ReadOnly)) {
+        QByteArray update = delta.readAll();
+        delta.close();
+        if (RevocationChecker::applyUpdate("revocations.lst", update, verifier))
+            delta.remove();
     }
 
-    QByteArray jsonData = file.readAll();
-    file.close();
+    // Parse the license, then check fingerprint, signature, expiry and revocation
+    startup.validation = LicenseValidator::validate(startup.licensePath, startup.fingerprint, verifier, "revocations.lst");
 
-    // Parse JSON
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
-    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
-        QMessageBox::critical(nullptr, "Invalid License",
-                              QString("License file is not valid JSON.\nError: %1").arg(parseError.errorString()));
-        return 1;
+    // A cached fingerprint may predate a hardware change; re-probe before rejecting
+    if (startup.validation.status == LicenseValidator::Status::FingerprintMismatch && fingerprintFromCache) {
+        qCInfo(lcProbe) << "Cached fingerprint does not match license, re-probing hardware";
+        startup.fingerprint = QString::fromStdString(FingerprintCache::refresh(fingerprintCachePath));
+        startup.validation = LicenseValidator::validate(startup.licensePath, startup.fingerprint, verifier, "revocations.lst");
     }
 
-    QJsonObject obj = doc.object();
-    QString licenseFingerprint = obj["hardwareFingerprint"].toString();
-    QString signature = obj["signature"].toString();
+    // Licenses with component hashes tolerate a change of some components (e.g. a replaced network card)
+    if (startup.validation.status == LicenseValidator::Status::FingerprintMismatch &&
+        startup.validation.license.claims.hasComponents()) {
+        components = HardwareLock::getComponentHashes(startup.validation.license.fingerprintString().toStdString());
+        startup.validation = LicenseValidator::validate(startup.licensePath, startup.fingerprint, verifier,
+                                                        "revocations.lst", &components);
+        if (startup.validation.status != LicenseValidator::Status::FingerprintMismatch) {
+            const LicenseClaims &claims = startup.validation.license.claims;
+            qCInfo(lcProbe) << "License accepted on" << claims.matchingComponents(components) << "of"
+                            << claims.effectiveRequiredMatches() << "required hardware components";
+            // Later checks (LicenseMonitor) compare against the licensed fingerprint. The cache keeps
+            // this machine's own probe results, so the next launch repeats the component check.
+            startup.fingerprint = startup.validation.license.fingerprintString();
+        }
+    }
 
-    // Backward compatibility with older "hardwareId" field
-    if (licenseFingerprint.isEmpty()) {
-        licenseFingerprint = obj["hardwareId"].toString();
+    // Licenses issued before native probing are bound to the first adapter Qt listed and the old disk source
+    if (startup.validation.status == LicenseValidator::Status::FingerprintMismatch &&
+        !startup.validation.license.claims.hasComponents()) {
+        QString legacyFingerprint = QString::fromStdString(HardwareLock::getLegacyHardwareFingerprint());
+        if (legacyFingerprint == startup.validation.license.fingerprintString()) {
+            qCInfo(lcProbe) << "License matches the legacy hardware probes";
+            startup.fingerprint = legacyFingerprint;
+            FingerprintCache::refresh(fingerprintCachePath, true);
+            startup.validation = LicenseValidator::validate(startup.licensePath, startup.fingerprint, verifier, "revocations.lst");
+        }
     }
 
-    qDebug() << "License Hardware Fingerprint:" << licenseFingerprint;
-    qDebug() << "Signature length:" << signature.length();
+    qCDebug(lcProbe) << "License Hardware Fingerprint:" << startup.validation.license.fingerprintString();
+    if (startup.validation.license.claims.expiresAt != 0)
+        qCDebug(lcLicense) << "License expires at:"
+                 << QDateTime::fromSecsSinceEpoch(startup.validation.license.claims.expiresAt).toString(Qt::ISODate);
+    return startup;
+}
 
-    // Missing value check
-    if (licenseFingerprint.isEmpty() || signature.isEmpty()) {
-        QMessageBox::critical(nullptr, "Invalid License",
-                              "License file is missing hardwareFingerprint or signature.\n\n"
-                              "Required fields:\n"
-                              "- hardwareFingerprint\n"
-                              "- signature");
-        return 1;
-    }
+/**
+ * @brief Creates the splash screen shown while start-up runs.
+ * @return Splash screen; deletes itself when closed.
+ */
+static QSplashScreen *createSplashScreen() {
+    QPixmap pixmap(400, 200);
+    pixmap.fill(QColor(0xF0, 0xF0, 0xF0));
+    QSplashScreen *splash = new QSplashScreen(pixmap);
+    splash->setAttribute(Qt::WA_DeleteOnClose);
+    splash->showMessage("CryptoBranch\n\nVerifying license...", Qt::AlignCenter, Qt::black);
+    return splash;
+}
 
-    // Hardware fingerprint match check
-    if (localFingerprint != licenseFingerprint) {
-        QMessageBox::critical(nullptr, "Hardware Fingerprint Mismatch",
-                              QString("This license is not valid for this machine.\n\n"
-                                      "Local Hardware Fingerprint:\n%1\n\n"
-                                      "License Hardware Fingerprint:\n%2\n\n"
-                                      "Please use the correct license file or request a new license.")
-                                  .arg(localFingerprint, licenseFingerprint));
-        return 1;
-    }
+/**
+ * @brief Application entry point.
+ *
+ * A splash screen is painted before any slow work starts. On a worker thread
+ * the application then:
+ * - Retrieves the local hardware fingerprint (from `fingerprint.cache` when valid)
+ * - Checks for the presence of a license file
+ * - If license is missing, activates online when `CRYPTOBRANCH_ACTIVATION_URL` is set,
+ *   otherwise creates `hardware_id.txt` for license request
+ * - Reads and validates the license file (JSON or compact binary)
+ * - Compares hardware fingerprints
+ * - Verifies digital signature over fingerprint and claims using the public key
+ *   (embedded or `public_key.pem`) and rejects expired licenses
+ * - Rejects licenses listed in the signed revocation list (`revocations.lst`),
+ *   applying a pending `revocations.delta` first
+ *
+ * Back on the GUI thread it replaces the splash screen with the main
+ * application (and keeps re-validating it in the background, see
+ * LicenseMonitor) or with the matching error dialog.
+ *
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return int Application exit code
+ */
+int main(int argc, char *argv[]) {
+    StartupTrace::initialize();
+    QApplication app(argc, argv);
 
-    qDebug() << "Hardware fingerprint matched, verifying signature...";
+    // First paint before any probing, key parsing or file I/O
+    QSplashScreen *splash = createSplashScreen();
+    splash->show();
+    app.processEvents();
+    StartupTrace::instant("ui.splash");
 
-    // Public key existence check
-    if (!QFile::exists("public_key.pem")) {
-        QMessageBox::critical(nullptr, "Error", "public_key.pem file not found.");
-        return 1;
-    }
+    // Dialogs and the splash screen come and go during start-up; the exit code is set explicitly
+    app.setQuitOnLastWindowClosed(false);
 
-    // Signature verification
-    if (HardwareLock::verifyLicense(localFingerprint.toStdString(), signature.toStdString(), "public_key.pem")) {
-        qDebug() << "License verification successful!";
-        startMainApplication();
-        return app.exec();
-    } else {
-        qDebug() << "Signature verification failed!";
-        QMessageBox::critical(nullptr, "Invalid License",
-                              "Signature could not be verified.\n\n"
-                              "Possible reasons:\n"
-                              "- Corrupted license file\n"
-                              "- Incorrect public key\n"
-                              "- License not valid for this machine\n"
-                              "- License expired\n\n"
-                              "Please use a valid license file.");
-        return 1;
-    }
+    LicenseVerifier verifier;
+    std::unique_ptr<LicenseMonitor> monitor;
+    QFutureWatcher<StartupResult> startup;
+
+    QObject::connect(&startup, &QFutureWatcherBase::finished, [&]() {
+        const StartupResult result = startup.result();
+        splash->close();
+        StartupTrace::instant("startup.done");
+        StartupTrace::finish();
+
+        if (result.outcome == StartupResult::Outcome::LicenseRequired) {
+            QMessageBox::information(nullptr, "License Required",
+                                     QString("license.lic file not found.\n\n"
+                                             "hardware_id.txt file has been created.\n"
+                                             "Send this file to technical support to request a license.\n\n"
+                                             "Hardware Fingerprint:\n%1").arg(result.fingerprint));
+            QApplication::exit(1);
+            return;
+        }
+        if (result.outcome == StartupResult::Outcome::KeyMissing) {
+            QMessageBox::critical(nullptr, "Error", "public_key.pem file not found.");
+            QApplication::exit(1);
+            return;
+        }
+        if (result.validation.status != LicenseValidator::Status::Valid) {
+            qCWarning(lcLicense) << "License verification failed with status" << static_cast<int>(result.validation.status);
+            showLicenseError(result.validation, result.fingerprint);
+            QApplication::exit(1);
+            return;
+        }
+
+        qCDebug(lcLicense) << "License verification successful!";
+        startMainApplication(result.validation.license.claims);
+        app.setQuitOnLastWindowClosed(true);
+
+        // Keep checking expiry, revocation and the license file while the application runs
+        LicenseMonitor::Options monitorOptions;
+        monitorOptions.serverUrl = LicenseActivator::serverUrlFromEnvironment();
+        monitorOptions.intervalSeconds = LicenseMonitor::intervalFromEnvironment();
+        monitorOptions.licensePath = result.licensePath;
+        monitor.reset(new LicenseMonitor(result.fingerprint, verifier, monitorOptions));
+        const QString fingerprint = result.fingerprint;
+        monitor->start(result.validation.license.claims.expiresAt, [fingerprint](const LicenseValidator::Result &failed) {
+            showLicenseError(failed, fingerprint);
+            QApplication::exit(1);
+        });
+    });
+
+    startup.setFuture(QtConcurrent::run([&verifier]() { return runStartup(verifier); }));
+    int exitCode = app.exec();
+    startup.waitForFinished();
+    return exitCode;
 }
@@ -0,0 +1,237 @@
+#include "probescheduler.h"
+#include "clientlog.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+
+std::atomic<qint64> ProbeScheduler::s_deadlineMs{0};
+
+/**
+ * @brief Timeout history of one probe command.
+ */
+struct CommandRecord {
+    int strikes = 0;         ///< Launches on which the command ran past CommandLimitMs
+    qint64 lastTimeout = 0;  ///< Unix time of the last strike
+    bool answered = false;   ///< The command produced an answer on some launch
+};
+
+/**
+ * @brief Known-bad commands and where they are stored.
+ *
+ * Loaded on first use; guarded by a mutex because probes run concurrently.
+ */
+struct KnownBadState {
+    std::mutex mutex;                             ///< Guards all members
+    QString path = "probe_timeouts.json";         ///< Persistent copy; empty = memory only
+    bool loaded = false;                          ///< true once path has been read
+    std::map<std::string, CommandRecord> records; ///< Command -> timeout history
+    std::set<std::string> struckThisLaunch;       ///< Commands that already got a strike in this process
+};
+
+/**
+ * @brief Returns the process-wide known-bad state.
+ * @return Shared state.
+ */
+static KnownBadState &knownBadState() {
+    static KnownBadState state;
+    return state;
+}
+
+/**
+ * @brief Reads the stored list once; the caller holds the state mutex.
+ *
+ * Entries of the first format (a bare timestamp per command) are dropped:
+ * they recorded single timeouts, which no longer make a command known-bad.
+ *
+ * @param state Shared state.
+ */
+static void loadKnownBad(KnownBadState &state) {
+    if (state.loaded)
+        return;
+    state.loaded = true;
+
+    QFile file(state.path);
+    if (state.path.isEmpty() || !file.open(QIODevice::ReadOnly))
+        return;
+    const QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = obj.begin(); it != obj.end(); ++it) {
+        if (!it.value().isObject())
+            continue;
+        const QJsonObject entry = it.value().toObject();
+        CommandRecord &record = state.records[it.key().toStdString()];
+        record.strikes = entry["strikes"].toInt();
+        record.lastTimeout = static_cast<qint64>(entry["lastTimeout"].toDouble());
+        record.answered = entry["answered"].toBool();
+    }
+}
+
+/**
+ * @brief Writes the list; the caller holds the state mutex.
+ *
+ * Strikes older than KnownBadSeconds are dropped; commands that answered are
+ * kept so that they stay exempt.
+ *
+ * @param state Shared state.
+ */
+static void saveKnownBad(KnownBadState &state) {
+    if (state.path.isEmpty())
+        return;
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    QJsonObject obj;
+    for (auto it = state.records.begin(); it != state.records.end();) {
+        const bool expired = now - it->second.lastTimeout >= ProbeScheduler::KnownBadSeconds;
+        if (expired && !it->second.answered) {
+            it = state.records.erase(it);
+            continue;
+        }
+        QJsonObject entry;
+        entry["strikes"] = expired ? 0 : it->second.strikes;
+        entry["lastTimeout"] = static_cast<double>(it->second.lastTimeout);
+        entry["answered"] = it->second.answered;
+        obj.insert(QString::fromStdString(it->first), entry);
+        ++it;
+    }
+    QSaveFile file(state.path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+/**
+ * @brief Starts a budget.
+ * @param budgetMs Time allowed for all probes, in milliseconds.
+ */
+ProbeScheduler::Budget::Budget(qint64 budgetMs) : m_owner(false) {
+    qint64 none = 0;
+    m_owner = s_deadlineMs.compare_exchange_strong(none, nowMs() + budgetMs);
+}
+
+/**
+ * @brief Ends the budget if this object started it.
+ */
+ProbeScheduler::Budget::~Budget() {
+    if (m_owner)
+        s_deadlineMs.store(0);
+}
+
+/**
+ * @brief Returns a monotonic clock reading.
+ * @return Milliseconds since an arbitrary epoch.
+ */
+qint64 ProbeScheduler::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Returns the time a command started now may run.
+ * @return Milliseconds until the shared deadline (0 if it has passed), or
+ *         DefaultBudgetMs if no budget is active.
+ */
+qint64 ProbeScheduler::remainingMs() {
+    const qint64 deadline = s_deadlineMs.load();
+    if (deadline == 0)
+        return DefaultBudgetMs;
+    return qMax<qint64>(0, deadline - nowMs());
+}
+
+/**
+ * @brief Checks whether a command is known to hang.
+ * @param command Command line as passed to executeCommand().
+ * @return true if the command should be skipped.
+ */
+bool ProbeScheduler::isKnownBad(const std::string &command) {
+    KnownBadState &state = knownBadState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    loadKnownBad(state);
+
+    auto it = state.records.find(command);
+    if (it == state.records.end() || it->second.answered || it->second.strikes < KnownBadStrikes)
+        return false;
+    const qint64 age = QDateTime::currentSecsSinceEpoch() - it->second.lastTimeout;
+    return age >= 0 && age < KnownBadSeconds;
+}
+
+/**
+ * @brief Records that a command ran past CommandLimitMs and was killed.
+ *
+ * Strikes expire with KnownBadSeconds, so only a command that keeps hanging
+ * launch after launch becomes known-bad.
+ *
+ * @param command Command line as passed to executeCommand().
+ */
+void ProbeScheduler::recordTimeout(const std::string &command) {
+    KnownBadState &state = knownBadState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    loadKnownBad(state);
+
+    if (!state.struckThisLaunch.insert(command).second)
+        return;
+    CommandRecord &record = state.records[command];
+    if (record.answered)
+        return;
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    if (now - record.lastTimeout >= KnownBadSeconds)
+        record.strikes = 0;
+    ++record.strikes;
+    record.lastTimeout = now;
+    if (record.strikes >= KnownBadStrikes)
+        qCWarning(lcProbe) << "Probe command keeps timing out, skipping it for" << KnownBadSeconds / 3600 << "hours:"
+                           << QString::fromStdString(command);
+    saveKnownBad(state);
+}
+
+/**
+ * @brief Records that a command produced an answer, which exempts it from being skipped.
+ *
+ * The list is only rewritten the first time a command answers.
+ *
+ * @param command Command line as passed to executeCommand().
+ */
+void ProbeScheduler::recordAnswer(const std::string &command) {
+    KnownBadState &state = knownBadState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    loadKnownBad(state);
+
+    CommandRecord &record = state.records[command];
+    if (record.answered)
+        return;
+    record.answered = true;
+    record.strikes = 0;
+    saveKnownBad(state);
+}
+
+/**
+ * @brief Reads the budget from `CRYPTOBRANCH_PROBE_BUDGET_MS`.
+ * @return Budget in milliseconds, or DefaultBudgetMs if the variable is unset or invalid.
+ */
+qint64 ProbeScheduler::budgetFromEnvironment() {
+    bool ok = false;
+    qint64 value = qEnvironmentVariable("CRYPTOBRANCH_PROBE_BUDGET_MS").toLongLong(&ok);
+    return (ok && value > 0) ? value : DefaultBudgetMs;
+}
+
+/**
+ * @brief Changes the file that stores timed-out commands.
+ * @param path Path of the file (default: `probe_timeouts.json`); empty disables persistence.
+ */
+void ProbeScheduler::setStatePath(const QString &path) {
+    KnownBadState &state = knownBadState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.path = path;
+    state.loaded = false;
+    state.records.clear();
+    state.struckThisLaunch.clear();
+}
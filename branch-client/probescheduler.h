@@ -0,0 +1,119 @@
+#ifndef PROBESCHEDULER_H
+#define PROBESCHEDULER_H
+
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+#include <string>
+
+/**
+ * @brief Global time budget and known-bad list for command based hardware probes.
+ *
+ * A Budget spans one fingerprint computation: every command started by
+ * HardwareLock::executeCommand() while it is active must finish before the
+ * shared deadline, so all fallbacks together can no longer take more than
+ * the budget (`CRYPTOBRANCH_PROBE_BUDGET_MS`, default DefaultBudgetMs).
+ *
+ * Commands that run past CommandLimitMs on their own and are then killed get
+ * a strike in `probe_timeouts.json`; running into the shared deadline earlier
+ * is never held against a command. A command that collected KnownBadStrikes on
+ * separate launches, and never answered on any launch, is skipped for
+ * KnownBadSeconds so that a broken tool (e.g. a hanging `wmic`) stops costing
+ * its timeout on every start. A command that answered once is never skipped:
+ * a transient stall (a slow cold boot) must not change which source decides
+ * the fingerprint.
+ */
+class ProbeScheduler {
+public:
+    /// Default budget for one fingerprint computation in milliseconds.
+    static constexpr qint64 DefaultBudgetMs = 5000;
+
+    /// How long a known-bad command is skipped after its last strike, in seconds (7 days).
+    static constexpr qint64 KnownBadSeconds = 7 * 24 * 60 * 60;
+
+    /// Run time of a single command after which a kill counts as a strike against it.
+    static constexpr qint64 CommandLimitMs = 4000;
+
+    /// Strikes, each on a different launch, before a command that never answered is skipped.
+    static constexpr int KnownBadStrikes = 3;
+
+    /**
+     * @brief Sets the shared deadline for the lifetime of the object.
+     *
+     * Nested budgets (e.g. the legacy fingerprint inside a fingerprint
+     * computation) keep the outer deadline.
+     */
+    class Budget {
+    public:
+        /**
+         * @brief Starts a budget.
+         * @param budgetMs Time allowed for all probes, in milliseconds.
+         */
+        explicit Budget(qint64 budgetMs = budgetFromEnvironment());
+
+        /**
+         * @brief Ends the budget if this object started it.
+         */
+        ~Budget();
+
+        Budget(const Budget &) = delete;
+        Budget &operator=(const Budget &) = delete;
+
+    private:
+        bool m_owner; ///< true if this budget set the deadline
+    };
+
+    /**
+     * @brief Returns the time a command started now may run.
+     * @return Milliseconds until the shared deadline (0 if it has passed), or
+     *         DefaultBudgetMs if no budget is active.
+     */
+    static qint64 remainingMs();
+
+    /**
+     * @brief Checks whether a command is known to hang.
+     * @param command Command line as passed to executeCommand().
+     * @return true if the command never answered and timed out on KnownBadStrikes
+     *         launches, the last one less than KnownBadSeconds ago.
+     */
+    static bool isKnownBad(const std::string &command);
+
+    /**
+     * @brief Records that a command ran past CommandLimitMs and was killed.
+     *
+     * Counts at most one strike per command and launch.
+     *
+     * @param command Command line as passed to executeCommand().
+     */
+    static void recordTimeout(const std::string &command);
+
+    /**
+     * @brief Records that a command produced an answer, which exempts it from being skipped.
+     * @param command Command line as passed to executeCommand().
+     */
+    static void recordAnswer(const std::string &command);
+
+    /**
+     * @brief Reads the budget from `CRYPTOBRANCH_PROBE_BUDGET_MS`.
+     * @return Budget in milliseconds, or DefaultBudgetMs if the variable is unset or invalid.
+     */
+    static qint64 budgetFromEnvironment();
+
+    /**
+     * @brief Changes the file that stores timed-out commands.
+     * @param path Path of the file (default: `probe_timeouts.json`); empty disables persistence.
+     */
+    static void setStatePath(const QString &path);
+
+private:
+    /**
+     * @brief Returns a monotonic clock reading.
+     * @return Milliseconds since an arbitrary epoch.
+     */
+    static qint64 nowMs();
+
+    static std::atomic<qint64> s_deadlineMs; ///< Shared deadline; 0 when no budget is active
+};
+
+#endif // PROBESCHEDULER_H
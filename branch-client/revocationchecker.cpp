@@ -0,0 +1,147 @@
+#include "revocationchecker.h"
+#include "clientlog.h"
+#include "licenseverifier.h"
+#include "revocationstate.h"
+
+#include <QDebug>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <string>
+
+/**
+ * @brief Checks the signature of a parsed list.
+ * @param view Parsed list.
+ * @param verifier Verifier holding the license public key.
+ * @return true if the list was signed with one of the license keys.
+ */
+static bool verifyList(const RevocationList::View &view, const LicenseVerifier &verifier)
+{
+    return verifier.verifyRawWithAnyKey(RevocationList::signingPayload(view.signedData), reinterpret_cast<const unsigned char *>(view.signature.data()),
+                                        view.signature.size());
+}
+
+RevocationChecker::RevocationChecker() : m_loaded(false) {}
+
+/**
+ * @brief Maps and verifies a revocation list.
+ * @param listPath Path of the list file.
+ * @param verifier Verifier holding the license public key.
+ * @return true if a correctly signed list was loaded.
+ */
+bool RevocationChecker::load(const QString &listPath, const LicenseVerifier &verifier)
+{
+    m_loaded = false;
+    m_file.close();
+    m_data.clear();
+    m_file.setFileName(listPath);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    const char *data = nullptr;
+    qint64 size = m_file.size();
+    if (uchar *mapped = size > 0 ? m_file.map(0, size) : nullptr) {
+        data = reinterpret_cast<const char *>(mapped);
+    } else {
+        m_data = m_file.readAll();
+        data = m_data.constData();
+        size = m_data.size();
+    }
+
+    if (!RevocationList::parse(data, static_cast<std::size_t>(size), m_view) || !verifyList(m_view, verifier)) {
+        qCWarning(lcLicense) << "Revocation list" << listPath << "is invalid or not signed with the license key";
+        return false;
+    }
+    m_loaded = true;
+    return true;
+}
+
+/**
+ * @brief Checks whether a list is loaded.
+ * @return true after a successful load().
+ */
+bool RevocationChecker::isLoaded() const
+{
+    return m_loaded;
+}
+
+/**
+ * @brief Returns the sequence number of the loaded list.
+ * @return Sequence, or 0 if no list is loaded.
+ */
+quint64 RevocationChecker::sequence() const
+{
+    return m_loaded ? m_view.sequence : 0;
+}
+
+/**
+ * @brief Checks whether a fingerprint has been revoked.
+ * @param fingerprint Hardware fingerprint.
+ * @return true if the loaded list contains @p fingerprint.
+ */
+bool RevocationChecker::isRevoked(std::string_view fingerprint) const
+{
+    return m_loaded && RevocationList::contains(m_view, RevocationList::hashFingerprint(fingerprint));
+}
+
+/**
+ * @brief Replaces the list file with a verified update.
+ *
+ * The result must be newer than both the current file and the highest
+ * sequence recorded in RevocationState, so a deleted list cannot be
+ * replaced by an older one; the new sequence is recorded on success.
+ *
+ * @param listPath Path of the list file.
+ * @param update Full list or delta bytes.
+ * @param verifier Verifier holding the license public key.
+ * @return true if the file was replaced.
+ */
+bool RevocationChecker::applyUpdate(const QString &listPath, const QByteArray &update, const LicenseVerifier &verifier)
+{
+    quint64 newest = 0;
+    if (!RevocationState::read(listPath, newest))
+        return false;
+
+    QByteArray current;
+    RevocationList::View currentView;
+    bool haveCurrent = false;
+    QFile currentFile(listPath);
+    if (currentFile.open(QIODevice::ReadOnly)) {
+        current = currentFile.readAll();
+        haveCurrent = RevocationList::parse(current.constData(), static_cast<std::size_t>(current.size()), currentView) &&
+                      verifyList(currentView, verifier);
+    }
+
+    QByteArray list;
+    RevocationList::DeltaView delta;
+    if (RevocationList::parseDelta(update.constData(), static_cast<std::size_t>(update.size()), delta)) {
+        std::string body;
+        if (!haveCurrent || !RevocationList::applyDelta(currentView, delta, body)) {
+            qCWarning(lcLicense) << "Revocation delta does not apply to the current list";
+            return false;
+        }
+        RevocationList::appendSignature(body, delta.signature);
+        list = QByteArray(body.data(), static_cast<int>(body.size()));
+    } else {
+        list = update;
+    }
+
+    RevocationList::View view;
+    if (!RevocationList::parse(list.constData(), static_cast<std::size_t>(list.size()), view) || !verifyList(view, verifier)) {
+        qCWarning(lcLicense) << "Revocation update is invalid or not signed with the license key";
+        return false;
+    }
+    if (haveCurrent)
+        newest = std::max<quint64>(newest, currentView.sequence);
+    if ((haveCurrent || RevocationState::exists(listPath)) && view.sequence <= newest) {
+        qCDebug(lcLicense) << "Ignoring revocation list" << view.sequence << "- not newer than" << newest;
+        return false;
+    }
+
+    QSaveFile file(listPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(list) != list.size() || !file.commit() ||
+        !RevocationState::record(listPath, view.sequence))
+        return false;
+    qCInfo(lcLicense) << "Revocation list updated to sequence" << view.sequence << "with" << view.count << "entries";
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef REVOCATIONCHECKER_H
+#define REVOCATIONCHECKER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <string_view>
+
+#include <revocationlist.h>
+
+class LicenseVerifier;
+
+/**
+ * @brief Checks the local fingerprint against the signed revocation list.
+ *
+ * The list file (`revocations.lst`) is memory-mapped and its signature is
+ * checked once with the license public key; each lookup is then a binary
+ * search over the mapped entries. Updates (a full list or a delta from the
+ * issuance service) are verified before they replace the file, and may not
+ * go back behind the newest list this machine has accepted (RevocationState).
+ */
+class RevocationChecker {
+public:
+    RevocationChecker();
+
+    /**
+     * @brief Maps and verifies a revocation list.
+     * @param listPath Path of the list file.
+     * @param verifier Verifier holding the license public key.
+     * @return true if a correctly signed list was loaded.
+     */
+    bool load(const QString &listPath, const LicenseVerifier &verifier);
+
+    /**
+     * @brief Checks whether a list is loaded.
+     * @return true after a successful load().
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief Returns the sequence number of the loaded list.
+     * @return Sequence, or 0 if no list is loaded.
+     */
+    quint64 sequence() const;
+
+    /**
+     * @brief Checks whether a fingerprint has been revoked.
+     * @param fingerprint Hardware fingerprint.
+     * @return true if the loaded list contains @p fingerprint.
+     */
+    bool isRevoked(std::string_view fingerprint) const;
+
+    /**
+     * @brief Replaces the list file with a verified update.
+     *
+     * @p update may be a full list or a delta that applies to the current
+     * file. The resulting list must be correctly signed and newer than the
+     * current one and than every list accepted before (RevocationState).
+     *
+     * @param listPath Path of the list file.
+     * @param update Full list or delta bytes.
+     * @param verifier Verifier holding the license public key.
+     * @return true if the file was replaced.
+     */
+    static bool applyUpdate(const QString &listPath, const QByteArray &update, const LicenseVerifier &verifier);
+
+private:
+    QFile m_file;                 ///< Mapped list file
+    QByteArray m_data;            ///< List contents when mapping is not possible
+    RevocationList::View m_view;  ///< View into the mapped list
+    bool m_loaded;                ///< true if m_view is valid
+};
+
+#endif // REVOCATIONCHECKER_H
@@ -0,0 +1,244 @@
+#include "revocationstate.h"
+#include "clientlog.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMessageAuthenticationCode>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QSysInfo>
+
+#include <openssl/rand.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <dpapi.h>
+#endif
+
+/// Format version of the state record.
+static const int StateVersion = 2;
+
+/// Application-specific salt mixed into the HMAC key.
+static const char StateKeySalt[] = "CryptoBranch/revocation-state/v1";
+
+/// Size of the sealing secret in bytes.
+static const int SealingKeySize = 32;
+
+#ifdef _WIN32
+/**
+ * @brief Seals or unseals data with DPAPI for the current user.
+ * @param data Plain secret (seal) or DPAPI blob (unseal).
+ * @param seal true to protect, false to unprotect.
+ * @return Result, or an empty array on failure.
+ */
+static QByteArray dpapi(const QByteArray &data, bool seal)
+{
+    DATA_BLOB in;
+    in.cbData = static_cast<DWORD>(data.size());
+    in.pbData = reinterpret_cast<BYTE *>(const_cast<char *>(data.constData()));
+    DATA_BLOB out = {};
+    BOOL ok = seal ? CryptProtectData(&in, L"CryptoBranch", nullptr, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &out)
+                   : CryptUnprotectData(&in, nullptr, nullptr, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &out);
+    if (!ok)
+        return QByteArray();
+    QByteArray result(reinterpret_cast<const char *>(out.pbData), static_cast<int>(out.cbData));
+    SecureZeroMemory(out.pbData, out.cbData);
+    LocalFree(out.pbData);
+    return result;
+}
+#endif
+
+/**
+ * @brief Returns the directory that holds the sealing key and the states.
+ * @return Application data directory of this user.
+ */
+static QString stateDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+}
+
+/**
+ * @brief Returns the path of the sealing secret.
+ * @return `revocation.key` in stateDirectory().
+ */
+static QString sealingKeyPath()
+{
+    return stateDirectory() + "/revocation.key";
+}
+
+/**
+ * @brief Identifies a list by its absolute path.
+ * @param listPath Path of the revocation list.
+ * @return First 16 HEX digits of the SHA-256 of the absolute path.
+ */
+static QByteArray listId(const QString &listPath)
+{
+    const QByteArray path = QFileInfo(listPath).absoluteFilePath().toUtf8();
+    return QCryptographicHash::hash(path, QCryptographicHash::Sha256).toHex().left(16);
+}
+
+/**
+ * @brief Returns the state file that belongs to a list.
+ *
+ * The state lives with the sealing key rather than next to the list, so
+ * deleting the list's directory contents does not reset it.
+ *
+ * @param listPath Path of the revocation list.
+ * @return `revocations-<hash of the absolute list path>.state` in the application data directory.
+ */
+QString RevocationState::statePath(const QString &listPath)
+{
+    return stateDirectory() + "/revocations-" + QString::fromLatin1(listId(listPath)) + ".state";
+}
+
+/**
+ * @brief Checks whether a list has been accepted on this machine before.
+ *
+ * The sealing key is only created when a list is recorded, so its presence
+ * alone proves that a list was seen even if the state file was deleted.
+ *
+ * @param listPath Path of the revocation list.
+ * @return true if its state file or the sealing key exists, valid or not.
+ */
+bool RevocationState::exists(const QString &listPath)
+{
+    return QFile::exists(statePath(listPath)) || QFile::exists(sealingKeyPath());
+}
+
+/**
+ * @brief Returns the installation's sealing secret, creating it on first use.
+ *
+ * The secret is read once per process; a mutex keeps the start-up check and
+ * the LicenseMonitor from creating two different secrets.
+ *
+ * @return 32 random bytes, or an empty array if the secret cannot be read or created.
+ */
+QByteArray RevocationState::sealingKey()
+{
+    static QMutex mutex;
+    static QByteArray key;
+    QMutexLocker locker(&mutex);
+    if (!key.isEmpty())
+        return key;
+
+    const QString directory = stateDirectory();
+    const QString path = sealingKeyPath();
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        QByteArray stored = file.readAll();
+#ifdef _WIN32
+        stored = dpapi(stored, false);
+#endif
+        if (stored.size() != SealingKeySize) {
+            qCWarning(lcLicense) << "Revocation state key" << path << "is unreadable";
+            return QByteArray();
+        }
+        key = stored;
+        return key;
+    }
+
+    QByteArray secret(SealingKeySize, '\0');
+    if (RAND_bytes(reinterpret_cast<unsigned char *>(secret.data()), SealingKeySize) != 1)
+        return QByteArray();
+    QByteArray stored = secret;
+#ifdef _WIN32
+    stored = dpapi(secret, true);
+    if (stored.isEmpty())
+        return QByteArray();
+#endif
+    QSaveFile out(path);
+    if (!QDir().mkpath(directory) || !out.open(QIODevice::WriteOnly) || out.write(stored) != stored.size() ||
+        !out.commit()) {
+        qCWarning(lcLicense) << "Could not create revocation state key" << path;
+        return QByteArray();
+    }
+    QFile::setPermissions(path, QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+    key = secret;
+    return key;
+}
+
+/**
+ * @brief Computes the HMAC that seals a state record.
+ * @param listPath Path of the revocation list the record belongs to.
+ * @param sequence Recorded sequence.
+ * @param machineId Machine ID the record is bound to.
+ * @return Hex-encoded HMAC-SHA256, or an empty array if no sealing key is available.
+ */
+QByteArray RevocationState::computeMac(const QString &listPath, quint64 sequence, const QByteArray &machineId)
+{
+    QByteArray secret = sealingKey();
+    if (secret.isEmpty())
+        return QByteArray();
+    QByteArray key = QCryptographicHash::hash(QByteArray(StateKeySalt) + secret + machineId, QCryptographicHash::Sha256);
+    QByteArray payload = QByteArray::number(StateVersion) + '|' + listId(listPath) + '|' +
+                         QByteArray::number(sequence) + '|' + machineId;
+    return QMessageAuthenticationCode::hash(payload, key, QCryptographicHash::Sha256).toHex();
+}
+
+/**
+ * @brief Reads the highest accepted sequence.
+ * @param listPath Path of the revocation list.
+ * @param sequence Receives the sequence, or 0 if no state exists.
+ * @return false if a state exists but is malformed or fails the integrity check.
+ */
+bool RevocationState::read(const QString &listPath, quint64 &sequence)
+{
+    sequence = 0;
+    QFile file(statePath(listPath));
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+    bool ok = false;
+    quint64 stored = obj["sequence"].toString().toULongLong(&ok);
+    QByteArray expected = computeMac(listPath, stored, QSysInfo::machineUniqueId());
+    if (!ok || obj["version"].toInt() != StateVersion || expected.isEmpty() ||
+        obj["mac"].toString().toLatin1() != expected) {
+        qCWarning(lcLicense) << "Revocation state" << file.fileName() << "failed its integrity check";
+        return false;
+    }
+    sequence = stored;
+    return true;
+}
+
+/**
+ * @brief Raises the highest accepted sequence; lower values are ignored.
+ * @param listPath Path of the revocation list.
+ * @param sequence Sequence of a list that was just accepted.
+ * @return true if the state holds at least @p sequence afterwards.
+ */
+bool RevocationState::record(const QString &listPath, quint64 sequence)
+{
+    // Start-up and the LicenseMonitor may record concurrently; the state must never go down
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    quint64 current = 0;
+    if (!read(listPath, current))
+        return false;
+    if (QFile::exists(statePath(listPath)) && current >= sequence)
+        return true;
+
+    QByteArray mac = computeMac(listPath, sequence, QSysInfo::machineUniqueId());
+    if (mac.isEmpty())
+        return false;
+    QJsonObject obj;
+    obj["version"] = StateVersion;
+    obj["sequence"] = QString::number(sequence); // JSON numbers lose precision above 2^53
+    obj["mac"] = QString::fromLatin1(mac);
+
+    QSaveFile file(statePath(listPath));
+    QByteArray data = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCWarning(lcLicense) << "Could not write revocation state" << file.fileName();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef REVOCATIONSTATE_H
+#define REVOCATIONSTATE_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Tamper-evident record of the newest revocation list accepted on this machine.
+ *
+ * Signed revocation lists cannot be forged, but an older, validly signed
+ * list can be put back, or the list deleted, to get a revoked license
+ * accepted again. The highest sequence number ever accepted is therefore
+ * kept in the application data directory, away from the list itself, in a
+ * state file per list path. It is sealed with an HMAC whose key is a random
+ * secret of this installation (`revocation.key` in the same directory): on
+ * Windows it is protected with DPAPI (bound to the user account and
+ * machine), elsewhere it is an owner-only file. The machine ID and the list
+ * path are mixed in, so a state copied from another machine or list never
+ * validates.
+ *
+ * A state that exists but does not validate counts as tampering, and once a
+ * state or the sealing key exists a missing list counts as removed; callers
+ * then fail closed.
+ */
+class RevocationState {
+public:
+    /**
+     * @brief Returns the state file that belongs to a list.
+     * @param listPath Path of the revocation list.
+     * @return `revocations-<hash of the absolute list path>.state` in the application data directory.
+     */
+    static QString statePath(const QString &listPath);
+
+    /**
+     * @brief Checks whether a list has been accepted on this machine before.
+     * @param listPath Path of the revocation list.
+     * @return true if its state file or the sealing key exists, valid or not.
+     */
+    static bool exists(const QString &listPath);
+
+    /**
+     * @brief Reads the highest accepted sequence.
+     * @param listPath Path of the revocation list.
+     * @param sequence Receives the sequence, or 0 if no state exists.
+     * @return false if a state exists but is malformed or fails the integrity check.
+     */
+    static bool read(const QString &listPath, quint64 &sequence);
+
+    /**
+     * @brief Raises the highest accepted sequence; lower values are ignored.
+     * @param listPath Path of the revocation list.
+     * @param sequence Sequence of a list that was just accepted.
+     * @return true if the state holds at least @p sequence afterwards.
+     */
+    static bool record(const QString &listPath, quint64 sequence);
+
+private:
+    /**
+     * @brief Computes the HMAC that seals a state record.
+     * @param listPath Path of the revocation list the record belongs to.
+     * @param sequence Recorded sequence.
+     * @param machineId Machine ID the record is bound to.
+     * @return Hex-encoded HMAC-SHA256, or an empty array if no sealing key is available.
+     */
+    static QByteArray computeMac(const QString &listPath, quint64 sequence, const QByteArray &machineId);
+
+    /**
+     * @brief Returns the installation's sealing secret, creating it on first use.
+     * @return 32 random bytes, or an empty array if the secret cannot be read or created.
+     */
+    static QByteArray sealingKey();
+};
+
+#endif // REVOCATIONSTATE_H
@@ -0,0 +1,180 @@
+#include "startuptrace.h"
+#include "clientlog.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic_bool StartupTrace::s_enabled(false);
+
+/**
+ * @brief One recorded trace event.
+ */
+struct TraceEvent {
+    const char *name;        ///< Event name (string literal)
+    std::string detail;      ///< Optional detail
+    int thread;              ///< Small sequential thread number
+    std::int64_t startNs;    ///< Start, relative to the trace origin
+    std::int64_t durationNs; ///< Duration, or -1 for an instant event
+};
+
+/**
+ * @brief Recorded events and output settings, guarded by one mutex.
+ */
+struct TraceState {
+    std::mutex mutex;               ///< Guards all members
+    std::vector<TraceEvent> events; ///< Events in completion order
+    std::int64_t originNs = 0;      ///< Clock value at initialize()
+    QString output;                 ///< Trace file path; empty for the summary line
+};
+
+/**
+ * @brief Returns the process-wide trace state.
+ * @return Trace state.
+ */
+static TraceState &traceState() {
+    static TraceState state;
+    return state;
+}
+
+/**
+ * @brief Returns a small, stable number for the calling thread.
+ * @return Thread number (1 for the first thread that records an event).
+ */
+static int currentThreadNumber() {
+    static std::atomic_int next(1);
+    thread_local int number = next.fetch_add(1);
+    return number;
+}
+
+/**
+ * @brief Returns the trace clock.
+ * @return Monotonic time in nanoseconds.
+ */
+std::int64_t StartupTrace::clockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Reads `CRYPTOBRANCH_TRACE` and starts the trace clock.
+ */
+void StartupTrace::initialize() {
+    const QString setting = qEnvironmentVariable("CRYPTOBRANCH_TRACE");
+    if (setting.isEmpty() || setting == "0")
+        return;
+
+    TraceState &state = traceState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.originNs = clockNs();
+    state.output = (setting == "1" || setting == "summary") ? QString() : setting;
+    state.events.reserve(64);
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Records a point in time (e.g. the first paint).
+ * @param name Event name; must be a string literal.
+ */
+void StartupTrace::instant(const char *name) {
+    if (isEnabled())
+        record(name, nullptr, clockNs(), -1);
+}
+
+/**
+ * @brief Stores one event.
+ * @param name Event name.
+ * @param detail Optional detail; may be null.
+ * @param startNs Start time.
+ * @param durationNs Duration; -1 for an instant event.
+ */
+void StartupTrace::record(const char *name, const char *detail, std::int64_t startNs, std::int64_t durationNs) {
+    TraceState &state = traceState();
+    int thread = currentThreadNumber();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.events.push_back({name, detail ? std::string(detail) : std::string(), thread, startNs - state.originNs, durationNs});
+}
+
+/**
+ * @brief Formats a duration for the summary line.
+ * @param ns Duration in nanoseconds.
+ * @return Milliseconds with one decimal, e.g. "12.3 ms".
+ */
+static QString milliseconds(std::int64_t ns) {
+    return QString::number(static_cast<double>(ns) / 1e6, 'f', 1) + " ms";
+}
+
+/**
+ * @brief Writes the summary or trace file and stops recording.
+ *
+ * The summary lists instant events with their offset from process start and
+ * sums durations per event name, in order of first completion. The Chrome
+ * trace contains every event ("X" complete events and "i" instant events).
+ */
+void StartupTrace::finish() {
+    if (!s_enabled.exchange(false))
+        return;
+
+    TraceState &state = traceState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    if (state.output.isEmpty()) {
+        struct Total { const char *name; std::int64_t ns; int count; };
+        std::vector<Total> totals;
+        QStringList parts;
+        for (const TraceEvent &event : state.events) {
+            if (event.durationNs < 0) {
+                parts << QString("%1 at %2").arg(event.name, milliseconds(event.startNs));
+                continue;
+            }
+            auto it = std::find_if(totals.begin(), totals.end(), [&](const Total &t) { return std::string(t.name) == event.name; });
+            if (it == totals.end())
+                totals.push_back({event.name, event.durationNs, 1});
+            else {
+                it->ns += event.durationNs;
+                ++it->count;
+            }
+        }
+        for (const Total &total : totals) {
+            parts << QString("%1%2 %3").arg(total.name, total.count > 1 ? QString(" %1x").arg(total.count) : QString(),
+                                             milliseconds(total.ns));
+        }
+        qCInfo(lcStartup).noquote() << "CryptoBranch startup:" << parts.join("; ");
+        return;
+    }
+
+    QJsonArray traceEvents;
+    for (const TraceEvent &event : state.events) {
+        QJsonObject object;
+        object["name"] = event.name;
+        object["ph"] = event.durationNs < 0 ? "i" : "X";
+        object["ts"] = static_cast<double>(event.startNs) / 1e3;
+        if (event.durationNs >= 0)
+            object["dur"] = static_cast<double>(event.durationNs) / 1e3;
+        else
+            object["s"] = "g";
+        object["pid"] = 1;
+        object["tid"] = event.thread;
+        if (!event.detail.empty())
+            object["args"] = QJsonObject{{"detail", QString::fromStdString(event.detail)}};
+        traceEvents.append(object);
+    }
+
+    QFile file(state.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcStartup) << "Could not write start-up trace to" << state.output;
+        return;
+    }
+    file.write(QJsonDocument(QJsonObject{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}}).toJson(QJsonDocument::Compact));
+    qCInfo(lcStartup) << "Start-up trace written to" << state.output;
+}
@@ -0,0 +1,92 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lightweight start-up timing instrumentation.
+ *
+ * Enabled with the environment variable `CRYPTOBRANCH_TRACE`:
+ * - `summary` (or `1`): one line with the timings is logged when start-up finishes
+ * - any other value: a Chrome trace (`chrome://tracing`, Perfetto) is written to that path
+ *
+ * When the variable is unset, a Scope costs one relaxed atomic load: no
+ * clock is read and nothing is recorded or allocated.
+ */
+class StartupTrace {
+public:
+    /**
+     * @brief Records the duration of the enclosing block as one trace event.
+     */
+    class Scope {
+    public:
+        /**
+         * @brief Starts timing a block.
+         * @param name Event name; must be a string literal (it is not copied).
+         * @param detail Optional detail shown in the trace (copied); may be null.
+         */
+        explicit Scope(const char *name, const char *detail = nullptr)
+            : m_name(isEnabled() ? name : nullptr), m_detail(detail), m_startNs(m_name ? clockNs() : 0) {}
+
+        /**
+         * @brief Stops timing and records the event.
+         */
+        ~Scope() {
+            if (m_name)
+                record(m_name, m_detail, m_startNs, clockNs() - m_startNs);
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *m_name;     ///< Event name, or null when tracing is disabled
+        const char *m_detail;   ///< Optional detail
+        std::int64_t m_startNs; ///< Start time
+    };
+
+    /**
+     * @brief Reads `CRYPTOBRANCH_TRACE` and starts the trace clock.
+     *
+     * Call once at the top of main(), before any Scope.
+     */
+    static void initialize();
+
+    /**
+     * @brief Checks whether tracing is enabled.
+     * @return true if events are being recorded.
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records a point in time (e.g. the first paint).
+     * @param name Event name; must be a string literal.
+     */
+    static void instant(const char *name);
+
+    /**
+     * @brief Writes the summary or trace file and stops recording.
+     */
+    static void finish();
+
+private:
+    /**
+     * @brief Returns the trace clock.
+     * @return Monotonic time in nanoseconds.
+     */
+    static std::int64_t clockNs();
+
+    /**
+     * @brief Stores one event.
+     * @param name Event name.
+     * @param detail Optional detail; may be null.
+     * @param startNs Start time.
+     * @param durationNs Duration; -1 for an instant event.
+     */
+    static void record(const char *name, const char *detail, std::int64_t startNs, std::int64_t durationNs);
+
+    static std::atomic_bool s_enabled; ///< Set by initialize(), cleared by finish()
+};
+
+#endif // STARTUPTRACE_H
@@ -0,0 +1,200 @@
+#include "hardwarefingerprint.h"
+#include "interfaceselector.h"
+#include "nativeprobe.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <future>
+#include <sstream>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Reads the MAC address of the primary network adapter.
+ * @return MAC address ("XX:XX:XX:XX:XX:XX"), or an empty string if no usable adapter exists.
+ */
+std::string HardwareFingerprint::macAddress() {
+    return InterfaceSelector::primaryMacAddress();
+}
+
+/**
+ * @brief Reads the serial number of the first physical disk.
+ * @return Serial number without whitespace, or an empty string if unavailable.
+ */
+std::string HardwareFingerprint::diskSerialNumber() {
+    return normalize(NativeProbe::getDiskSerialNumber());
+}
+
+/**
+ * @brief Reads the disk serial number the way clients before native probing did on Linux.
+ * @param blockDirectory Directory holding the block devices (`/sys/block`).
+ * @return Serial number without whitespace, or an empty string if unavailable.
+ */
+std::string HardwareFingerprint::legacyDiskSerialNumber(const std::string &blockDirectory) {
+    std::string serial;
+    std::ifstream file(blockDirectory + "/sda/device/serial");
+    if (file.is_open())
+        std::getline(file, serial);
+    return normalize(serial);
+}
+
+/**
+ * @brief Reads the CPU identifier.
+ *
+ * - Windows: CPUID vendor string and signature
+ * - Linux, macOS: NativeProbe (/proc/cpuinfo, sysctlbyname)
+ *
+ * @return CPU identifier without whitespace, or an empty string if unavailable.
+ */
+std::string HardwareFingerprint::cpuId() {
+#ifdef _WIN32
+    int cpuInfo[4] = {0};
+    __cpuid(cpuInfo, 0);
+    char vendor[13] = {0};
+    *reinterpret_cast<int*>(vendor) = cpuInfo[1];
+    *reinterpret_cast<int*>(vendor + 4) = cpuInfo[3];
+    *reinterpret_cast<int*>(vendor + 8) = cpuInfo[2];
+    __cpuid(cpuInfo, 1);
+    std::ostringstream oss;
+    oss << vendor << "_" << std::hex << cpuInfo[0];
+    return normalize(oss.str());
+#else
+    return normalize(NativeProbe::getCpuId());
+#endif
+}
+
+/**
+ * @brief Probes the hardware and returns the fingerprint.
+ * @return Hexadecimal SHA-256 fingerprint.
+ */
+std::string HardwareFingerprint::compute() {
+    std::future<std::string> macFuture = std::async(std::launch::async, &HardwareFingerprint::macAddress);
+    std::future<std::string> diskFuture = std::async(std::launch::async, &HardwareFingerprint::diskSerialNumber);
+    std::string cpu = cpuId();
+    std::string mac = macFuture.get();
+    std::string disk = diskFuture.get();
+
+    return combine(mac.empty() ? "00:00:00:00:00:00" : mac,
+                   disk.empty() ? "UNKNOWN_DISK" : disk,
+                   cpu.empty() ? "UNKNOWN_CPU" : cpu);
+}
+
+namespace {
+
+/**
+ * @brief Encodes a digest as lowercase HEX.
+ * @param digest Digest bytes.
+ * @param digestLength Number of bytes.
+ * @return Hexadecimal text.
+ */
+std::string toHex(const unsigned char *digest, unsigned int digestLength) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(digestLength * 2);
+    for (unsigned int i = 0; i < digestLength; ++i) {
+        hex.push_back(digits[digest[i] >> 4]);
+        hex.push_back(digits[digest[i] & 0x0F]);
+    }
+    return hex;
+}
+
+/**
+ * @brief Hashes a string with SHA-256.
+ * @param data Data to hash.
+ * @return Lowercase hexadecimal digest, or an empty string on failure.
+ */
+std::string sha256Hex(const std::string &data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestLength = 0;
+    if (EVP_Digest(data.data(), data.size(), digest, &digestLength, EVP_sha256(), nullptr) != 1)
+        return "";
+    return toHex(digest, digestLength);
+}
+
+/**
+ * @brief Checks whether a probe result tells machines apart.
+ * @param component Component index (LicenseClaims::Component).
+ * @param value Probe result.
+ * @return false for empty values, failed-probe placeholders and bare processor numbers.
+ */
+bool isIdentifying(int component, const std::string &value) {
+    if (value.empty())
+        return false;
+    switch (component) {
+    case LicenseClaims::Mac:
+        return value != "00:00:00:00:00:00";
+    case LicenseClaims::Disk:
+        return value != "UNKNOWN_DISK";
+    default:
+        return value != "UNKNOWN_CPU" &&
+               !std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); });
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Hashes the fingerprint inputs.
+ * @param mac MAC address.
+ * @param disk Disk serial number.
+ * @param cpu CPU identifier.
+ * @return Lowercase hexadecimal SHA-256 of "mac|disk|cpu".
+ */
+std::string HardwareFingerprint::combine(const std::string &mac, const std::string &disk, const std::string &cpu) {
+    return sha256Hex(mac + "|" + disk + "|" + cpu);
+}
+
+/**
+ * @brief Hashes one fingerprint input on its own.
+ * @param component Component name ("mac", "disk" or "cpu").
+ * @param value Probe result.
+ * @param fingerprint Fingerprint the license is issued for.
+ * @return Lowercase hexadecimal HMAC-SHA256 of "component:value" keyed with @p fingerprint.
+ */
+std::string HardwareFingerprint::componentHash(const std::string &component, const std::string &value,
+                                               const std::string &fingerprint) {
+    const std::string data = component + ":" + value;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestLength = 0;
+    if (!HMAC(EVP_sha256(), fingerprint.data(), static_cast<int>(fingerprint.size()),
+              reinterpret_cast<const unsigned char *>(data.data()), data.size(), digest, &digestLength))
+        return "";
+    return toHex(digest, digestLength);
+}
+
+/**
+ * @brief Hashes the fingerprint inputs individually.
+ * @param mac MAC address.
+ * @param disk Disk serial number.
+ * @param cpu CPU identifier.
+ * @param fingerprint Fingerprint the license is issued for (see componentHash()).
+ * @return Component hashes for LicenseClaims::components; constant components stay empty.
+ */
+LicenseClaims::ComponentHashes HardwareFingerprint::componentHashes(const std::string &mac, const std::string &disk,
+                                                                    const std::string &cpu,
+                                                                    const std::string &fingerprint) {
+    const std::string *values[LicenseClaims::ComponentCount] = {&mac, &disk, &cpu};
+    LicenseClaims::ComponentHashes hashes;
+    for (int i = 0; i < LicenseClaims::ComponentCount; ++i) {
+        if (isIdentifying(i, *values[i]))
+            hashes[i] = componentHash(LicenseClaims::componentName(i), *values[i], fingerprint);
+    }
+    return hashes;
+}
+
+/**
+ * @brief Removes all whitespace from a probe result.
+ * @param value Raw probe output.
+ * @return @p value without spaces, tabs and line breaks.
+ */
+std::string HardwareFingerprint::normalize(std::string value) {
+    value.erase(std::remove_if(value.begin(), value.end(),
+                               [](unsigned char c) { return std::isspace(c) != 0; }), value.end());
+    return value;
+}
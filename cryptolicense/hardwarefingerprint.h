@@ -0,0 +1,113 @@
+#ifndef HARDWAREFINGERPRINT_H
+#define HARDWAREFINGERPRINT_H
+
+#include <string>
+
+#include <licenseclaims.h>
+
+/**
+ * @brief Qt-free hardware fingerprinting.
+ *
+ * Computes the same fingerprint as the branch client, SHA-256 of
+ * `mac|disk|cpu`, from direct OS queries only (InterfaceSelector and
+ * NativeProbe). No process is spawned and no Qt is needed, so headless
+ * services can identify a machine from the cryptolicense library alone.
+ *
+ * HardwareLock builds on these probes and adds command line fallbacks for
+ * machines where a native query fails; when the native probes succeed, which
+ * is the normal case, both produce the same fingerprint.
+ */
+class HardwareFingerprint {
+public:
+    /**
+     * @brief Reads the MAC address of the primary network adapter.
+     * @return MAC address ("XX:XX:XX:XX:XX:XX"), or an empty string if no usable adapter exists.
+     */
+    static std::string macAddress();
+
+    /**
+     * @brief Reads the serial number of the first physical disk.
+     * @return Serial number without whitespace, or an empty string if unavailable.
+     */
+    static std::string diskSerialNumber();
+
+    /**
+     * @brief Reads the disk serial number the way clients before native probing did on Linux.
+     *
+     * Those clients ran their disk commands without a shell, so the `lsblk`
+     * and `udevadm` pipelines never succeeded and only
+     * `/sys/block/sda/device/serial` was ever read. Fingerprints of licenses
+     * issued to them depend on exactly this value.
+     *
+     * @param blockDirectory Directory holding the block devices (`/sys/block`).
+     * @return First line of `<blockDirectory>/sda/device/serial` without whitespace,
+     *         or an empty string if the file cannot be read (always on non-Linux systems).
+     */
+    static std::string legacyDiskSerialNumber(const std::string &blockDirectory = "/sys/block");
+
+    /**
+     * @brief Reads the CPU identifier.
+     * @return CPU identifier without whitespace, or an empty string if unavailable.
+     */
+    static std::string cpuId();
+
+    /**
+     * @brief Probes the hardware and returns the fingerprint.
+     *
+     * The three probes run concurrently. Missing values are replaced by
+     * the same placeholders HardwareLock uses.
+     *
+     * @return Hexadecimal SHA-256 fingerprint.
+     */
+    static std::string compute();
+
+    /**
+     * @brief Hashes the fingerprint inputs.
+     * @param mac MAC address.
+     * @param disk Disk serial number.
+     * @param cpu CPU identifier.
+     * @return Lowercase hexadecimal SHA-256 of "mac|disk|cpu".
+     */
+    static std::string combine(const std::string &mac, const std::string &disk, const std::string &cpu);
+
+    /**
+     * @brief Hashes one fingerprint input on its own.
+     *
+     * The component name is part of the hashed data, so equal values of
+     * different components never produce the same hash. The hash is keyed
+     * with the license fingerprint, so a MAC address or serial number cannot
+     * be looked up in a table precomputed for all licenses.
+     *
+     * @param component Component name ("mac", "disk" or "cpu").
+     * @param value Probe result.
+     * @param fingerprint Fingerprint the license is issued for.
+     * @return Lowercase hexadecimal HMAC-SHA256 of "component:value" keyed with @p fingerprint.
+     */
+    static std::string componentHash(const std::string &component, const std::string &value,
+                                     const std::string &fingerprint);
+
+    /**
+     * @brief Hashes the fingerprint inputs individually.
+     *
+     * Values that do not tell machines apart are left out: the placeholders
+     * for a failed probe and a bare processor number, which is what Linux
+     * reports as CPU ID ("0" on every machine).
+     *
+     * @param mac MAC address.
+     * @param disk Disk serial number.
+     * @param cpu CPU identifier.
+     * @param fingerprint Fingerprint the license is issued for (see componentHash()).
+     * @return Component hashes for LicenseClaims::components; constant components stay empty.
+     */
+    static LicenseClaims::ComponentHashes componentHashes(const std::string &mac, const std::string &disk,
+                                                          const std::string &cpu, const std::string &fingerprint);
+
+    /**
+     * @brief Removes all whitespace from a probe result.
+     * @param value Raw probe output.
+     * @return @p value without spaces, tabs and line breaks.
+     */
+    static std::string normalize(std::string value);
+};
+
+#endif // HARDWAREFINGERPRINT_H
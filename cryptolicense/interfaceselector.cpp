@@ -0,0 +1,267 @@
+#include "interfaceselector.h"
+
+#include <algorithm>
+#include <cctype>
+
+#ifdef _WIN32
+#if !defined(_WIN32_WINNT) || _WIN32_WINNT < 0x0600
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600 // GetIfTable2 requires Vista
+#endif
+#include <winsock2.h>
+#include <windows.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <fstream>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <ifaddrs.h>
+#include <net/if_dl.h>
+#include <net/if_types.h>
+#include <sys/socket.h>
+#endif
+
+/**
+ * @brief Parses the first octet of a formatted MAC address.
+ * @param macAddress Address as "AA:BB:CC:DD:EE:FF".
+ * @return Octet value, or -1 if the address is malformed.
+ */
+static int firstOctet(const std::string &macAddress) {
+    if (macAddress.size() < 2 || !std::isxdigit(static_cast<unsigned char>(macAddress[0])) ||
+        !std::isxdigit(static_cast<unsigned char>(macAddress[1])))
+        return -1;
+    return std::stoi(macAddress.substr(0, 2), nullptr, 16);
+}
+
+/**
+ * @brief Formats a hardware address.
+ * @param bytes Address bytes.
+ * @param length Number of bytes.
+ * @return Upper case, colon separated address.
+ */
+std::string InterfaceSelector::formatMacAddress(const unsigned char *bytes, std::size_t length) {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(length * 3);
+    for (std::size_t i = 0; i < length; ++i) {
+        if (i > 0)
+            out += ':';
+        out += digits[bytes[i] >> 4];
+        out += digits[bytes[i] & 0x0F];
+    }
+    return out;
+}
+
+/**
+ * @brief Checks whether a MAC address identifies a single adapter.
+ * @param macAddress Address as "AA:BB:CC:DD:EE:FF".
+ * @return false for empty, all-zero, broadcast and multicast addresses.
+ */
+bool InterfaceSelector::isUsableMacAddress(const std::string &macAddress) {
+    int octet = firstOctet(macAddress);
+    if (octet < 0 || (octet & 0x01)) // multicast (includes broadcast)
+        return false;
+    return macAddress.find_first_not_of("0:") != std::string::npos;
+}
+
+/**
+ * @brief Checks the locally administered bit of a MAC address.
+ * @param macAddress Address as "AA:BB:CC:DD:EE:FF".
+ * @return true if the address was assigned by software rather than the vendor.
+ */
+bool InterfaceSelector::isLocallyAdministered(const std::string &macAddress) {
+    int octet = firstOctet(macAddress);
+    return octet >= 0 && (octet & 0x02);
+}
+
+/**
+ * @brief Ranks a candidate.
+ *
+ * Physical outweighs permanent, which outweighs wired: a physical adapter
+ * with a randomized address is still preferred over any virtual adapter.
+ *
+ * @param candidate Adapter to rank.
+ * @return Rank (higher is preferred), or -1 if the address cannot be used.
+ */
+int InterfaceSelector::rank(const Candidate &candidate) {
+    if (!isUsableMacAddress(candidate.macAddress))
+        return -1;
+    return (candidate.physical ? 4 : 0) + (candidate.permanent ? 2 : 0) + (candidate.wireless ? 0 : 1);
+}
+
+/**
+ * @brief Picks the preferred adapter.
+ * @param candidates Adapters in any order.
+ * @return Highest ranked candidate (lowest MAC address on ties), or null if none is usable.
+ */
+const InterfaceSelector::Candidate *InterfaceSelector::select(const std::vector<Candidate> &candidates) {
+    const Candidate *best = nullptr;
+    int bestRank = -1;
+    for (const Candidate &candidate : candidates) {
+        int candidateRank = rank(candidate);
+        if (candidateRank < 0)
+            continue;
+        if (candidateRank > bestRank || (candidateRank == bestRank && candidate.macAddress < best->macAddress)) {
+            best = &candidate;
+            bestRank = candidateRank;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Returns the MAC address of the preferred adapter.
+ * @return MAC address, or an empty string if no adapter qualifies.
+ */
+std::string InterfaceSelector::primaryMacAddress() {
+    std::vector<Candidate> candidates = enumerate();
+    const Candidate *best = select(candidates);
+    return best ? best->macAddress : std::string();
+}
+
+#ifdef _WIN32
+
+/**
+ * @brief Lists Ethernet and Wi-Fi interfaces with GetIfTable2().
+ *
+ * Filter-driver rows (duplicates of the underlying adapter) are skipped.
+ * The burned-in PermanentPhysicalAddress is used when the adapter reports
+ * one, so a MAC override in the driver settings does not change the result.
+ *
+ * @return Candidates in OS order.
+ */
+std::vector<InterfaceSelector::Candidate> InterfaceSelector::enumerate() {
+    std::vector<Candidate> candidates;
+    PMIB_IF_TABLE2 table = nullptr;
+    if (GetIfTable2(&table) != NO_ERROR || !table)
+        return candidates;
+
+    for (ULONG i = 0; i < table->NumEntries; ++i) {
+        const MIB_IF_ROW2 &row = table->Table[i];
+        if (row.InterfaceAndOperStatusFlags.FilterInterface)
+            continue;
+        if (row.Type != IF_TYPE_ETHERNET_CSMACD && row.Type != IF_TYPE_IEEE80211)
+            continue;
+
+        Candidate candidate;
+        char name[256] = {0};
+        WideCharToMultiByte(CP_UTF8, 0, row.Alias, -1, name, sizeof(name) - 1, nullptr, nullptr);
+        candidate.name = name;
+
+        std::string permanent = formatMacAddress(row.PermanentPhysicalAddress, row.PhysicalAddressLength);
+        candidate.permanent = isUsableMacAddress(permanent) && !isLocallyAdministered(permanent);
+        candidate.macAddress = candidate.permanent
+            ? permanent
+            : formatMacAddress(row.PhysicalAddress, row.PhysicalAddressLength);
+        candidate.physical = row.InterfaceAndOperStatusFlags.HardwareInterface != FALSE;
+        candidate.wireless = row.Type == IF_TYPE_IEEE80211;
+        candidates.push_back(candidate);
+    }
+    FreeMibTable(table);
+    return candidates;
+}
+
+#elif defined(__linux__)
+
+/**
+ * @brief Reads the first line of a sysfs attribute.
+ * @param path Attribute path.
+ * @return Attribute value without the line ending, or an empty string.
+ */
+static std::string readAttribute(const std::string &path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+/**
+ * @brief Lists Ethernet-type interfaces from `/sys/class/net`.
+ *
+ * `device` exists only for interfaces backed by a bus device (PCI, USB,
+ * virtio), so bridges, veth pairs, tun/tap and bonding masters are virtual.
+ * `addr_assign_type` is 0 (NET_ADDR_PERM) for burned-in addresses.
+ *
+ * @return Candidates in directory order.
+ */
+std::vector<InterfaceSelector::Candidate> InterfaceSelector::enumerate() {
+    static const std::string base = "/sys/class/net/";
+    std::vector<Candidate> candidates;
+
+    DIR *dir = opendir(base.c_str());
+    if (!dir)
+        return candidates;
+
+    while (struct dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+        std::string path = base + name + "/";
+        if (readAttribute(path + "type") != "1") // ARPHRD_ETHER (also used by Wi-Fi)
+            continue;
+
+        Candidate candidate;
+        candidate.name = name;
+        candidate.macAddress = readAttribute(path + "address");
+        std::transform(candidate.macAddress.begin(), candidate.macAddress.end(), candidate.macAddress.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        candidate.physical = access((path + "device").c_str(), F_OK) == 0;
+        candidate.permanent = readAttribute(path + "addr_assign_type") == "0" &&
+                              !isLocallyAdministered(candidate.macAddress);
+        candidate.wireless = access((path + "wireless").c_str(), F_OK) == 0 ||
+                             access((path + "phy80211").c_str(), F_OK) == 0;
+        candidates.push_back(candidate);
+    }
+    closedir(dir);
+    return candidates;
+}
+
+#elif defined(__APPLE__)
+
+/**
+ * @brief Lists Ethernet-type link-layer interfaces with getifaddrs().
+ *
+ * Built-in and USB/Thunderbolt adapters are named `en<N>`; bridges, VPN
+ * tunnels (`utun`), AirDrop (`awdl`) and hypervisor interfaces are not.
+ * macOS exposes no burned-in address, so a vendor-assigned (not locally
+ * administered) address counts as permanent.
+ *
+ * @return Candidates in OS order.
+ */
+std::vector<InterfaceSelector::Candidate> InterfaceSelector::enumerate() {
+    std::vector<Candidate> candidates;
+    struct ifaddrs *list = nullptr;
+    if (getifaddrs(&list) != 0)
+        return candidates;
+
+    for (struct ifaddrs *entry = list; entry; entry = entry->ifa_next) {
+        if (!entry->ifa_addr || entry->ifa_addr->sa_family != AF_LINK)
+            continue;
+        const struct sockaddr_dl *link = reinterpret_cast<const struct sockaddr_dl *>(entry->ifa_addr);
+        if (link->sdl_type != IFT_ETHER || link->sdl_alen != 6)
+            continue;
+
+        Candidate candidate;
+        candidate.name = entry->ifa_name;
+        candidate.macAddress = formatMacAddress(reinterpret_cast<const unsigned char *>(LLADDR(link)), link->sdl_alen);
+        candidate.physical = candidate.name.compare(0, 2, "en") == 0;
+        candidate.permanent = !isLocallyAdministered(candidate.macAddress);
+        candidates.push_back(candidate);
+    }
+    freeifaddrs(list);
+    return candidates;
+}
+
+#else
+
+/**
+ * @brief No native enumeration on this platform.
+ * @return Empty list; callers fall back to QNetworkInterface.
+ */
+std::vector<InterfaceSelector::Candidate> InterfaceSelector::enumerate() {
+    return std::vector<Candidate>();
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef INTERFACESELECTOR_H
+#define INTERFACESELECTOR_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Deterministic selection of the network adapter used in the fingerprint.
+ *
+ * Adapters are read directly from the OS, without collecting addresses or
+ * other interface details:
+ * - Linux: `/sys/class/net/<name>/{type,address,addr_assign_type,device}`
+ * - Windows: `GetIfTable2()` (hardware flag and burned-in address per interface)
+ * - macOS: `getifaddrs()` link-layer entries
+ *
+ * Every candidate is ranked: physical adapters before virtual ones (bridges,
+ * veth pairs, tunnels, VPN and hypervisor switches), permanent (burned-in)
+ * addresses before randomized or software-assigned ones, and wired before
+ * wireless. Ties are broken by the lowest MAC address, so the choice does
+ * not depend on the order in which the OS lists interfaces and does not
+ * change when a VPN or container bridge comes and goes.
+ */
+class InterfaceSelector {
+public:
+    /**
+     * @brief One network adapter as reported by the OS.
+     */
+    struct Candidate {
+        std::string name;        ///< Interface name (for logging)
+        std::string macAddress;  ///< MAC address as "AA:BB:CC:DD:EE:FF"
+        bool physical = false;   ///< Backed by a hardware device
+        bool permanent = false;  ///< Burned-in address, not randomized or set by software
+        bool wireless = false;   ///< IEEE 802.11 adapter
+    };
+
+    /**
+     * @brief Lists the Ethernet-like adapters of this machine.
+     * @return Candidates in OS order; empty if the platform is not supported.
+     */
+    static std::vector<Candidate> enumerate();
+
+    /**
+     * @brief Ranks a candidate.
+     * @param candidate Adapter to rank.
+     * @return Rank (higher is preferred), or -1 if the address cannot be used.
+     */
+    static int rank(const Candidate &candidate);
+
+    /**
+     * @brief Picks the preferred adapter.
+     * @param candidates Adapters in any order.
+     * @return Highest ranked candidate (lowest MAC address on ties), or null if none is usable.
+     */
+    static const Candidate *select(const std::vector<Candidate> &candidates);
+
+    /**
+     * @brief Returns the MAC address of the preferred adapter.
+     * @return MAC address, or an empty string if no adapter qualifies.
+     */
+    static std::string primaryMacAddress();
+
+    /**
+     * @brief Formats a hardware address.
+     * @param bytes Address bytes.
+     * @param length Number of bytes.
+     * @return Upper case, colon separated address.
+     */
+    static std::string formatMacAddress(const unsigned char *bytes, std::size_t length);
+
+    /**
+     * @brief Checks whether a MAC address identifies a single adapter.
+     * @param macAddress Address as "AA:BB:CC:DD:EE:FF".
+     * @return false for empty, all-zero, broadcast and multicast addresses.
+     */
+    static bool isUsableMacAddress(const std::string &macAddress);
+
+    /**
+     * @brief Checks the locally administered bit of a MAC address.
+     * @param macAddress Address as "AA:BB:CC:DD:EE:FF".
+     * @return true if the address was assigned by software rather than the vendor.
+     */
+    static bool isLocallyAdministered(const std::string &macAddress);
+};
+
+#endif // INTERFACESELECTOR_H
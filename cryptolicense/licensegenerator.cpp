@@ -0,0 +1,226 @@
+#include "licensegenerator.h"
+#include "licensesigner.h"
+#include <binarylicense.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <json.hpp>
+
+#include <openssl/evp.h>
+
+using json = nlohmann::json;
+
+/**
+ * @brief Trims whitespace and line endings from both ends of an input line.
+ * @param line Raw input line.
+ * @return Trimmed copy of the line.
+ */
+std::string LicenseGenerator::trimHardwareId(const std::string &line)
+{
+    const char *ws = " \t\r\n";
+    size_t begin = line.find_first_not_of(ws);
+    if (begin == std::string::npos)
+        return "";
+    size_t end = line.find_last_not_of(ws);
+    return line.substr(begin, end - begin + 1);
+}
+
+/**
+ * @brief Checks that a hardware ID may be signed.
+ * @param hardwareId Trimmed hardware ID.
+ * @return true for non-empty printable ASCII of at most 256 characters without spaces, quotes or backslashes.
+ */
+bool LicenseGenerator::isValidHardwareId(const std::string &hardwareId)
+{
+    if (hardwareId.empty() || hardwareId.size() > 256)
+        return false;
+    return std::all_of(hardwareId.begin(), hardwareId.end(),
+                       [](char c) { return c > ' ' && c < 0x7F && c != '"' && c != '\\'; });
+}
+
+/**
+ * @brief Splits a license request line into hardware ID and component hashes.
+ * @param line Raw input line.
+ * @param components Receives the component hashes; cleared if the line has none or they are malformed or incomplete.
+ * @return Trimmed hardware ID (empty for blank lines).
+ */
+std::string LicenseGenerator::parseRequestLine(const std::string &line, LicenseClaims::ComponentHashes &components)
+{
+    std::string trimmed = trimHardwareId(line);
+    size_t split = trimmed.find_first_of(" \t");
+    if (split == std::string::npos) {
+        components = LicenseClaims::ComponentHashes();
+        return trimmed;
+    }
+    LicenseClaims parsed;
+    if (!LicenseClaims::parseComponentList(trimHardwareId(trimmed.substr(split)), parsed.components)) {
+        std::cerr << "❌ Ignoring malformed component list for: " << trimmed.substr(0, split) << "\n";
+    } else if (!parsed.hasAllComponents()) {
+        // A partial list would let one copied identifier carry the license
+        std::cerr << "❌ Ignoring incomplete component list (mac, disk and cpu are required) for: "
+                  << trimmed.substr(0, split) << "\n";
+        parsed.components = LicenseClaims::ComponentHashes();
+    }
+    components = std::move(parsed.components);
+    return trimmed.substr(0, split);
+}
+
+/**
+ * @brief Maps a hardware ID to a safe file name.
+ *
+ * Fingerprints are lowercase HEX strings and keep their name. Any other ID
+ * has the characters outside `[a-z0-9_-]` replaced, so that a malformed
+ * input line cannot escape the output directory, and gets a hash of the
+ * original ID appended: `a:b` and `a.b` (or `AB` and `ab` on a
+ * case-insensitive file system) then never share a file. Safe names contain
+ * no '.', so a suffixed name cannot equal the name of an unchanged ID.
+ *
+ * @param hardwareId The hardware fingerprint or ID.
+ * @return File name of the form `<hardwareId>.lic` or `<sanitized hardwareId>.<hash>.lic`.
+ */
+std::string LicenseGenerator::licenseFileName(const std::string &hardwareId)
+{
+    std::string name = hardwareId;
+    bool changed = false;
+    for (char &c : name) {
+        if (!(c >= 'a' && c <= 'z') && !(c >= '0' && c <= '9') && c != '-' && c != '_') {
+            c = std::isupper(static_cast<unsigned char>(c)) ? static_cast<char>(std::tolower(static_cast<unsigned char>(c)))
+                                                            : '_';
+            changed = true;
+        }
+    }
+    if (!changed)
+        return name + ".lic";
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestLength = 0;
+    EVP_Digest(hardwareId.data(), hardwareId.size(), digest, &digestLength, EVP_sha256(), nullptr);
+    return name + "." + LicenseSigner::toHex(std::string(reinterpret_cast<const char *>(digest), 8)) + ".lic";
+}
+
+/**
+ * @brief Builds the JSON license document for a hardware ID and its signature.
+ * @param hardwareId The hardware fingerprint or ID.
+ * @param signatureHex HEX-encoded signature of LicenseClaims::signingPayload().
+ * @param algorithm Signature algorithm stored in the `alg` field.
+ * @param claims Claims stored in the `expiresAt`, `features`, `components` and `match` fields, if set.
+ * @param keyId Signing key ID stored in the `kid` field, if set.
+ * @param indent Indentation width; -1 for a single line (NDJSON).
+ * @return JSON license text.
+ */
+std::string LicenseGenerator::buildLicenseJson(const std::string &hardwareId, const std::string &signatureHex,
+                                               const std::string &algorithm, const LicenseClaims &claims,
+                                               const std::string &keyId, int indent)
+{
+    json licenseJson;
+    licenseJson["hardwareId"] = hardwareId;
+    licenseJson["alg"] = algorithm;
+    if (!keyId.empty())
+        licenseJson["kid"] = keyId;
+    if (claims.expiresAt != 0)
+        licenseJson["expiresAt"] = claims.expiresAt;
+    if (!claims.features.empty())
+        licenseJson["features"] = claims.features;
+    if (claims.hasComponents()) {
+        json components = json::object();
+        for (int i = 0; i < LicenseClaims::ComponentCount; ++i) {
+            if (!claims.components[i].empty())
+                components[LicenseClaims::componentName(i)] = claims.components[i];
+        }
+        licenseJson["components"] = components;
+        licenseJson["match"] = claims.effectiveRequiredMatches();
+    }
+    licenseJson["signature"] = signatureHex;
+    return licenseJson.dump(indent); // pretty-print with indentation unless -1
+}
+
+/**
+ * @brief Encodes a license in the requested format.
+ * @param hardwareId The hardware fingerprint or ID.
+ * @param signature Raw signature bytes.
+ * @param algorithm Signature algorithm.
+ * @param format Output encoding.
+ * @param claims Signed expiry and features.
+ * @param keyId Signing key ID (`kid`), if set.
+ * @return License file contents.
+ */
+std::string LicenseGenerator::buildLicense(const std::string &hardwareId, const std::string &signature,
+                                           const std::string &algorithm, LicenseFormat format,
+                                           const LicenseClaims &claims, const std::string &keyId)
+{
+    if (format == LicenseFormat::Binary)
+        return BinaryLicense::encode(hardwareId, algorithm, signature, claims, keyId);
+    return buildLicenseJson(hardwareId, LicenseSigner::toHex(signature), algorithm, claims, keyId);
+}
+
+/**
+ * @brief Generates a license file for a given hardware ID using private key signing.
+ *
+ * The function:
+ * 1. Creates a JSON object containing the hardware ID
+ * 2. Signs the hardware ID and claims with the private key (RSA, EC or Ed25519)
+ * 3. Saves the license as a `.lic` file containing hardware ID, algorithm, claims and signature
+ *
+ * @param hardwareId The hardware fingerprint or ID for the target machine.
+ * @param privateKeyPath Path to the private key (`private_key.pem`) used for signing.
+ * @param outputFile Path to save the generated license file (`license.lic`).
+ * @param format Encoding of the license file.
+ * @param claims Expiry and features to sign into the license.
+ * @return true if license generation succeeds, false otherwise.
+ */
+bool LicenseGenerator::generateLicense(const std::string &hardwareId, const std::string &privateKeyPath,
+                                       const std::string &outputFile, LicenseFormat format,
+                                       const LicenseClaims &claims)
+{
+    LicenseSigner signer;
+    if (!signer.loadPrivateKey(privateKeyPath)) {
+        return false;
+    }
+
+    if (!generateLicense(hardwareId, signer, outputFile, format, claims)) {
+        return false;
+    }
+
+    std::cout << "✅ License successfully generated: " << outputFile << "\n";
+    return true;
+}
+
+/**
+ * @brief Generates a license file using an already loaded signer.
+ *
+ * @param hardwareId The hardware fingerprint or ID for the target machine.
+ * @param signer Signer holding the parsed private key.
+ * @param outputFile Path to save the generated license file.
+ * @param format Encoding of the license file.
+ * @param claims Expiry and features to sign into the license.
+ * @return true if license generation succeeds, false otherwise.
+ */
+bool LicenseGenerator::generateLicense(const std::string &hardwareId, LicenseSigner &signer,
+                                       const std::string &outputFile, LicenseFormat format,
+                                       const LicenseClaims &claims)
+{
+    if (!isValidHardwareId(hardwareId)) {
+        std::cerr << "❌ Invalid hardware ID (printable ASCII without spaces, quotes or backslashes expected).\n";
+        return false;
+    }
+
+    std::string signature;
+    if (!signer.signRaw(LicenseClaims::signingPayload(hardwareId, claims), signature)) {
+        return false;
+    }
+
+    // Save as JSON (or binary) license file
+    std::ofstream out(outputFile, std::ios::binary);
+    if (out.is_open()) {
+        out << buildLicense(hardwareId, signature, signer.algorithm(), format, claims, signer.kid());
+        out.close();
+    }
+    if (!out) {
+        // Covers a full disk or I/O error while writing or closing, not only a failed open
+        std::cerr << "❌ Could not write " << outputFile << ".\n";
+        return false;
+    }
+    return true;
+}
+
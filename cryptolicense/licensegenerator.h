@@ -0,0 +1,145 @@
+#ifndef LICENSEGENERATOR_H
+#define LICENSEGENERATOR_H
+
+#include <string>
+
+#include <licenseclaims.h>
+
+class LicenseSigner;
+
+/**
+ * @brief On-disk encoding of a generated license.
+ */
+enum class LicenseFormat
+{
+    Json,  ///< Pretty-printed JSON with a HEX signature (default)
+    Binary ///< Compact TLV encoding with a raw signature (see BinaryLicense)
+};
+
+/**
+ * @brief The LicenseGenerator class
+ *
+ * Provides functionality to generate a license file for a specific hardware ID.
+ * The license file includes the hardware ID, the signature algorithm (`alg`), the
+ * signing key ID (`kid`), the optional `expiresAt` and `features` claims and a digital signature generated
+ * using the provided private key (RSA, EC or Ed25519).
+ * The output is saved in JSON format, or optionally in the compact binary format.
+ */
+class LicenseGenerator
+{
+public:
+    /**
+     * @brief Generates a license file for the given hardware ID.
+     *
+     * This function creates a JSON license file containing:
+     * - The hardware ID of the target machine
+     * - The signature algorithm (`alg`, e.g. RS256 or EdDSA)
+     * - The expiry and feature claims, if any
+     * - A digital signature of the hardware ID and claims
+     *
+     * @param hardwareId The hardware fingerprint or ID to license.
+     * @param privateKeyPath Path to the private key file (`private_key.pem`) used for signing.
+     * @param outputFile Path to save the generated license file (`license.lic`).
+     * @param format Encoding of the license file.
+     * @param claims Expiry and features to sign into the license.
+     * @return true if license generation is successful, false otherwise.
+     */
+    static bool generateLicense(const std::string &hardwareId,
+                                const std::string &privateKeyPath,
+                                const std::string &outputFile,
+                                LicenseFormat format = LicenseFormat::Json,
+                                const LicenseClaims &claims = LicenseClaims());
+
+    /**
+     * @brief Generates a license file using an already loaded signer.
+     * @param hardwareId The hardware fingerprint or ID to license.
+     * @param signer Signer holding the parsed private key.
+     * @param outputFile Path to save the generated license file.
+     * @param format Encoding of the license file.
+     * @param claims Expiry and features to sign into the license.
+     * @return true if license generation is successful, false otherwise.
+     */
+    static bool generateLicense(const std::string &hardwareId,
+                                LicenseSigner &signer,
+                                const std::string &outputFile,
+                                LicenseFormat format = LicenseFormat::Json,
+                                const LicenseClaims &claims = LicenseClaims());
+
+    /**
+     * @brief Builds the JSON license document for a hardware ID and its signature.
+     * @param hardwareId The hardware fingerprint or ID.
+     * @param signatureHex HEX-encoded signature of LicenseClaims::signingPayload().
+     * @param algorithm Signature algorithm stored in the `alg` field.
+     * @param claims Claims stored in the `expiresAt` and `features` fields, if set.
+     * @param keyId Signing key ID stored in the `kid` field, if set.
+     * @param indent Indentation width; -1 for a single line (NDJSON).
+     * @return JSON license text.
+     */
+    static std::string buildLicenseJson(const std::string &hardwareId,
+                                        const std::string &signatureHex,
+                                        const std::string &algorithm,
+                                        const LicenseClaims &claims = LicenseClaims(),
+                                        const std::string &keyId = std::string(),
+                                        int indent = 4);
+
+    /**
+     * @brief Encodes a license in the requested format.
+     * @param hardwareId The hardware fingerprint or ID.
+     * @param signature Raw signature bytes.
+     * @param algorithm Signature algorithm.
+     * @param format Output encoding.
+     * @param claims Signed expiry and features.
+     * @param keyId Signing key ID (`kid`), if set.
+     * @return License file contents.
+     */
+    static std::string buildLicense(const std::string &hardwareId,
+                                    const std::string &signature,
+                                    const std::string &algorithm,
+                                    LicenseFormat format,
+                                    const LicenseClaims &claims = LicenseClaims(),
+                                    const std::string &keyId = std::string());
+
+    /**
+     * @brief Trims whitespace and line endings from both ends of an input line.
+     * @param line Raw input line.
+     * @return Trimmed hardware ID (empty for blank lines).
+     */
+    static std::string trimHardwareId(const std::string &line);
+
+    /**
+     * @brief Checks that a hardware ID may be signed.
+     *
+     * IDs are non-empty printable ASCII of at most 256 characters, without
+     * spaces, quotes or backslashes, so they never need escaping in a JSON
+     * license (LicenseParser rejects escaped fields).
+     *
+     * @param hardwareId Trimmed hardware ID.
+     * @return true if the ID may be signed.
+     */
+    static bool isValidHardwareId(const std::string &hardwareId);
+
+    /**
+     * @brief Splits a license request line into hardware ID and component hashes.
+     *
+     * A request line is `<hardwareId>[ <componentList>]`, as written to
+     * `hardware_id.txt` by the branch client; see LicenseClaims::componentList().
+     *
+     * @param line Raw input line.
+     * @param components Receives the component hashes; cleared if the line has none or they are malformed or incomplete.
+     * @return Trimmed hardware ID (empty for blank lines).
+     */
+    static std::string parseRequestLine(const std::string &line, LicenseClaims::ComponentHashes &components);
+
+    /**
+     * @brief Maps a hardware ID to a safe license file name.
+     *
+     * IDs other than lowercase `[a-z0-9_-]` are sanitized and get a hash of
+     * the ID appended, so different IDs never map to the same file.
+     *
+     * @param hardwareId The hardware fingerprint or ID.
+     * @return File name of the form `<hardwareId>.lic` or `<sanitized hardwareId>.<hash>.lic`.
+     */
+    static std::string licenseFileName(const std::string &hardwareId);
+};
+
+#endif // LICENSEGENERATOR_H
@@ -0,0 +1,88 @@
+#include "licensekeyring.h"
+
+#include <licensekeyid.h>
+
+/**
+ * @brief Constructs an empty keyring.
+ */
+LicenseKeyring::LicenseKeyring()
+    : m_order(), m_size(0)
+{
+}
+
+/**
+ * @brief Releases all keys.
+ */
+LicenseKeyring::~LicenseKeyring()
+{
+    clear();
+}
+
+/**
+ * @brief Adds a parsed public key.
+ *
+ * The key is indexed by LicenseKeyId::forKey(), so the server and the client
+ * agree on its ID without any configuration.
+ *
+ * @param key Parsed key (ownership is taken); freed if it is not added.
+ * @return true if the key is in the keyring afterwards (also when it already was).
+ */
+bool LicenseKeyring::add(EVP_PKEY *key)
+{
+    std::uint64_t id = 0;
+    if (!key || !LicenseKeyId::parse(LicenseKeyId::forKey(key), id) || m_size == Capacity) {
+        EVP_PKEY_free(key);
+        return false;
+    }
+
+    for (std::size_t probe = 0; probe < Capacity; ++probe) {
+        Slot &slot = m_slots[(static_cast<std::size_t>(id) + probe) & (Capacity - 1)];
+        if (slot.key && slot.id == id) {
+            // Same key loaded twice (e.g. public_key.pem also in public_keys/)
+            EVP_PKEY_free(key);
+            return true;
+        }
+        if (!slot.key) {
+            slot.id = id;
+            slot.key = key;
+            m_order[m_size++] = key;
+            return true;
+        }
+    }
+    EVP_PKEY_free(key);
+    return false;
+}
+
+/**
+ * @brief Releases all keys.
+ */
+void LicenseKeyring::clear()
+{
+    for (Slot &slot : m_slots) {
+        EVP_PKEY_free(slot.key);
+        slot = Slot();
+    }
+    m_order.fill(nullptr);
+    m_size = 0;
+}
+
+/**
+ * @brief Looks up a key by its ID.
+ * @param keyId `kid` from a license.
+ * @return The key, or nullptr if @p keyId is malformed or unknown.
+ */
+EVP_PKEY *LicenseKeyring::find(std::string_view keyId) const
+{
+    std::uint64_t id = 0;
+    if (!LicenseKeyId::parse(keyId, id))
+        return nullptr;
+
+    for (std::size_t probe = 0; probe < Capacity; ++probe) {
+        const Slot &slot = m_slots[(static_cast<std::size_t>(id) + probe) & (Capacity - 1)];
+        if (!slot.key)
+            return nullptr;
+        if (slot.id == id)
+            return slot.key;
+    }
+    return nullptr;
+}
@@ -0,0 +1,79 @@
+#ifndef LICENSEKEYRING_H
+#define LICENSEKEYRING_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <openssl/evp.h>
+
+/**
+ * @brief Small fixed-size map of key ID (`kid`) to parsed public key.
+ *
+ * Lets old and new signing keys coexist during a key rotation: each license
+ * names its key in the `kid` field and the verifier picks that key directly.
+ * A `kid` is already a hash prefix (see LicenseKeyId), so its low bits index
+ * an open-addressed table of Capacity slots; a lookup parses 16 HEX digits
+ * and probes one slot in the common case, independent of the number of keys.
+ *
+ * Not synchronized; LicenseVerifier guards its keyring with its own lock.
+ */
+class LicenseKeyring {
+public:
+    /// Maximum number of keys (a power of two).
+    static constexpr std::size_t Capacity = 16;
+
+    LicenseKeyring();
+    ~LicenseKeyring();
+
+    LicenseKeyring(const LicenseKeyring &) = delete;
+    LicenseKeyring &operator=(const LicenseKeyring &) = delete;
+
+    /**
+     * @brief Adds a parsed public key.
+     * @param key Parsed key (ownership is taken); freed if it is not added.
+     * @return true if the key is in the keyring afterwards (also when it already was).
+     */
+    bool add(EVP_PKEY *key);
+
+    /**
+     * @brief Releases all keys.
+     */
+    void clear();
+
+    /**
+     * @brief Looks up a key by its ID.
+     * @param keyId `kid` from a license.
+     * @return The key, or nullptr if @p keyId is malformed or unknown.
+     */
+    EVP_PKEY *find(std::string_view keyId) const;
+
+    /**
+     * @brief Returns the number of keys.
+     * @return Keys added since the last clear().
+     */
+    std::size_t size() const { return m_size; }
+
+    /**
+     * @brief Returns a key by position.
+     * @param index Position in insertion order; 0 is the first key added.
+     * @return The key, or nullptr if @p index is out of range.
+     */
+    EVP_PKEY *key(std::size_t index) const { return index < m_size ? m_order[index] : nullptr; }
+
+private:
+    /**
+     * @brief One table slot.
+     */
+    struct Slot {
+        std::uint64_t id = 0;    ///< Numeric `kid`
+        EVP_PKEY *key = nullptr; ///< Owned key; null for an empty slot
+    };
+
+    std::array<Slot, Capacity> m_slots;       ///< Open-addressed by the low bits of the `kid`
+    std::array<EVP_PKEY *, Capacity> m_order; ///< Keys in insertion order
+    std::size_t m_size;                       ///< Number of keys
+};
+
+#endif // LICENSEKEYRING_H
@@ -0,0 +1,361 @@
+#include "licenseparser.h"
+#include "licenseverifier.h"
+#include <binarylicense.h>
+#include <charconv>
+#include <cstdint>
+
+namespace {
+
+/// Nesting limit for values that are skipped, so hostile input cannot exhaust the stack.
+constexpr int MaxDepth = 32;
+
+/**
+ * @brief Forward-only JSON tokenizer over a borrowed buffer.
+ *
+ * Produces views of string and number tokens instead of building a DOM.
+ */
+class JsonScanner
+{
+public:
+    JsonScanner(const char *data, std::size_t size) : m_pos(data), m_end(data + size) {}
+
+    /**
+     * @brief Skips whitespace and consumes @p c if it is next.
+     * @param c Expected character.
+     * @return true if @p c was consumed.
+     */
+    bool consume(char c)
+    {
+        skipWhitespace();
+        if (m_pos == m_end || *m_pos != c)
+            return false;
+        ++m_pos;
+        return true;
+    }
+
+    /**
+     * @brief Returns the next non-whitespace character without consuming it.
+     * @return The character, or '\0' at the end of the data.
+     */
+    char peek()
+    {
+        skipWhitespace();
+        return m_pos == m_end ? '\0' : *m_pos;
+    }
+
+    /**
+     * @brief Checks whether only whitespace is left.
+     * @return true at the end of the data.
+     */
+    bool atEnd()
+    {
+        skipWhitespace();
+        return m_pos == m_end;
+    }
+
+    /**
+     * @brief Reads a string token.
+     * @param out Receives the raw contents between the quotes.
+     * @param escaped Set if the contents contain escape sequences.
+     * @return false if no well-formed string is next.
+     */
+    bool string(std::string_view &out, bool &escaped)
+    {
+        if (!consume('"'))
+            return false;
+        const char *begin = m_pos;
+        escaped = false;
+        while (m_pos != m_end && *m_pos != '"') {
+            if (static_cast<unsigned char>(*m_pos) < 0x20)
+                return false;
+            if (*m_pos == '\\') {
+                escaped = true;
+                if (++m_pos == m_end)
+                    return false;
+            }
+            ++m_pos;
+        }
+        if (m_pos == m_end)
+            return false;
+        out = std::string_view(begin, static_cast<std::size_t>(m_pos - begin));
+        ++m_pos;
+        return true;
+    }
+
+    /**
+     * @brief Reads a number token.
+     * @param out Receives the number as written.
+     * @return false if no number is next.
+     */
+    bool number(std::string_view &out)
+    {
+        skipWhitespace();
+        const char *begin = m_pos;
+        while (m_pos != m_end && ((*m_pos >= '0' && *m_pos <= '9') || *m_pos == '-' || *m_pos == '+' ||
+                                  *m_pos == '.' || *m_pos == 'e' || *m_pos == 'E'))
+            ++m_pos;
+        out = std::string_view(begin, static_cast<std::size_t>(m_pos - begin));
+        return !out.empty();
+    }
+
+    /**
+     * @brief Skips one value of any type.
+     * @param depth Current nesting depth.
+     * @return false if the value is malformed or nested too deeply.
+     */
+    bool skipValue(int depth = 0)
+    {
+        if (depth > MaxDepth)
+            return false;
+
+        std::string_view token;
+        bool escaped = false;
+        switch (peek()) {
+        case '"':
+            return string(token, escaped);
+        case '{':
+            ++m_pos;
+            if (consume('}'))
+                return true;
+            do {
+                if (!string(token, escaped) || !consume(':') || !skipValue(depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume('}');
+        case '[':
+            ++m_pos;
+            if (consume(']'))
+                return true;
+            do {
+                if (!skipValue(depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume(']');
+        case 't':
+            return literal("true");
+        case 'f':
+            return literal("false");
+        case 'n':
+            return literal("null");
+        default:
+            return number(token);
+        }
+    }
+
+private:
+    /**
+     * @brief Skips spaces, tabs and line breaks.
+     */
+    void skipWhitespace()
+    {
+        while (m_pos != m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r'))
+            ++m_pos;
+    }
+
+    /**
+     * @brief Consumes a keyword.
+     * @param word Keyword to expect.
+     * @return true if @p word was next.
+     */
+    bool literal(std::string_view word)
+    {
+        if (static_cast<std::size_t>(m_end - m_pos) < word.size() || std::string_view(m_pos, word.size()) != word)
+            return false;
+        m_pos += word.size();
+        return true;
+    }
+
+    const char *m_pos; ///< Next character to read
+    const char *m_end; ///< End of the data
+};
+
+/**
+ * @brief Stores a parse error, if the caller asked for one.
+ * @param error Error output; may be null.
+ * @param message Description of the problem.
+ * @return false, for use in return statements.
+ */
+bool fail(std::string *error, const char *message)
+{
+    if (error)
+        *error = message;
+    return false;
+}
+
+/**
+ * @brief Reads a string value that must not contain escape sequences.
+ * @param scanner Scanner positioned before the value.
+ * @param out Receives a view of the value.
+ * @return false if the value is not a plain string.
+ */
+bool plainString(JsonScanner &scanner, std::string_view &out)
+{
+    bool escaped = false;
+    return scanner.string(out, escaped) && !escaped;
+}
+
+/**
+ * @brief Parses an integer value.
+ * @param scanner Scanner positioned before the value.
+ * @param out Receives the value.
+ * @return false if the value is not an integer.
+ */
+bool integer(JsonScanner &scanner, std::int64_t &out)
+{
+    std::string_view token;
+    if (!scanner.number(token))
+        return false;
+    std::from_chars_result parsed = std::from_chars(token.data(), token.data() + token.size(), out);
+    return parsed.ec == std::errc() && parsed.ptr == token.data() + token.size();
+}
+
+/**
+ * @brief Parses a JSON license document in place.
+ * @param data License file contents.
+ * @param size Size of @p data in bytes.
+ * @param view Receives views into @p data.
+ * @param error Receives a description of the problem; may be null.
+ * @return false if the document is malformed.
+ */
+bool parseJson(const char *data, std::size_t size, LicenseParser::View &view, std::string *error)
+{
+    JsonScanner scanner(data, size);
+    if (!scanner.consume('{'))
+        return fail(error, "License is not a JSON object.");
+
+    std::string_view legacyFingerprint;
+    std::string features;
+    std::string components;
+    std::int64_t requiredMatches = 0;
+    if (!scanner.consume('}')) {
+        do {
+            std::string_view key;
+            bool escaped = false;
+            if (!scanner.string(key, escaped) || !scanner.consume(':'))
+                return fail(error, "Expected a field name.");
+
+            if (key == "hardwareFingerprint" || key == "hardwareId" || key == "signature" || key == "alg" ||
+                key == "kid") {
+                std::string_view value;
+                if (!plainString(scanner, value))
+                    return fail(error, "License fields must be plain strings.");
+                if (key == "hardwareFingerprint")
+                    view.fingerprint = value;
+                else if (key == "hardwareId")
+                    legacyFingerprint = value;
+                else if (key == "signature")
+                    view.signature = value;
+                else if (key == "alg")
+                    view.algorithm = value;
+                else
+                    view.keyId = value;
+            } else if (key == "expiresAt") {
+                if (!integer(scanner, view.claims.expiresAt))
+                    return fail(error, "expiresAt must be an integer.");
+            } else if (key == "match") {
+                if (!integer(scanner, requiredMatches) || requiredMatches < 0 ||
+                    requiredMatches > LicenseClaims::ComponentCount)
+                    return fail(error, "match must be a component count.");
+            } else if (key == "features") {
+                if (!scanner.consume('['))
+                    return fail(error, "features must be an array.");
+                features.clear();
+                if (!scanner.consume(']')) {
+                    do {
+                        std::string_view feature;
+                        if (!plainString(scanner, feature))
+                            return fail(error, "Features must be plain strings.");
+                        features.append(feature.data(), feature.size());
+                        features += ',';
+                    } while (scanner.consume(','));
+                    if (!scanner.consume(']'))
+                        return fail(error, "Unterminated features array.");
+                }
+            } else if (key == "components") {
+                if (!scanner.consume('{'))
+                    return fail(error, "components must be an object.");
+                components.clear();
+                if (!scanner.consume('}')) {
+                    do {
+                        std::string_view name;
+                        std::string_view hash;
+                        if (!plainString(scanner, name) || !scanner.consume(':') || !plainString(scanner, hash))
+                            return fail(error, "Components must map names to hashes.");
+                        if (!components.empty())
+                            components += ',';
+                        components.append(name.data(), name.size());
+                        components += ':';
+                        components.append(hash.data(), hash.size());
+                    } while (scanner.consume(','));
+                    if (!scanner.consume('}'))
+                        return fail(error, "Unterminated components object.");
+                }
+            } else if (!scanner.skipValue()) {
+                return fail(error, "Malformed JSON value.");
+            }
+        } while (scanner.consume(','));
+
+        if (!scanner.consume('}'))
+            return fail(error, "Unterminated JSON object.");
+    }
+    if (!scanner.atEnd())
+        return fail(error, "Unexpected data after the license object.");
+
+    // Backward compatibility with older "hardwareId" field
+    if (view.fingerprint.empty())
+        view.fingerprint = legacyFingerprint;
+
+    view.claims.features = LicenseClaims::parseFeatureList(features);
+    if (!LicenseClaims::parseComponentList(components, view.claims.components))
+        return fail(error, "Invalid hardware component hashes.");
+    view.claims.requiredMatches = static_cast<int>(requiredMatches);
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Parses a JSON or binary license in place.
+ * @param data License file contents.
+ * @param size Size of @p data in bytes.
+ * @param view Receives views into @p data.
+ * @param error Receives a description of the problem if parsing fails; may be null.
+ * @return false if the data is not a well-formed license.
+ */
+bool LicenseParser::parse(const char *data, std::size_t size, View &view, std::string *error)
+{
+    view = View();
+
+    if (!BinaryLicense::isBinary(data, size))
+        return parseJson(data, size, view, error);
+
+    // Compact binary license: already a flat record list
+    BinaryLicense::View binary;
+    if (!BinaryLicense::parse(data, size, binary))
+        return fail(error, "Binary license file is corrupted.");
+    view.fingerprint = binary.hardwareId;
+    view.rawSignature = binary.signature;
+    view.algorithm = binary.algorithm;
+    view.keyId = binary.keyId;
+    view.claims = BinaryLicense::claims(binary);
+    return true;
+}
+
+/**
+ * @brief Verifies a license's signature over its fingerprint and claims.
+ *
+ * The encoded signature is decoded straight from the view; no copy of it
+ * is made.
+ *
+ * @param view Parsed license.
+ * @param verifier Verifier holding the license public key(s).
+ * @return true if the signature is valid.
+ */
+bool LicenseParser::verify(const View &view, const LicenseVerifier &verifier)
+{
+    const std::string payload = LicenseClaims::signingPayload(view.fingerprint, view.claims);
+    if (view.rawSignature.empty())
+        return verifier.verify(payload, view.signature, view.algorithm, view.keyId);
+    return verifier.verifyRaw(payload, reinterpret_cast<const unsigned char *>(view.rawSignature.data()),
+                              view.rawSignature.size(), view.algorithm, view.keyId);
+}
@@ -0,0 +1,75 @@
+#ifndef LICENSEPARSER_H
+#define LICENSEPARSER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <licenseclaims.h>
+
+class LicenseVerifier;
+
+/**
+ * @brief Zero-copy parser for JSON and binary license files.
+ *
+ * Reads only the fields a license check needs. Strings are returned as
+ * views into the caller's buffer (typically a memory-mapped file or a
+ * compiled-in resource), so the signature goes from the file straight into
+ * SignatureDecoder and LicenseVerifier without being copied. Only the claims
+ * are materialized, since they are normalized before they are signed.
+ *
+ * The JSON scanner accepts any well-formed license document but does not
+ * decode escape sequences: fingerprints, signatures, algorithm and key IDs
+ * are plain ASCII, and an escaped value in one of them is reported as
+ * malformed rather than silently decoded.
+ */
+class LicenseParser {
+public:
+    /**
+     * @brief Fields of a parsed license.
+     *
+     * All views point into the buffer passed to parse() and are only valid
+     * while that buffer is.
+     */
+    struct View {
+        std::string_view fingerprint;  ///< Licensed hardware fingerprint
+        std::string_view signature;    ///< HEX/Base64 signature (JSON licenses)
+        std::string_view rawSignature; ///< Raw signature bytes (binary licenses)
+        std::string_view algorithm;    ///< Signature algorithm; empty for legacy RSA licenses
+        std::string_view keyId;        ///< Signing key ID (`kid`); empty for licenses issued before key rotation
+        LicenseClaims claims;          ///< Signed expiry, features and component hashes
+
+        /**
+         * @brief Checks whether the fields needed for verification are present.
+         * @return true if fingerprint and a signature are set.
+         */
+        bool isComplete() const
+        {
+            return !fingerprint.empty() && (!signature.empty() || !rawSignature.empty());
+        }
+    };
+
+    /**
+     * @brief Parses a JSON or binary license in place.
+     *
+     * JSON licenses accept both the `hardwareFingerprint` and the older
+     * `hardwareId` field.
+     *
+     * @param data License file contents.
+     * @param size Size of @p data in bytes.
+     * @param view Receives views into @p data.
+     * @param error Receives a description of the problem if parsing fails; may be null.
+     * @return false if the data is not a well-formed license; missing fields are not an error (see View::isComplete()).
+     */
+    static bool parse(const char *data, std::size_t size, View &view, std::string *error = nullptr);
+
+    /**
+     * @brief Verifies a license's signature over its fingerprint and claims.
+     * @param view Parsed license.
+     * @param verifier Verifier holding the license public key(s).
+     * @return true if the signature is valid.
+     */
+    static bool verify(const View &view, const LicenseVerifier &verifier);
+};
+
+#endif // LICENSEPARSER_H
@@ -0,0 +1,343 @@
+#include "licensesigner.h"
+#include <licensealgorithm.h>
+#include <licensekeyid.h>
+#include <openssl/pem.h>
+#include <openssl/store.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/provider.h>
+#endif
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+
+/**
+ * @brief Loads the first private key found at a key store URI.
+ *
+ * Credentials are taken from the URI (e.g. `pin-source=file:...`) or, if the
+ * store asks for them, from OpenSSL's default console prompt.
+ *
+ * @param uri OSSL_STORE URI, e.g. `pkcs11:object=license-key;type=private`.
+ * @return Key handle, or null if the store has no usable private key.
+ */
+static EVP_PKEY *loadStoreKey(const std::string &uri)
+{
+    OSSL_STORE_CTX *store = OSSL_STORE_open(uri.c_str(), nullptr, nullptr, nullptr, nullptr);
+    if (!store)
+        return nullptr;
+
+    OSSL_STORE_expect(store, OSSL_STORE_INFO_PKEY);
+    EVP_PKEY *privateKey = nullptr;
+    while (!privateKey && !OSSL_STORE_eof(store)) {
+        OSSL_STORE_INFO *info = OSSL_STORE_load(store);
+        if (!info) {
+            if (OSSL_STORE_error(store))
+                break;
+            continue;
+        }
+        if (OSSL_STORE_INFO_get_type(info) == OSSL_STORE_INFO_PKEY)
+            privateKey = OSSL_STORE_INFO_get1_PKEY(info);
+        OSSL_STORE_INFO_free(info);
+    }
+    OSSL_STORE_close(store);
+    return privateKey;
+}
+
+/**
+ * @brief Checks whether a key store URI names a local file.
+ * @param uri Key store URI.
+ * @return true for the `file:` scheme (in any case).
+ */
+static bool isFileUri(const std::string &uri)
+{
+    static const char scheme[] = "file:";
+    if (uri.size() < sizeof(scheme) - 1)
+        return false;
+    for (std::size_t i = 0; i < sizeof(scheme) - 1; ++i) {
+        if (std::tolower(static_cast<unsigned char>(uri[i])) != scheme[i])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs an empty signer. Call loadPrivateKey() before signing.
+ */
+LicenseSigner::LicenseSigner()
+    : m_privateKey(nullptr), m_hardware(false), m_ctx(EVP_MD_CTX_new())
+{
+}
+
+/**
+ * @brief Releases the private key and digest context.
+ */
+LicenseSigner::~LicenseSigner()
+{
+    EVP_MD_CTX_free(m_ctx);
+    EVP_PKEY_free(m_privateKey);
+}
+
+/**
+ * @brief Loads and parses the private key used for signing.
+ *
+ * Any previously loaded key is released. A key store URI is opened through
+ * OSSL_STORE; the URI is not printed on errors since it may carry a PIN.
+ *
+ * @param privateKeyPath Path to the private key file (`private_key.pem`), or a key store URI.
+ * @return true if the key was loaded, false otherwise.
+ */
+bool LicenseSigner::loadPrivateKey(const std::string &privateKeyPath)
+{
+    if (isKeyUri(privateKeyPath)) {
+        EVP_PKEY *privateKey = loadStoreKey(privateKeyPath);
+        if (!privateKey) {
+            std::cerr << "❌ Could not load the private key from its key store URI.\n";
+            return false;
+        }
+        if (!setPrivateKey(privateKey))
+            return false;
+        // OSSL_STORE also reads key files; only other schemes keep the key in a device
+        m_hardware = !isFileUri(privateKeyPath);
+        return true;
+    }
+
+    FILE* privKeyFile = fopen(privateKeyPath.c_str(), "r");
+    if (!privKeyFile) {
+        std::cerr << "❌ Could not open private_key.pem.\n";
+        return false;
+    }
+
+    EVP_PKEY* privateKey = PEM_read_PrivateKey(privKeyFile, nullptr, nullptr, nullptr);
+    fclose(privKeyFile);
+    if (!privateKey) {
+        std::cerr << "❌ Could not read private_key.pem.\n";
+        return false;
+    }
+
+    if (!setPrivateKey(privateKey))
+        return false;
+    m_hardware = false;
+    return true;
+}
+
+/**
+ * @brief Loads an OpenSSL provider, e.g. "pkcs11", for keys given as URI.
+ *
+ * Loading any provider explicitly stops OpenSSL from activating the default
+ * provider on demand, so it is loaded as well.
+ *
+ * @param name Provider name or path of the provider module.
+ * @return true if the provider is loaded, false otherwise (or before OpenSSL 3).
+ */
+bool LicenseSigner::loadProvider(const std::string &name)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if (!OSSL_PROVIDER_load(nullptr, name.c_str())) {
+        std::cerr << "❌ Could not load OpenSSL provider " << name << ".\n";
+        return false;
+    }
+    if (!OSSL_PROVIDER_available(nullptr, "default") && !OSSL_PROVIDER_load(nullptr, "default")) {
+        std::cerr << "❌ Could not load the default OpenSSL provider.\n";
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "❌ OpenSSL providers require OpenSSL 3.0 or later.\n";
+    return false;
+#endif
+}
+
+/**
+ * @brief Checks whether a key location is a key store URI rather than a file path.
+ * @param location Value passed to loadPrivateKey().
+ * @return true for `<scheme>:...` with a scheme of two or more characters.
+ */
+bool LicenseSigner::isKeyUri(const std::string &location)
+{
+    std::size_t colon = location.find(':');
+    if (colon == std::string::npos || colon < 2 || !std::isalpha(static_cast<unsigned char>(location[0])))
+        return false;
+    for (std::size_t i = 1; i < colon; ++i) {
+        unsigned char c = static_cast<unsigned char>(location[i]);
+        if (!std::isalnum(c) && c != '+' && c != '-' && c != '.')
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether the loaded key lives in a key store (HSM) instead of memory.
+ * @return true if the key was loaded from a URI other than `file:`.
+ */
+bool LicenseSigner::isHardwareBacked() const
+{
+    return m_hardware;
+}
+
+/**
+ * @brief Takes ownership of a parsed key if its type is supported.
+ * @param privateKey Parsed key; freed on failure.
+ * @return true if the key was accepted.
+ */
+bool LicenseSigner::setPrivateKey(EVP_PKEY *privateKey)
+{
+    std::string algorithm = LicenseAlgorithm::forKey(privateKey);
+    if (algorithm.empty()) {
+        std::cerr << "❌ Unsupported private key type.\n";
+        EVP_PKEY_free(privateKey);
+        return false;
+    }
+
+    std::string keyId = LicenseKeyId::thumbprint(privateKey);
+    if (keyId.empty()) {
+        std::cerr << "❌ Could not encode public key.\n";
+        EVP_PKEY_free(privateKey);
+        return false;
+    }
+
+    EVP_PKEY_free(m_privateKey);
+    m_privateKey = privateKey;
+    m_algorithm = algorithm;
+    m_keyId = keyId;
+    m_kid = keyId.substr(0, LicenseKeyId::Length);
+    m_sigBuf.resize(EVP_PKEY_size(m_privateKey));
+    return true;
+}
+
+/**
+ * @brief Gives this signer its own copy of another signer's private key.
+ *
+ * OpenSSL 3 duplicates the key so that no key state is shared between threads.
+ * OpenSSL 1.1.1 has no EVP_PKEY_dup(); there the key is shared by reference,
+ * which is safe because signing never modifies it. Hardware-backed keys are
+ * always shared by reference: the handle cannot be exported, and each
+ * signature gets its own provider session anyway.
+ *
+ * @param other Signer with a loaded private key.
+ * @return true if the key was copied, false otherwise.
+ */
+bool LicenseSigner::copyKeyFrom(const LicenseSigner &other)
+{
+    if (!other.m_privateKey) {
+        std::cerr << "❌ No private key loaded.\n";
+        return false;
+    }
+
+    EVP_PKEY *privateKey = other.m_privateKey;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if (!other.m_hardware)
+        privateKey = EVP_PKEY_dup(other.m_privateKey);
+    else
+        EVP_PKEY_up_ref(privateKey);
+    if (!privateKey) {
+        std::cerr << "❌ Could not duplicate private key.\n";
+        return false;
+    }
+#else
+    EVP_PKEY_up_ref(privateKey);
+#endif
+
+    if (!setPrivateKey(privateKey))
+        return false;
+    m_hardware = other.m_hardware;
+    return true;
+}
+
+/**
+ * @brief Checks whether a private key has been loaded.
+ * @return true if the signer is ready to sign.
+ */
+bool LicenseSigner::isLoaded() const
+{
+    return m_privateKey != nullptr && m_ctx != nullptr;
+}
+
+/**
+ * @brief Returns the license algorithm of the loaded key.
+ * @return JOSE algorithm name, or an empty string if no key is loaded.
+ */
+const std::string &LicenseSigner::algorithm() const
+{
+    return m_algorithm;
+}
+
+/**
+ * @brief Returns an identifier of the loaded key pair.
+ * @return Lowercase HEX SHA-256 of the DER-encoded public key, or an empty string if no key is loaded.
+ */
+const std::string &LicenseSigner::keyId() const
+{
+    return m_keyId;
+}
+
+/**
+ * @brief Returns the short key ID written into licenses as `kid`.
+ * @return LicenseKeyId::forKey() of the loaded key, or an empty string if no key is loaded.
+ */
+const std::string &LicenseSigner::kid() const
+{
+    return m_kid;
+}
+
+/**
+ * @brief Signs the given data with the loaded key.
+ *
+ * Uses the one-shot EVP_DigestSign() API, which covers RSA/ECDSA with a
+ * digest as well as Ed25519. RSA signatures are identical to the ones
+ * produced by the former EVP_SignFinal() code. The digest context is reset
+ * and re-initialised in place for every call.
+ *
+ * @param data Data to sign (the hardware ID).
+ * @param signature Receives the raw signature bytes.
+ * @return true if signing succeeded, false otherwise.
+ */
+bool LicenseSigner::signRaw(const std::string &data, std::string &signature)
+{
+    if (!isLoaded()) {
+        std::cerr << "❌ No private key loaded.\n";
+        return false;
+    }
+
+    size_t sigLen = m_sigBuf.size();
+    EVP_MD_CTX_reset(m_ctx);
+    if (EVP_DigestSignInit(m_ctx, nullptr, LicenseAlgorithm::digest(m_algorithm), nullptr, m_privateKey) != 1 ||
+        EVP_DigestSign(m_ctx, m_sigBuf.data(), &sigLen,
+                       reinterpret_cast<const unsigned char *>(data.c_str()), data.length()) != 1) {
+        std::cerr << "❌ Signing failed.\n";
+        return false;
+    }
+
+    signature.assign(reinterpret_cast<const char *>(m_sigBuf.data()), sigLen);
+    return true;
+}
+
+/**
+ * @brief Signs the given data with the loaded key.
+ * @param data Data to sign (the hardware ID).
+ * @param signatureHex Receives the signature as a lowercase HEX string.
+ * @return true if signing succeeded, false otherwise.
+ */
+bool LicenseSigner::sign(const std::string &data, std::string &signatureHex)
+{
+    std::string signature;
+    if (!signRaw(data, signature))
+        return false;
+    signatureHex = toHex(signature);
+    return true;
+}
+
+/**
+ * @brief Converts raw bytes to a lowercase HEX string.
+ * @param raw Raw bytes.
+ * @return HEX string of twice the length.
+ */
+std::string LicenseSigner::toHex(const std::string &raw)
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(raw.size() * 2, '0');
+    for (size_t i = 0; i < raw.size(); ++i) {
+        unsigned char byte = static_cast<unsigned char>(raw[i]);
+        hex[2 * i] = digits[byte >> 4];
+        hex[2 * i + 1] = digits[byte & 0x0F];
+    }
+    return hex;
+}
@@ -0,0 +1,145 @@
+#ifndef LICENSESIGNER_H
+#define LICENSESIGNER_H
+
+#include <string>
+#include <vector>
+
+#include <openssl/evp.h>
+
+/**
+ * @brief The LicenseSigner class
+ *
+ * Holds a parsed private key and a reusable digest context so that many
+ * licenses can be signed without re-reading `private_key.pem` for each one.
+ * The signature algorithm follows the key type: RSA (RS256), EC (ES256/384/512)
+ * or Ed25519 (EdDSA). A signer is not thread-safe; use one instance per thread.
+ *
+ * Instead of a PEM file, the key can be given as an OSSL_STORE URI such as
+ * `pkcs11:token=licensing;object=license-key` (OpenSSL 3 with a PKCS#11
+ * provider, see loadProvider()). The key then stays in the HSM: the signer
+ * only holds a handle, and every signature is computed by the device. A
+ * signature blocks the calling thread until the device answers, so a caller
+ * that wants N signatures in flight needs N signers on N threads. Since HSM
+ * signing waits on the device rather than the CPU, callers start
+ * DefaultHardwareSessions threads by default. A `file:` URI names a key
+ * file and is treated like a path.
+ */
+class LicenseSigner
+{
+public:
+    /// Threads (each with its own signer) used for a hardware-backed key when no thread count is given.
+    static constexpr unsigned DefaultHardwareSessions = 16;
+
+    LicenseSigner();
+    ~LicenseSigner();
+
+    LicenseSigner(const LicenseSigner &) = delete;
+    LicenseSigner &operator=(const LicenseSigner &) = delete;
+
+    /**
+     * @brief Loads and parses the private key used for signing.
+     * @param privateKeyPath Path to the private key file (`private_key.pem`), or a key store URI (see isKeyUri()).
+     * @return true if the key was loaded and its type is supported, false otherwise.
+     */
+    bool loadPrivateKey(const std::string &privateKeyPath);
+
+    /**
+     * @brief Loads an OpenSSL provider, e.g. "pkcs11", for keys given as URI.
+     *
+     * The default provider stays available for digests and verification.
+     * Not needed if the provider is already activated in `openssl.cnf`.
+     *
+     * @param name Provider name or path of the provider module.
+     * @return true if the provider is loaded, false otherwise (or before OpenSSL 3).
+     */
+    static bool loadProvider(const std::string &name);
+
+    /**
+     * @brief Checks whether a key location is a key store URI rather than a file path.
+     * @param location Value passed to loadPrivateKey().
+     * @return true for `<scheme>:...` with a scheme of two or more characters (so `C:\...` stays a path).
+     */
+    static bool isKeyUri(const std::string &location);
+
+    /**
+     * @brief Checks whether the loaded key lives in a key store (HSM) instead of memory.
+     * @return true if the key was loaded from a URI other than `file:`.
+     */
+    bool isHardwareBacked() const;
+
+    /**
+     * @brief Gives this signer its own copy of another signer's private key.
+     *
+     * Used to hand each worker thread an independent key and digest context
+     * without parsing the PEM file again.
+     *
+     * @param other Signer with a loaded private key.
+     * @return true if the key was copied, false otherwise.
+     */
+    bool copyKeyFrom(const LicenseSigner &other);
+
+    /**
+     * @brief Checks whether a private key has been loaded.
+     * @return true if the signer is ready to sign.
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief Returns the license algorithm of the loaded key.
+     * @return JOSE algorithm name (e.g. "RS256", "EdDSA"), or an empty string if no key is loaded.
+     */
+    const std::string &algorithm() const;
+
+    /**
+     * @brief Returns an identifier of the loaded key pair.
+     * @return Lowercase HEX SHA-256 of the DER-encoded public key, or an empty string if no key is loaded.
+     */
+    const std::string &keyId() const;
+
+    /**
+     * @brief Returns the short key ID written into licenses as `kid`.
+     * @return LicenseKeyId::forKey() of the loaded key, or an empty string if no key is loaded.
+     */
+    const std::string &kid() const;
+
+    /**
+     * @brief Signs the given data with the loaded key.
+     * @param data Data to sign (the hardware ID).
+     * @param signatureHex Receives the signature as a lowercase HEX string.
+     * @return true if signing succeeded, false otherwise.
+     */
+    bool sign(const std::string &data, std::string &signatureHex);
+
+    /**
+     * @brief Signs the given data and returns the raw signature bytes.
+     * @param data Data to sign (the hardware ID).
+     * @param signature Receives the raw signature.
+     * @return true if signing succeeded, false otherwise.
+     */
+    bool signRaw(const std::string &data, std::string &signature);
+
+    /**
+     * @brief Converts raw bytes to a lowercase HEX string.
+     * @param raw Raw bytes.
+     * @return HEX string of twice the length.
+     */
+    static std::string toHex(const std::string &raw);
+
+private:
+    /**
+     * @brief Takes ownership of a parsed key if its type is supported.
+     * @param privateKey Parsed key; freed on failure.
+     * @return true if the key was accepted.
+     */
+    bool setPrivateKey(EVP_PKEY *privateKey);
+
+    EVP_PKEY *m_privateKey;              ///< Parsed private key
+    std::string m_algorithm;             ///< License algorithm matching m_privateKey
+    std::string m_keyId;                 ///< SHA-256 of m_privateKey's public half
+    std::string m_kid;                   ///< Prefix of m_keyId stored in licenses
+    bool m_hardware;                     ///< true if m_privateKey is a handle to a key store key
+    EVP_MD_CTX *m_ctx;                   ///< Digest context reused for every signature
+    std::vector<unsigned char> m_sigBuf; ///< Scratch buffer sized to the key
+};
+
+#endif // LICENSESIGNER_H
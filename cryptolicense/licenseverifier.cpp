@@ -0,0 +1,230 @@
+#include "licenseverifier.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+#include <licensealgorithm.h>
+
+#include <openssl/bio.h>
+#include <openssl/pem.h>
+
+/**
+ * @brief Constructs a verifier without a key. Load one before calling verify().
+ */
+LicenseVerifier::LicenseVerifier() = default;
+
+/**
+ * @brief Releases the public keys.
+ */
+LicenseVerifier::~LicenseVerifier() = default;
+
+/**
+ * @brief Stores a parsed key.
+ * @param publicKey Newly parsed key (ownership is taken); may be null.
+ * @param replace Release all previously loaded keys first.
+ * @return true if @p publicKey was accepted.
+ */
+bool LicenseVerifier::setPublicKey(EVP_PKEY *publicKey, bool replace)
+{
+    if (!publicKey)
+        return false;
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (replace)
+        m_keyring.clear();
+    return m_keyring.add(publicKey);
+}
+
+/**
+ * @brief Loads and parses a PEM public key file, replacing all loaded keys.
+ * @param publicKeyPath Path to the public key file (`public_key.pem`).
+ * @return true if the key was loaded, false otherwise.
+ */
+bool LicenseVerifier::loadPublicKey(const std::string &publicKeyPath)
+{
+    FILE *pubKeyFile = fopen(publicKeyPath.c_str(), "r");
+    if (!pubKeyFile) return false;
+
+    EVP_PKEY *pubKey = PEM_read_PUBKEY(pubKeyFile, nullptr, nullptr, nullptr);
+    fclose(pubKeyFile);
+    return setPublicKey(pubKey, true);
+}
+
+/**
+ * @brief Parses a PEM public key held in memory, replacing all loaded keys.
+ * @param pem PEM text.
+ * @param length Length of @p pem in bytes.
+ * @return true if the key was loaded, false otherwise.
+ */
+bool LicenseVerifier::loadPublicKeyFromMemory(const char *pem, std::size_t length)
+{
+    BIO *bio = BIO_new_mem_buf(pem, static_cast<int>(length));
+    if (!bio) return false;
+
+    EVP_PKEY *pubKey = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+    return setPublicKey(pubKey, true);
+}
+
+/**
+ * @brief Adds another PEM public key file to the keyring.
+ * @param publicKeyPath Path to the public key file.
+ * @return true if the key was added, false otherwise.
+ */
+bool LicenseVerifier::addPublicKey(const std::string &publicKeyPath)
+{
+    FILE *pubKeyFile = fopen(publicKeyPath.c_str(), "r");
+    if (!pubKeyFile) return false;
+
+    EVP_PKEY *pubKey = PEM_read_PUBKEY(pubKeyFile, nullptr, nullptr, nullptr);
+    fclose(pubKeyFile);
+    return setPublicKey(pubKey, false);
+}
+
+/**
+ * @brief Adds another PEM public key held in memory to the keyring.
+ * @param pem PEM text.
+ * @param length Length of @p pem in bytes.
+ * @return true if the key was added, false otherwise.
+ */
+bool LicenseVerifier::addPublicKeyFromMemory(const char *pem, std::size_t length)
+{
+    BIO *bio = BIO_new_mem_buf(pem, static_cast<int>(length));
+    if (!bio) return false;
+
+    EVP_PKEY *pubKey = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+    return setPublicKey(pubKey, false);
+}
+
+/**
+ * @brief Checks whether a public key has been loaded.
+ * @return true if the verifier is ready.
+ */
+bool LicenseVerifier::isLoaded() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_keyring.size() > 0;
+}
+
+/**
+ * @brief Returns the number of loaded keys.
+ * @return Size of the keyring.
+ */
+std::size_t LicenseVerifier::keyCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_keyring.size();
+}
+
+/**
+ * @brief Verifies a license signature against the loaded public key.
+ *
+ * Thread-safe. The signature is decoded into a stack buffer, the parsed key
+ * is shared read-only between callers and each thread keeps one digest
+ * context that is reset for every call.
+ *
+ * @param fingerprint The signed data: the hardware fingerprint, or LicenseClaims::signingPayload() for licenses with claims.
+ * @param signature The license signature (HEX or Base64 encoded).
+ * @param algorithm The license's `alg` field; empty for legacy RSA licenses.
+ * @param keyId The license's `kid` field; empty to try every loaded key.
+ * @return true if the signature is valid, false otherwise.
+ */
+bool LicenseVerifier::verify(std::string_view fingerprint, std::string_view signature, std::string_view algorithm,
+                             std::string_view keyId) const
+{
+    SignatureDecoder::Buffer decoded;
+    std::size_t decodedLength = 0;
+    if (!SignatureDecoder::decode(signature, decoded, decodedLength))
+        return false;
+
+    return verifyRaw(fingerprint, decoded.data(), decodedLength, algorithm, keyId);
+}
+
+/**
+ * @brief Verifies a signature with one key; the caller holds m_mutex.
+ *
+ * The algorithm must match the type of the key, so a license cannot select
+ * a weaker or different scheme than the key implies.
+ *
+ * @param key Public key.
+ * @param algorithm Expected algorithm; must match the key type.
+ * @param data Signed data.
+ * @param signature Raw signature bytes.
+ * @param signatureLength Number of bytes in @p signature.
+ * @return true if the signature is valid.
+ */
+bool LicenseVerifier::verifyWithKey(EVP_PKEY *key, std::string_view algorithm, std::string_view data,
+                                    const unsigned char *signature, std::size_t signatureLength)
+{
+    thread_local std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+    if (!ctx || !key || LicenseAlgorithm::forKey(key) != algorithm)
+        return false;
+
+    EVP_MD_CTX_reset(ctx.get());
+    if (EVP_DigestVerifyInit(ctx.get(), nullptr, LicenseAlgorithm::digest(algorithm), nullptr, key) != 1)
+        return false;
+
+    return EVP_DigestVerify(ctx.get(), signature, signatureLength,
+                            reinterpret_cast<const unsigned char *>(data.data()), data.size()) == 1;
+}
+
+/**
+ * @brief Verifies an already decoded signature against the loaded public key.
+ *
+ * With a `kid`, only the key of that ID is used and an unknown `kid` fails
+ * without any signature check. Without one, every loaded key is tried.
+ * Thread-safe; see verify().
+ *
+ * @param fingerprint The signed data: the hardware fingerprint, or LicenseClaims::signingPayload() for licenses with claims.
+ * @param signature Raw signature bytes.
+ * @param signatureLength Number of bytes in @p signature.
+ * @param algorithm The license's `alg` field; empty for legacy RSA licenses.
+ * @param keyId The license's `kid` field; empty to try every loaded key.
+ * @return true if the signature is valid, false otherwise.
+ */
+bool LicenseVerifier::verifyRaw(std::string_view fingerprint, const unsigned char *signature, std::size_t signatureLength,
+                                std::string_view algorithm, std::string_view keyId) const
+{
+    const std::string_view expected = algorithm.empty() ? std::string_view(LicenseAlgorithm::legacy()) : algorithm;
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    if (!keyId.empty())
+        return verifyWithKey(m_keyring.find(keyId), expected, fingerprint, signature, signatureLength);
+
+    for (std::size_t i = 0; i < m_keyring.size(); ++i) {
+        if (verifyWithKey(m_keyring.key(i), expected, fingerprint, signature, signatureLength))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Verifies data signed with any loaded key, using that key's own algorithm.
+ * @param data Signed data.
+ * @param signature Raw signature bytes.
+ * @param signatureLength Number of bytes in @p signature.
+ * @return true if one of the keys accepts the signature.
+ */
+bool LicenseVerifier::verifyRawWithAnyKey(std::string_view data, const unsigned char *signature,
+                                          std::size_t signatureLength) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (std::size_t i = 0; i < m_keyring.size(); ++i) {
+        EVP_PKEY *key = m_keyring.key(i);
+        if (verifyWithKey(key, LicenseAlgorithm::forKey(key), data, signature, signatureLength))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the license algorithm matching the first loaded key.
+ * @return JOSE algorithm name, or an empty string if no supported key is loaded.
+ */
+std::string LicenseVerifier::algorithm() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return LicenseAlgorithm::forKey(m_keyring.key(0));
+}
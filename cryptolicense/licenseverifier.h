@@ -0,0 +1,144 @@
+#ifndef LICENSEVERIFIER_H
+#define LICENSEVERIFIER_H
+
+#include <cstddef>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+#include "licensekeyring.h"
+#include "signaturedecoder.h"
+
+#include <openssl/evp.h>
+
+/**
+ * @brief Reusable license signature verifier.
+ *
+ * Parses the public key once, either from `public_key.pem` or from PEM text in
+ * memory (such as a key compiled into the binary), and keeps it alive for the
+ * lifetime of the object.
+ * RSA (RS256), ECDSA (ES256/384/512) and Ed25519 (EdDSA) keys are supported.
+ * verify() performs no file I/O and may be called concurrently from several
+ * threads; each thread reuses its own digest context.
+ *
+ * Further keys can be added with addPublicKey() for key rotation. Licenses
+ * carrying a `kid` are checked against that key only (a LicenseKeyring
+ * lookup); licenses issued before `kid` existed are tried against every key.
+ */
+class LicenseVerifier {
+public:
+    LicenseVerifier();
+    ~LicenseVerifier();
+
+    LicenseVerifier(const LicenseVerifier &) = delete;
+    LicenseVerifier &operator=(const LicenseVerifier &) = delete;
+
+    /**
+     * @brief Loads and parses a PEM public key file, replacing all loaded keys.
+     * @param publicKeyPath Path to the public key file (`public_key.pem`).
+     * @return true if the key was loaded, false otherwise.
+     */
+    bool loadPublicKey(const std::string &publicKeyPath);
+
+    /**
+     * @brief Parses a PEM public key held in memory, replacing all loaded keys.
+     * @param pem PEM text.
+     * @param length Length of @p pem in bytes.
+     * @return true if the key was loaded, false otherwise.
+     */
+    bool loadPublicKeyFromMemory(const char *pem, std::size_t length);
+
+    /**
+     * @brief Adds another PEM public key file to the keyring.
+     * @param publicKeyPath Path to the public key file.
+     * @return true if the key was added, false otherwise.
+     */
+    bool addPublicKey(const std::string &publicKeyPath);
+
+    /**
+     * @brief Adds another PEM public key held in memory to the keyring.
+     * @param pem PEM text.
+     * @param length Length of @p pem in bytes.
+     * @return true if the key was added, false otherwise.
+     */
+    bool addPublicKeyFromMemory(const char *pem, std::size_t length);
+
+    /**
+     * @brief Returns the number of loaded keys.
+     * @return Size of the keyring.
+     */
+    std::size_t keyCount() const;
+
+    /**
+     * @brief Checks whether a public key has been loaded.
+     * @return true if the verifier is ready.
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief Verifies a license signature against the loaded public key.
+     * @param fingerprint The signed data: the hardware fingerprint, or LicenseClaims::signingPayload() for licenses with claims.
+     * @param signature The license signature (HEX or Base64 encoded).
+     * @param algorithm The license's `alg` field; empty for legacy RSA licenses.
+     * @param keyId The license's `kid` field; empty to try every loaded key.
+     * @return true if the signature is valid, false otherwise.
+     */
+    bool verify(std::string_view fingerprint, std::string_view signature, std::string_view algorithm = std::string_view(),
+                std::string_view keyId = std::string_view()) const;
+
+    /**
+     * @brief Verifies an already decoded signature against the loaded public key.
+     * @param fingerprint The signed data: the hardware fingerprint, or LicenseClaims::signingPayload() for licenses with claims.
+     * @param signature Raw signature bytes.
+     * @param signatureLength Number of bytes in @p signature.
+     * @param algorithm The license's `alg` field; empty for legacy RSA licenses.
+     * @param keyId The license's `kid` field; empty to try every loaded key.
+     * @return true if the signature is valid, false otherwise.
+     */
+    bool verifyRaw(std::string_view fingerprint, const unsigned char *signature, std::size_t signatureLength,
+                   std::string_view algorithm = std::string_view(), std::string_view keyId = std::string_view()) const;
+
+    /**
+     * @brief Verifies data signed with any loaded key, using that key's own algorithm.
+     *
+     * For signed files that carry no `alg` or `kid`, such as revocation lists.
+     *
+     * @param data Signed data.
+     * @param signature Raw signature bytes.
+     * @param signatureLength Number of bytes in @p signature.
+     * @return true if one of the keys accepts the signature.
+     */
+    bool verifyRawWithAnyKey(std::string_view data, const unsigned char *signature, std::size_t signatureLength) const;
+
+    /**
+     * @brief Returns the license algorithm matching the first loaded key.
+     * @return JOSE algorithm name, or an empty string if no supported key is loaded.
+     */
+    std::string algorithm() const;
+
+private:
+    /**
+     * @brief Stores a parsed key.
+     * @param publicKey Newly parsed key (ownership is taken); may be null.
+     * @param replace Release all previously loaded keys first.
+     * @return true if @p publicKey was accepted.
+     */
+    bool setPublicKey(EVP_PKEY *publicKey, bool replace);
+
+    /**
+     * @brief Verifies a signature with one key; the caller holds m_mutex.
+     * @param key Public key.
+     * @param algorithm Expected algorithm; must match the key type.
+     * @param data Signed data.
+     * @param signature Raw signature bytes.
+     * @param signatureLength Number of bytes in @p signature.
+     * @return true if the signature is valid.
+     */
+    static bool verifyWithKey(EVP_PKEY *key, std::string_view algorithm, std::string_view data,
+                              const unsigned char *signature, std::size_t signatureLength);
+
+    LicenseKeyring m_keyring;          ///< Parsed public keys by `kid`
+    mutable std::shared_mutex m_mutex; ///< Guards m_keyring against concurrent reloads
+};
+
+#endif // LICENSEVERIFIER_H
@@ -0,0 +1,337 @@
+#include "nativeprobe.h"
+
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+#ifdef _WIN32
+#include <cstdio>
+#include <cstring>
+#include <windows.h>
+#include <winioctl.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <linux/hdreg.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <CoreFoundation/CoreFoundation.h>
+#include <IOKit/IOKitLib.h>
+#endif
+
+/**
+ * @brief Removes leading and trailing whitespace and NUL padding.
+ * @param value Raw identifier.
+ * @return Trimmed identifier.
+ */
+static std::string trimIdentifier(const std::string &value) {
+    auto isPadding = [](char c) { return c == '\0' || std::isspace(static_cast<unsigned char>(c)); };
+    auto begin = std::find_if_not(value.begin(), value.end(), isPadding);
+    auto end = std::find_if_not(value.rbegin(), value.rend(), isPadding).base();
+    return begin < end ? std::string(begin, end) : std::string();
+}
+
+#ifdef _WIN32
+
+/**
+ * @brief Reads the serial number of `\\.\PhysicalDrive0` via IOCTL_STORAGE_QUERY_PROPERTY.
+ *
+ * The device is opened without access rights, which is enough for this
+ * query and does not require administrator privileges.
+ *
+ * @return Disk serial number, or an empty string.
+ */
+static std::string storageQuerySerial() {
+    HANDLE device = CreateFileW(L"\\\\.\\PhysicalDrive0", 0, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                nullptr, OPEN_EXISTING, 0, nullptr);
+    if (device == INVALID_HANDLE_VALUE)
+        return "";
+
+    STORAGE_PROPERTY_QUERY query = {};
+    query.PropertyId = StorageDeviceProperty;
+    query.QueryType = PropertyStandardQuery;
+
+    std::vector<char> buffer(1024);
+    DWORD returned = 0;
+    BOOL ok = DeviceIoControl(device, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query),
+                              buffer.data(), static_cast<DWORD>(buffer.size()), &returned, nullptr);
+    CloseHandle(device);
+    if (!ok || returned < sizeof(STORAGE_DEVICE_DESCRIPTOR))
+        return "";
+
+    const STORAGE_DEVICE_DESCRIPTOR *descriptor = reinterpret_cast<const STORAGE_DEVICE_DESCRIPTOR *>(buffer.data());
+    if (descriptor->SerialNumberOffset == 0 || descriptor->SerialNumberOffset >= returned)
+        return "";
+
+    const char *serial = buffer.data() + descriptor->SerialNumberOffset;
+    size_t maxLen = returned - descriptor->SerialNumberOffset;
+    return trimIdentifier(std::string(serial, strnlen(serial, maxLen)));
+}
+
+/**
+ * @brief Reads the volume serial number of drive C: in the `XXXX-XXXX` form printed by `vol`.
+ * @return Volume serial number, or an empty string.
+ */
+static std::string volumeSerial() {
+    DWORD serial = 0;
+    if (!GetVolumeInformationA("C:\\", nullptr, 0, &serial, nullptr, nullptr, nullptr, 0))
+        return "";
+
+    char formatted[10];
+    snprintf(formatted, sizeof(formatted), "%04lX-%04lX",
+             static_cast<unsigned long>(serial >> 16), static_cast<unsigned long>(serial & 0xFFFF));
+    return formatted;
+}
+
+#elif defined(__linux__)
+
+/**
+ * @brief Reads the first line of a file.
+ * @param path File to read.
+ * @return First line, or an empty string if the file cannot be read.
+ */
+static std::string readFirstLine(const std::string &path) {
+    std::string line;
+    std::ifstream file(path);
+    if (file.is_open())
+        std::getline(file, line);
+    return line;
+}
+
+/**
+ * @brief Lists physical block devices in `/sys/block`, sorted by name.
+ *
+ * Virtual devices (loop, ram, zram, device-mapper, md, optical and floppy)
+ * are skipped.
+ *
+ * @return Device names such as `sda` or `nvme0n1`.
+ */
+static std::vector<std::string> physicalBlockDevices() {
+    static const char *virtualPrefixes[] = {"loop", "ram", "zram", "dm-", "md", "sr", "fd"};
+
+    std::vector<std::string> devices;
+    DIR *dir = opendir("/sys/block");
+    if (!dir)
+        return devices;
+
+    while (dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.empty() || name[0] == '.')
+            continue;
+        bool isVirtual = false;
+        for (const char *prefix : virtualPrefixes) {
+            if (name.compare(0, std::char_traits<char>::length(prefix), prefix) == 0) {
+                isVirtual = true;
+                break;
+            }
+        }
+        if (!isVirtual)
+            devices.push_back(name);
+    }
+    closedir(dir);
+
+    std::sort(devices.begin(), devices.end());
+    return devices;
+}
+
+/**
+ * @brief Reads `ID_SERIAL_SHORT` from the udev database, which is what `lsblk -o serial` prints.
+ * @param device Block device name.
+ * @return Disk serial number, or an empty string.
+ */
+static std::string udevSerial(const std::string &device) {
+    std::string devNumber = readFirstLine("/sys/block/" + device + "/dev");
+    if (devNumber.empty())
+        return "";
+
+    std::ifstream file("/run/udev/data/b" + devNumber);
+    if (!file.is_open())
+        return "";
+
+    static const std::string key = "E:ID_SERIAL_SHORT=";
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, key.size(), key) == 0)
+            return trimIdentifier(line.substr(key.size()));
+    }
+    return "";
+}
+
+/**
+ * @brief Reads the serial number exported by the kernel in sysfs.
+ *
+ * Tries `device/serial` (NVMe, virtio, some SCSI) and then the unit serial
+ * number VPD page `device/vpd_pg80` (SCSI/SATA).
+ *
+ * @param device Block device name.
+ * @return Disk serial number, or an empty string.
+ */
+static std::string sysfsSerial(const std::string &device) {
+    std::string serial = trimIdentifier(readFirstLine("/sys/block/" + device + "/device/serial"));
+    if (!serial.empty())
+        return serial;
+
+    std::ifstream vpd("/sys/block/" + device + "/device/vpd_pg80", std::ios::binary);
+    if (!vpd.is_open())
+        return "";
+    std::vector<char> page((std::istreambuf_iterator<char>(vpd)), std::istreambuf_iterator<char>());
+    if (page.size() < 4)
+        return "";
+    size_t length = std::min(static_cast<size_t>(static_cast<unsigned char>(page[3])), page.size() - 4);
+    return trimIdentifier(std::string(page.data() + 4, length));
+}
+
+/**
+ * @brief Reads the ATA serial number with `ioctl(HDIO_GET_IDENTITY)`.
+ *
+ * Requires read access to the device node, so this usually only succeeds
+ * for privileged users.
+ *
+ * @param device Block device name.
+ * @return Disk serial number, or an empty string.
+ */
+static std::string ioctlSerial(const std::string &device) {
+    int fd = open(("/dev/" + device).c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0)
+        return "";
+
+    struct hd_driveid identity = {};
+    int rc = ioctl(fd, HDIO_GET_IDENTITY, &identity);
+    close(fd);
+    if (rc != 0)
+        return "";
+
+    const char *serial = reinterpret_cast<const char *>(identity.serial_no);
+    return trimIdentifier(std::string(serial, sizeof(identity.serial_no)));
+}
+
+#elif defined(__APPLE__)
+
+/**
+ * @brief Reads a string property from a CFDictionary.
+ * @param dict Dictionary to query.
+ * @param key Property key.
+ * @return Property value, or an empty string.
+ */
+static std::string dictionaryString(CFDictionaryRef dict, CFStringRef key) {
+    CFTypeRef value = CFDictionaryGetValue(dict, key);
+    if (!value || CFGetTypeID(value) != CFStringGetTypeID())
+        return "";
+
+    char buffer[256];
+    if (!CFStringGetCString(static_cast<CFStringRef>(value), buffer, sizeof(buffer), kCFStringEncodingUTF8))
+        return "";
+    return buffer;
+}
+
+/**
+ * @brief Reads the serial number of the first block storage device from the IOKit registry.
+ * @return Disk serial number, or an empty string.
+ */
+static std::string ioKitSerial() {
+    io_iterator_t iterator = 0;
+    // Port 0 (MACH_PORT_NULL) selects the default main port on every macOS version
+    if (IOServiceGetMatchingServices(0, IOServiceMatching("IOBlockStorageDevice"), &iterator) != KERN_SUCCESS)
+        return "";
+
+    std::string serial;
+    while (serial.empty()) {
+        io_object_t device = IOIteratorNext(iterator);
+        if (!device)
+            break;
+
+        CFTypeRef characteristics = IORegistryEntryCreateCFProperty(device, CFSTR("Device Characteristics"),
+                                                                    kCFAllocatorDefault, 0);
+        if (characteristics) {
+            if (CFGetTypeID(characteristics) == CFDictionaryGetTypeID())
+                serial = trimIdentifier(dictionaryString(static_cast<CFDictionaryRef>(characteristics), CFSTR("Serial Number")));
+            CFRelease(characteristics);
+        }
+        IOObjectRelease(device);
+    }
+    IOObjectRelease(iterator);
+    return serial;
+}
+
+#endif
+
+/**
+ * @brief Reads the serial number of the first physical disk.
+ *
+ * Platform order:
+ * - Windows: storage descriptor of PhysicalDrive0, then the C: volume serial
+ * - Linux: for each physical disk, udev database, sysfs, then HDIO_GET_IDENTITY
+ * - macOS: IOKit "Device Characteristics" of the first block storage device
+ *
+ * @return Disk serial number, or an empty string if unavailable.
+ */
+std::string NativeProbe::getDiskSerialNumber() {
+#ifdef _WIN32
+    std::string serial = storageQuerySerial();
+    if (serial.empty())
+        serial = volumeSerial();
+    return serial;
+
+#elif defined(__linux__)
+    for (const std::string &device : physicalBlockDevices()) {
+        std::string serial = udevSerial(device);
+        if (serial.empty())
+            serial = sysfsSerial(device);
+        if (serial.empty())
+            serial = ioctlSerial(device);
+        if (!serial.empty())
+            return serial;
+    }
+    return "";
+
+#elif defined(__APPLE__)
+    return ioKitSerial();
+
+#else
+    return "";
+#endif
+}
+
+/**
+ * @brief Reads the CPU identifier.
+ *
+ * - Linux: the `processor` entry of `/proc/cpuinfo`, then `model name`
+ * - macOS: `sysctlbyname("machdep.cpu.brand_string")`
+ * - Windows: not handled here; HardwareLock uses the CPUID instruction directly
+ *
+ * @return CPU identifier, or an empty string if unavailable.
+ */
+std::string NativeProbe::getCpuId() {
+#if defined(__linux__)
+    std::ifstream file("/proc/cpuinfo");
+    if (!file.is_open())
+        return "";
+
+    std::string processor;
+    std::string modelName;
+    std::string line;
+    while (std::getline(file, line) && processor.empty()) {
+        size_t pos = line.find(":");
+        if (pos == std::string::npos)
+            continue;
+        if (line.find("processor") == 0)
+            processor = line.substr(pos + 1);
+        else if (modelName.empty() && line.find("model name") == 0)
+            modelName = line.substr(pos + 1);
+    }
+    return processor.empty() ? modelName : processor;
+
+#elif defined(__APPLE__)
+    char brand[256] = {0};
+    size_t size = sizeof(brand);
+    if (sysctlbyname("machdep.cpu.brand_string", brand, &size, nullptr, 0) != 0)
+        return "";
+    return trimIdentifier(brand);
+
+#else
+    return "";
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef NATIVEPROBE_H
+#define NATIVEPROBE_H
+
+#include <string>
+
+/**
+ * @brief Hardware probes implemented with direct OS calls.
+ *
+ * These probes read the same identifiers that the command line tools used by
+ * HardwareLock report, but without spawning a process:
+ * - Windows: `DeviceIoControl(IOCTL_STORAGE_QUERY_PROPERTY)` and `GetVolumeInformation`
+ * - Linux: udev database, sysfs and `ioctl(HDIO_GET_IDENTITY)`
+ * - macOS: IOKit registry and `sysctlbyname`
+ *
+ * Every probe returns an empty string if the information is not available,
+ * so callers can fall back to the command based probes.
+ */
+class NativeProbe {
+public:
+    /**
+     * @brief Reads the serial number of the first physical disk.
+     * @return Disk serial number, or an empty string if unavailable.
+     */
+    static std::string getDiskSerialNumber();
+
+    /**
+     * @brief Reads the CPU identifier.
+     * @return CPU identifier, or an empty string if unavailable.
+     */
+    static std::string getCpuId();
+};
+
+#endif // NATIVEPROBE_H
@@ -0,0 +1,136 @@
+#include "signaturedecoder.h"
+
+#include <cstdint>
+
+/// Marks a character that is not part of the alphabet.
+static constexpr std::uint8_t Invalid = 0xFF;
+
+/**
+ * @brief Lookup tables mapping ASCII characters to their HEX and Base64 values.
+ */
+struct DecodeTables {
+    std::uint8_t hex[256];    ///< HEX digit value or Invalid
+    std::uint8_t base64[256]; ///< Base64 digit value or Invalid
+
+    constexpr DecodeTables() : hex(), base64() {
+        for (int i = 0; i < 256; ++i) {
+            hex[i] = Invalid;
+            base64[i] = Invalid;
+        }
+        for (int i = 0; i < 10; ++i)
+            hex['0' + i] = static_cast<std::uint8_t>(i);
+        for (int i = 0; i < 6; ++i) {
+            hex['a' + i] = static_cast<std::uint8_t>(10 + i);
+            hex['A' + i] = static_cast<std::uint8_t>(10 + i);
+        }
+        for (int i = 0; i < 26; ++i) {
+            base64['A' + i] = static_cast<std::uint8_t>(i);
+            base64['a' + i] = static_cast<std::uint8_t>(26 + i);
+        }
+        for (int i = 0; i < 10; ++i)
+            base64['0' + i] = static_cast<std::uint8_t>(52 + i);
+        base64['+'] = 62;
+        base64['/'] = 63;
+    }
+};
+
+static constexpr DecodeTables Tables;
+
+/**
+ * @brief Checks whether a string consists of an even number of HEX digits.
+ * @param encoded Encoded signature.
+ * @return true if @p encoded should be decoded as HEX.
+ */
+bool SignatureDecoder::isHex(std::string_view encoded) {
+    if (encoded.empty() || encoded.size() % 2 != 0)
+        return false;
+    for (char c : encoded) {
+        if (Tables.hex[static_cast<unsigned char>(c)] == Invalid)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes a HEX string.
+ * @param encoded HEX digits (upper or lower case), even length.
+ * @param out Output buffer.
+ * @param capacity Size of @p out in bytes.
+ * @param outLength Receives the number of decoded bytes.
+ * @return true on success, false on invalid input or insufficient capacity.
+ */
+bool SignatureDecoder::decodeHex(std::string_view encoded, unsigned char *out, std::size_t capacity, std::size_t &outLength) {
+    if (encoded.size() % 2 != 0 || encoded.size() / 2 > capacity)
+        return false;
+
+    const unsigned char *in = reinterpret_cast<const unsigned char *>(encoded.data());
+    std::size_t length = encoded.size() / 2;
+    for (std::size_t i = 0; i < length; ++i) {
+        std::uint8_t high = Tables.hex[in[2 * i]];
+        std::uint8_t low = Tables.hex[in[2 * i + 1]];
+        if ((high | low) & 0xF0) // Invalid sets the high nibble
+            return false;
+        out[i] = static_cast<unsigned char>((high << 4) | low);
+    }
+    outLength = length;
+    return true;
+}
+
+/**
+ * @brief Decodes a standard Base64 string (padding optional).
+ *
+ * Up to two trailing '=' characters are accepted. Whitespace and any other
+ * character outside the Base64 alphabet make the input invalid.
+ *
+ * @param encoded Base64 text.
+ * @param out Output buffer.
+ * @param capacity Size of @p out in bytes.
+ * @param outLength Receives the number of decoded bytes.
+ * @return true on success, false on invalid input or insufficient capacity.
+ */
+bool SignatureDecoder::decodeBase64(std::string_view encoded, unsigned char *out, std::size_t capacity, std::size_t &outLength) {
+    std::size_t length = encoded.size();
+    int padding = 0;
+    while (length > 0 && encoded[length - 1] == '=' && padding < 2) {
+        --length;
+        ++padding;
+    }
+    if (length % 4 == 1 || (padding > 0 && (length + padding) % 4 != 0))
+        return false;
+
+    std::size_t decodedLength = length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1);
+    if (decodedLength == 0 || decodedLength > capacity)
+        return false;
+
+    const unsigned char *in = reinterpret_cast<const unsigned char *>(encoded.data());
+    std::size_t o = 0;
+    std::uint32_t accumulator = 0;
+    int bits = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        std::uint8_t value = Tables.base64[in[i]];
+        if (value == Invalid)
+            return false;
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out[o++] = static_cast<unsigned char>(accumulator >> bits);
+        }
+    }
+    outLength = o;
+    return true;
+}
+
+/**
+ * @brief Decodes a HEX or Base64 signature.
+ * @param encoded Encoded signature.
+ * @param out Receives the raw signature bytes.
+ * @param outLength Receives the number of bytes written to @p out.
+ * @return true if the signature was decoded, false if it is malformed or too long.
+ */
+bool SignatureDecoder::decode(std::string_view encoded, Buffer &out, std::size_t &outLength) {
+    // HEX is tried first; decodeHex() stops at the first non-HEX character
+    if (!encoded.empty() && encoded.size() % 2 == 0 && decodeHex(encoded, out.data(), out.size(), outLength))
+        return true;
+    return decodeBase64(encoded, out.data(), out.size(), outLength);
+}
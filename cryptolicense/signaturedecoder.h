@@ -0,0 +1,64 @@
+#ifndef SIGNATUREDECODER_H
+#define SIGNATUREDECODER_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief Allocation-free decoder for HEX and Base64 license signatures.
+ *
+ * Decodes into a fixed-size buffer large enough for RSA-4096 signatures, so
+ * verification does not touch the heap. Both decoders are table driven.
+ */
+class SignatureDecoder {
+public:
+    /// Largest supported raw signature (RSA-4096).
+    static constexpr std::size_t MaxSignatureSize = 512;
+
+    /// Fixed buffer receiving a decoded signature.
+    using Buffer = std::array<unsigned char, MaxSignatureSize>;
+
+    /**
+     * @brief Decodes a HEX or Base64 signature.
+     *
+     * A string of an even number of HEX digits is decoded as HEX; anything
+     * else is decoded as Base64. Any signature length up to MaxSignatureSize
+     * bytes is accepted (RSA-2048/3072/4096, ECDSA, Ed25519).
+     *
+     * @param encoded Encoded signature.
+     * @param out Receives the raw signature bytes.
+     * @param outLength Receives the number of bytes written to @p out.
+     * @return true if the signature was decoded, false if it is malformed or too long.
+     */
+    static bool decode(std::string_view encoded, Buffer &out, std::size_t &outLength);
+
+    /**
+     * @brief Checks whether a string consists of an even number of HEX digits.
+     * @param encoded Encoded signature.
+     * @return true if @p encoded should be decoded as HEX.
+     */
+    static bool isHex(std::string_view encoded);
+
+    /**
+     * @brief Decodes a HEX string.
+     * @param encoded HEX digits (upper or lower case), even length.
+     * @param out Output buffer.
+     * @param capacity Size of @p out in bytes.
+     * @param outLength Receives the number of decoded bytes.
+     * @return true on success, false on invalid input or insufficient capacity.
+     */
+    static bool decodeHex(std::string_view encoded, unsigned char *out, std::size_t capacity, std::size_t &outLength);
+
+    /**
+     * @brief Decodes a standard Base64 string (padding optional).
+     * @param encoded Base64 text.
+     * @param out Output buffer.
+     * @param capacity Size of @p out in bytes.
+     * @param outLength Receives the number of decoded bytes.
+     * @return true on success, false on invalid input or insufficient capacity.
+     */
+    static bool decodeBase64(std::string_view encoded, unsigned char *out, std::size_t capacity, std::size_t &outLength);
+};
+
+#endif // SIGNATUREDECODER_H
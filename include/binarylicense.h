@@ -0,0 +1,207 @@
+#ifndef BINARYLICENSE_H
+#define BINARYLICENSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <licenseclaims.h>
+
+/**
+ * @brief Compact binary license encoding.
+ *
+ * An alternative to the JSON license for constrained links and firmware
+ * images. The signature is stored as raw bytes and the client can parse the
+ * file in place (for example from a memory-mapped file) without building a DOM.
+ *
+ * Layout (all integers little-endian):
+ *
+ *     offset  size  field
+ *     0       4     magic "CLIC"
+ *     4       1     format version (1)
+ *     5       ...   records until end of data
+ *
+ * Each record is `type (1 byte) | length (2 bytes) | value (length bytes)`.
+ * Unknown record types are skipped, so new fields can be added without
+ * breaking older clients.
+ */
+class BinaryLicense
+{
+public:
+    /// Current format version.
+    static constexpr std::uint8_t Version = 1;
+
+    /// Size of the fixed header (magic + version).
+    static constexpr std::size_t HeaderSize = 5;
+
+    /// Record types.
+    enum Field : std::uint8_t {
+        HardwareId = 1, ///< Hardware fingerprint (ASCII)
+        Algorithm = 2,  ///< Signature algorithm (JOSE name)
+        Signature = 3,  ///< Raw signature bytes
+        ExpiresAt = 4,  ///< Expiry as 8-byte little-endian Unix seconds
+        Features = 5,   ///< Comma-separated feature list
+        KeyId = 6,      ///< Signing key ID (`kid`, see LicenseKeyId)
+        Components = 7, ///< Per-component hashes (see LicenseClaims::componentList())
+        Match = 8       ///< Required component matches (1 byte)
+    };
+
+    /**
+     * @brief Zero-copy view of a parsed binary license.
+     *
+     * All members point into the buffer passed to parse() and are only valid
+     * while that buffer is.
+     */
+    struct View
+    {
+        std::string_view hardwareId; ///< Hardware fingerprint
+        std::string_view algorithm;  ///< Signature algorithm (empty for legacy RS256)
+        std::string_view signature;  ///< Raw signature bytes
+        std::int64_t expiresAt = 0;  ///< Expiry in Unix seconds; 0 = never expires
+        std::string_view features;   ///< Comma-separated feature list
+        std::string_view keyId;      ///< Signing key ID; empty for licenses issued before key rotation
+        std::string_view components; ///< Component list; empty if no components are bound
+        int requiredMatches = 0;     ///< Required component matches; 0 = default
+    };
+
+    /**
+     * @brief Checks whether a buffer starts with the binary license header.
+     * @param data Buffer to inspect.
+     * @param size Size of @p data in bytes.
+     * @return true if @p data looks like a binary license.
+     */
+    static bool isBinary(const char *data, std::size_t size)
+    {
+        return size >= HeaderSize && data[0] == 'C' && data[1] == 'L' && data[2] == 'I' && data[3] == 'C';
+    }
+
+    /**
+     * @brief Encodes a license.
+     * @param hardwareId Hardware fingerprint.
+     * @param algorithm Signature algorithm.
+     * @param signature Raw signature bytes.
+     * @param claims Signed claims; records are only written for claims that are set.
+     * @param keyId Signing key ID; no record is written if empty.
+     * @return Binary license bytes.
+     */
+    static std::string encode(std::string_view hardwareId, std::string_view algorithm, std::string_view signature,
+                              const LicenseClaims &claims = LicenseClaims(), std::string_view keyId = std::string_view())
+    {
+        std::string features = claims.featureList();
+        std::string components = LicenseClaims::componentList(claims.components);
+        std::string out;
+        out.reserve(HeaderSize + 18 + hardwareId.size() + algorithm.size() + signature.size() + 11 + features.size() +
+                    keyId.size() + 7 + components.size());
+        out.append("CLIC", 4);
+        out.push_back(static_cast<char>(Version));
+        appendRecord(out, HardwareId, hardwareId);
+        appendRecord(out, Algorithm, algorithm);
+        appendRecord(out, Signature, signature);
+        if (claims.expiresAt != 0) {
+            char expiry[8];
+            std::uint64_t value = static_cast<std::uint64_t>(claims.expiresAt);
+            for (int i = 0; i < 8; ++i)
+                expiry[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+            appendRecord(out, ExpiresAt, std::string_view(expiry, sizeof(expiry)));
+        }
+        if (!features.empty())
+            appendRecord(out, Features, features);
+        if (!keyId.empty())
+            appendRecord(out, KeyId, keyId);
+        if (!components.empty()) {
+            char match = static_cast<char>(claims.effectiveRequiredMatches());
+            appendRecord(out, Components, components);
+            appendRecord(out, Match, std::string_view(&match, 1));
+        }
+        return out;
+    }
+
+    /**
+     * @brief Extracts the signed claims from a parsed license.
+     * @param view Parsed license.
+     * @return Expiry, feature list and component hashes.
+     */
+    static LicenseClaims claims(const View &view)
+    {
+        LicenseClaims claims;
+        claims.expiresAt = view.expiresAt;
+        claims.features = LicenseClaims::parseFeatureList(view.features);
+        LicenseClaims::parseComponentList(view.components, claims.components);
+        claims.requiredMatches = view.requiredMatches;
+        return claims;
+    }
+
+    /**
+     * @brief Parses a binary license in place.
+     * @param data Buffer holding the license.
+     * @param size Size of @p data in bytes.
+     * @param view Receives views into @p data.
+     * @return true if the header is valid, every record fits the buffer,
+     *         hardware ID and signature are present and the expiry and match
+     *         records (if any) are 8 and 1 bytes long.
+     */
+    static bool parse(const char *data, std::size_t size, View &view)
+    {
+        if (!isBinary(data, size) || static_cast<std::uint8_t>(data[4]) != Version)
+            return false;
+
+        view = View();
+        std::size_t pos = HeaderSize;
+        while (pos < size) {
+            if (size - pos < 3)
+                return false;
+            std::uint8_t type = static_cast<std::uint8_t>(data[pos]);
+            std::size_t length = static_cast<std::uint8_t>(data[pos + 1]) |
+                                 (static_cast<std::size_t>(static_cast<std::uint8_t>(data[pos + 2])) << 8);
+            pos += 3;
+            if (length > size - pos)
+                return false;
+
+            std::string_view value(data + pos, length);
+            switch (type) {
+            case HardwareId: view.hardwareId = value; break;
+            case Algorithm: view.algorithm = value; break;
+            case Signature: view.signature = value; break;
+            case ExpiresAt: {
+                if (length != 8)
+                    return false;
+                std::uint64_t expiry = 0;
+                for (int i = 7; i >= 0; --i)
+                    expiry = (expiry << 8) | static_cast<std::uint8_t>(value[i]);
+                view.expiresAt = static_cast<std::int64_t>(expiry);
+                break;
+            }
+            case Features: view.features = value; break;
+            case KeyId: view.keyId = value; break;
+            case Components: view.components = value; break;
+            case Match:
+                if (length != 1)
+                    return false;
+                view.requiredMatches = static_cast<std::uint8_t>(value[0]);
+                break;
+            default: break; // Unknown record: skip
+            }
+            pos += length;
+        }
+        return !view.hardwareId.empty() && !view.signature.empty();
+    }
+
+private:
+    /**
+     * @brief Appends one TLV record; values longer than 65535 bytes are truncated.
+     * @param out Output buffer.
+     * @param type Record type.
+     * @param value Record value.
+     */
+    static void appendRecord(std::string &out, Field type, std::string_view value)
+    {
+        std::size_t length = value.size() > 0xFFFF ? 0xFFFF : value.size();
+        out.push_back(static_cast<char>(type));
+        out.push_back(static_cast<char>(length & 0xFF));
+        out.push_back(static_cast<char>((length >> 8) & 0xFF));
+        out.append(value.data(), length);
+    }
+};
+
+#endif // BINARYLICENSE_H
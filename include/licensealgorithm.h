@@ -0,0 +1,77 @@
+#ifndef LICENSEALGORITHM_H
+#define LICENSEALGORITHM_H
+
+#include <string>
+#include <string_view>
+
+#include <openssl/evp.h>
+
+/**
+ * @brief Signature algorithms supported in license files.
+ *
+ * Shared by the license server (signing) and the branch client
+ * (verification). The algorithm is stored in the license's `alg` field using
+ * JOSE names; licenses without an `alg` field are RSA + SHA256 (`RS256`).
+ *
+ * | alg     | Key type       | Digest  |
+ * |---------|----------------|---------|
+ * | RS256   | RSA            | SHA256  |
+ * | ES256   | EC P-256       | SHA256  |
+ * | ES384   | EC P-384       | SHA384  |
+ * | ES512   | EC P-521       | SHA512  |
+ * | EdDSA   | Ed25519        | (none)  |
+ */
+class LicenseAlgorithm
+{
+public:
+    /**
+     * @brief Returns the algorithm used by licenses that have no `alg` field.
+     * @return "RS256".
+     */
+    static const char *legacy() { return "RS256"; }
+
+    /**
+     * @brief Determines the license algorithm for a key.
+     * @param key Public or private key.
+     * @return JOSE algorithm name, or an empty string for unsupported key types.
+     */
+    static std::string forKey(const EVP_PKEY *key)
+    {
+        if (!key)
+            return "";
+
+        switch (EVP_PKEY_id(key)) {
+        case EVP_PKEY_RSA:
+            return "RS256";
+        case EVP_PKEY_EC:
+            switch (EVP_PKEY_bits(key)) {
+            case 256: return "ES256";
+            case 384: return "ES384";
+            case 521: return "ES512";
+            default: return "";
+            }
+        case EVP_PKEY_ED25519:
+            return "EdDSA";
+        default:
+            return "";
+        }
+    }
+
+    /**
+     * @brief Returns the message digest used with an algorithm.
+     * @param algorithm JOSE algorithm name.
+     * @return Digest, or nullptr for EdDSA (which hashes internally) and unknown names.
+     */
+    static const EVP_MD *digest(std::string_view algorithm)
+    {
+        if (algorithm == "RS256" || algorithm == "ES256")
+            return EVP_sha256();
+        if (algorithm == "ES384")
+            return EVP_sha384();
+        if (algorithm == "ES512")
+            return EVP_sha512();
+        return nullptr;
+    }
+};
+
+#endif // LICENSEALGORITHM_H
@@ -0,0 +1,281 @@
+#ifndef LICENSECLAIMS_H
+#define LICENSECLAIMS_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Signed license claims: expiry date, enabled features and hardware components.
+ *
+ * Shared by the license server (signing) and the branch client
+ * (verification). A license without claims is signed over its hardware ID
+ * alone, exactly as before claims existed, so old licenses stay valid. A
+ * license with claims is signed over a canonical payload that binds the
+ * hardware ID, `expiresAt`, the sorted feature list and, if present, the
+ * per-component hashes together; see signingPayload().
+ *
+ * Component hashes let the client accept a license when only some of the
+ * machine's identifiers changed (e.g. after a NIC swap): the license stays
+ * valid as long as the disk and requiredMatches of the signed components in
+ * total still match. Licenses are only issued with all three components.
+ */
+struct LicenseClaims
+{
+    /// Hardware components that are bound individually (see HardwareFingerprint::componentHashes()).
+    enum Component { Mac, Disk, Cpu, ComponentCount };
+
+    /// Per-component hashes, indexed by Component; an empty entry is not bound.
+    using ComponentHashes = std::array<std::string, ComponentCount>;
+
+    /// Components that must match when a license does not say otherwise (2 of 3).
+    static constexpr int DefaultRequiredMatches = 2;
+
+    std::int64_t expiresAt = 0;        ///< Expiry as Unix time in seconds; 0 = never expires
+    std::vector<std::string> features; ///< Enabled feature names, sorted and unique
+    ComponentHashes components;        ///< Signed per-component hashes (lowercase HEX SHA-256)
+    int requiredMatches = 0;           ///< Components that must match; 0 = DefaultRequiredMatches
+
+    /**
+     * @brief Checks whether the license carries any claims.
+     * @return true for a legacy license (no expiry, no features, no components).
+     */
+    bool isEmpty() const
+    {
+        return expiresAt == 0 && features.empty() && !hasComponents();
+    }
+
+    /**
+     * @brief Checks whether any hardware component is bound.
+     * @return true if at least one component hash is set.
+     */
+    bool hasComponents() const
+    {
+        return std::any_of(components.begin(), components.end(), [](const std::string &hash) { return !hash.empty(); });
+    }
+
+    /**
+     * @brief Checks whether every hardware component is bound.
+     * @return true if all component hashes are set, as issuance requires.
+     */
+    bool hasAllComponents() const
+    {
+        return std::none_of(components.begin(), components.end(), [](const std::string &hash) { return hash.empty(); });
+    }
+
+    /**
+     * @brief Returns the number of components that must match.
+     * @return requiredMatches (or DefaultRequiredMatches), at most the number of bound components.
+     */
+    int effectiveRequiredMatches() const
+    {
+        int bound = static_cast<int>(std::count_if(components.begin(), components.end(),
+                                                   [](const std::string &hash) { return !hash.empty(); }));
+        return std::min(requiredMatches > 0 ? requiredMatches : DefaultRequiredMatches, bound);
+    }
+
+    /**
+     * @brief Counts the bound components that equal the local ones.
+     * @param local Component hashes of this machine.
+     * @return Number of matching components.
+     */
+    int matchingComponents(const ComponentHashes &local) const
+    {
+        int matches = 0;
+        for (std::size_t i = 0; i < components.size(); ++i) {
+            if (!components[i].empty() && components[i] == local[i])
+                ++matches;
+        }
+        return matches;
+    }
+
+    /**
+     * @brief Applies the threshold match policy.
+     *
+     * The disk serial is the anchor: a MAC address and a CPU ID are easy to
+     * copy to another machine, so they never carry a match on their own.
+     *
+     * @param local Component hashes of this machine.
+     * @return true if all components are bound, the disk matches and enough components match in total.
+     */
+    bool componentsMatch(const ComponentHashes &local) const
+    {
+        return hasAllComponents() && components[Disk] == local[Disk] &&
+               matchingComponents(local) >= effectiveRequiredMatches();
+    }
+
+    /**
+     * @brief Returns the name of a component as used in licenses.
+     * @param component Component index.
+     * @return "mac", "disk" or "cpu".
+     */
+    static const char *componentName(int component)
+    {
+        static const char *const names[ComponentCount] = {"mac", "disk", "cpu"};
+        return component >= 0 && component < ComponentCount ? names[component] : "";
+    }
+
+    /**
+     * @brief Joins the bound components into a list.
+     * @param components Component hashes.
+     * @return List such as "mac:<hash>,disk:<hash>,cpu:<hash>"; unbound components are left out.
+     */
+    static std::string componentList(const ComponentHashes &components)
+    {
+        std::string out;
+        for (int i = 0; i < ComponentCount; ++i) {
+            if (components[i].empty())
+                continue;
+            if (!out.empty())
+                out += ',';
+            out += componentName(i);
+            out += ':';
+            out += components[i];
+        }
+        return out;
+    }
+
+    /**
+     * @brief Parses a component list produced by componentList().
+     *
+     * Hashes must be 64 HEX digits; they are stored in lowercase. Unknown
+     * component names are ignored.
+     *
+     * @param list Comma-separated `name:hash` pairs.
+     * @param components Receives the component hashes.
+     * @return false if an entry is malformed; @p components is then cleared.
+     */
+    static bool parseComponentList(std::string_view list, ComponentHashes &components)
+    {
+        components = ComponentHashes();
+        while (!list.empty()) {
+            std::size_t end = list.find(',');
+            std::string_view entry = list.substr(0, end);
+            list = end == std::string_view::npos ? std::string_view() : list.substr(end + 1);
+
+            std::size_t colon = entry.find(':');
+            std::string_view hash = colon == std::string_view::npos ? std::string_view() : entry.substr(colon + 1);
+            if (hash.size() != 64 || !std::all_of(hash.begin(), hash.end(), [](char c) {
+                    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+                })) {
+                components = ComponentHashes();
+                return false;
+            }
+            for (int i = 0; i < ComponentCount; ++i) {
+                if (entry.substr(0, colon) == componentName(i)) {
+                    components[i].assign(hash.data(), hash.size());
+                    std::transform(components[i].begin(), components[i].end(), components[i].begin(),
+                                   [](char c) { return c >= 'A' && c <= 'F' ? static_cast<char>(c - 'A' + 'a') : c; });
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the license has expired.
+     * @param now Current Unix time in seconds.
+     * @return true if an expiry is set and has passed.
+     */
+    bool isExpired(std::int64_t now) const
+    {
+        return expiresAt != 0 && now >= expiresAt;
+    }
+
+    /**
+     * @brief Checks whether a feature is enabled.
+     * @param feature Feature name.
+     * @return true if @p feature is listed.
+     */
+    bool hasFeature(std::string_view feature) const
+    {
+        return std::binary_search(features.begin(), features.end(), feature,
+                                  [](std::string_view a, std::string_view b) { return a < b; });
+    }
+
+    /**
+     * @brief Joins the features into a comma-separated list.
+     * @return Feature list, e.g. "export,reports".
+     */
+    std::string featureList() const
+    {
+        std::string out;
+        for (const std::string &feature : features) {
+            if (!out.empty())
+                out += ',';
+            out += feature;
+        }
+        return out;
+    }
+
+    /**
+     * @brief Parses a comma-separated feature list.
+     *
+     * Names are restricted to `[A-Za-z0-9_.-]`; other characters are dropped.
+     * The result is sorted and free of duplicates.
+     *
+     * @param list Comma-separated feature names.
+     * @return Canonical feature list.
+     */
+    static std::vector<std::string> parseFeatureList(std::string_view list)
+    {
+        std::vector<std::string> features;
+        std::string current;
+        for (std::size_t i = 0; i <= list.size(); ++i) {
+            char c = i < list.size() ? list[i] : ',';
+            if (c == ',') {
+                if (!current.empty())
+                    features.push_back(current);
+                current.clear();
+            } else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+                       c == '_' || c == '.' || c == '-') {
+                current += c;
+            }
+        }
+        std::sort(features.begin(), features.end());
+        features.erase(std::unique(features.begin(), features.end()), features.end());
+        return features;
+    }
+
+    /**
+     * @brief Builds the data that is signed for a license.
+     *
+     * Without claims this is the hardware ID itself (legacy licenses).
+     * Otherwise:
+     *
+     *     CryptoLicense/v2\n<hardwareId>\nexpiresAt=<seconds>\nfeatures=<a,b,...>
+     *
+     * followed, for licenses with component hashes, by
+     *
+     *     \ncomponents=mac:<hash>,disk:<hash>,cpu:<hash>\nmatch=<n>
+     *
+     * @param hardwareId The hardware fingerprint or ID.
+     * @param claims License claims.
+     * @return Signing payload.
+     */
+    static std::string signingPayload(std::string_view hardwareId, const LicenseClaims &claims)
+    {
+        if (claims.isEmpty())
+            return std::string(hardwareId);
+
+        LicenseClaims canonical = claims;
+        std::sort(canonical.features.begin(), canonical.features.end());
+        canonical.features.erase(std::unique(canonical.features.begin(), canonical.features.end()),
+                                 canonical.features.end());
+
+        std::string payload = "CryptoLicense/v2\n";
+        payload.append(hardwareId.data(), hardwareId.size());
+        payload += "\nexpiresAt=" + std::to_string(claims.expiresAt);
+        payload += "\nfeatures=" + canonical.featureList();
+        if (claims.hasComponents()) {
+            payload += "\ncomponents=" + componentList(claims.components);
+            payload += "\nmatch=" + std::to_string(claims.effectiveRequiredMatches());
+        }
+        return payload;
+    }
+};
+
+#endif // LICENSECLAIMS_H
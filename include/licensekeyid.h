@@ -0,0 +1,97 @@
+#ifndef LICENSEKEYID_H
+#define LICENSEKEYID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+/**
+ * @brief Identifiers of license signing keys.
+ *
+ * Shared by the license server (which writes the `kid` of its key into every
+ * license) and the branch client (which selects the verification key by it),
+ * so both derive the same ID from the same key pair.
+ *
+ * The thumbprint is the SHA-256 of the DER-encoded SubjectPublicKeyInfo; the
+ * `kid` is its first 8 bytes in HEX. The `kid` only selects a key and is not
+ * covered by the signature: changing it can only make verification fail.
+ */
+class LicenseKeyId
+{
+public:
+    /// Length of a `kid` in HEX characters.
+    static constexpr std::size_t Length = 16;
+
+    /**
+     * @brief Computes the thumbprint of a key's public half.
+     * @param key Public or private key.
+     * @return Lowercase HEX SHA-256 of the DER public key, or an empty string on failure.
+     */
+    static std::string thumbprint(const EVP_PKEY *key)
+    {
+        if (!key)
+            return "";
+
+        unsigned char *der = nullptr;
+        int derLength = i2d_PUBKEY(const_cast<EVP_PKEY *>(key), &der);
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digestLength = 0;
+        bool hashed = derLength > 0 &&
+                      EVP_Digest(der, static_cast<size_t>(derLength), digest, &digestLength, EVP_sha256(), nullptr) == 1;
+        OPENSSL_free(der);
+        if (!hashed)
+            return "";
+
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(digestLength * 2);
+        for (unsigned int i = 0; i < digestLength; ++i) {
+            hex.push_back(digits[digest[i] >> 4]);
+            hex.push_back(digits[digest[i] & 0x0F]);
+        }
+        return hex;
+    }
+
+    /**
+     * @brief Computes the `kid` of a key.
+     * @param key Public or private key.
+     * @return 16 lowercase HEX characters, or an empty string on failure.
+     */
+    static std::string forKey(const EVP_PKEY *key)
+    {
+        return thumbprint(key).substr(0, Length);
+    }
+
+    /**
+     * @brief Converts a `kid` to its 64-bit value.
+     * @param kid HEX `kid` as stored in a license (either case).
+     * @param value Receives the value.
+     * @return true if @p kid is exactly 16 HEX characters.
+     */
+    static bool parse(std::string_view kid, std::uint64_t &value)
+    {
+        if (kid.size() != Length)
+            return false;
+
+        value = 0;
+        for (char c : kid) {
+            int digit;
+            if (c >= '0' && c <= '9')
+                digit = c - '0';
+            else if (c >= 'a' && c <= 'f')
+                digit = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                digit = c - 'A' + 10;
+            else
+                return false;
+            value = (value << 4) | static_cast<std::uint64_t>(digit);
+        }
+        return true;
+    }
+};
+
+#endif // LICENSEKEYID_H
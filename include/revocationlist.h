@@ -0,0 +1,337 @@
+#ifndef REVOCATIONLIST_H
+#define REVOCATIONLIST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <openssl/evp.h>
+
+/**
+ * @brief Compact, signed list of revoked hardware fingerprints.
+ *
+ * Revoked fingerprints are stored as the first 64 bits of their SHA-256,
+ * sorted ascending, so a client can binary-search a memory-mapped file
+ * without parsing it. Unlike a Bloom filter the list has no practical false
+ * positives (2^-64 per entry), so no valid machine is locked out.
+ *
+ * Full list (all integers little-endian):
+ *
+ *     offset  size       field
+ *     0       4          magic "CRVL"
+ *     4       1          format version (1)
+ *     5       3          reserved (0)
+ *     8       8          sequence number (increases with every update)
+ *     16      8          entry count n
+ *     24      8          reserved (0)
+ *     32      8 * n      sorted entries
+ *     ...     s          signature over SigningContext + bytes [0, 32 + 8n)
+ *     ...     2          signature length s
+ *
+ * Delta (to go from sequence `base` to sequence `target`):
+ *
+ *     0       4          magic "CRVD"
+ *     4       1          format version (1)
+ *     5       3          reserved (0)
+ *     8       8          base sequence
+ *     16      8          target sequence
+ *     24      8          number of added entries a
+ *     32      8          number of removed entries r
+ *     40      8 * a      sorted added entries
+ *     ...     8 * r      sorted removed entries
+ *     ...     s          signature of the resulting full list
+ *     ...     2          signature length s
+ *
+ * Applying a delta rebuilds the target list byte for byte, so the signature
+ * carried by the delta can be checked against the result and stored with it.
+ *
+ * Lists are signed with the license key. The SigningContext prefix keeps a
+ * list signature from ever being valid for a license payload, or the other
+ * way round; use signingPayload() on both sides.
+ */
+class RevocationList
+{
+public:
+    /// Current format version.
+    static constexpr std::uint8_t Version = 1;
+
+    /// Size of the full list header.
+    static constexpr std::size_t HeaderSize = 32;
+
+    /// Size of the delta header.
+    static constexpr std::size_t DeltaHeaderSize = 40;
+
+    /// Domain separation prefix of the signed data.
+    static constexpr std::string_view SigningContext = "CryptoRevocation/v1\n";
+
+    /**
+     * @brief Zero-copy view of a parsed full list.
+     */
+    struct View
+    {
+        std::uint64_t sequence = 0;              ///< List version
+        std::uint64_t count = 0;                 ///< Number of entries
+        const unsigned char *entries = nullptr;  ///< count little-endian u64 values
+        std::string_view signedData;             ///< Header and entries
+        std::string_view signature;              ///< Raw signature bytes
+    };
+
+    /**
+     * @brief Zero-copy view of a parsed delta.
+     */
+    struct DeltaView
+    {
+        std::uint64_t baseSequence = 0;         ///< Sequence the delta applies to
+        std::uint64_t targetSequence = 0;       ///< Sequence of the resulting list
+        std::uint64_t addCount = 0;             ///< Number of added entries
+        std::uint64_t removeCount = 0;          ///< Number of removed entries
+        const unsigned char *added = nullptr;   ///< Sorted added entries
+        const unsigned char *removed = nullptr; ///< Sorted removed entries
+        std::string_view signature;             ///< Signature of the resulting full list
+    };
+
+    /**
+     * @brief Maps a hardware fingerprint to its list entry.
+     * @param fingerprint Hardware fingerprint.
+     * @return First 64 bits of SHA-256(fingerprint), big-endian.
+     */
+    static std::uint64_t hashFingerprint(std::string_view fingerprint)
+    {
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        EVP_Digest(fingerprint.data(), fingerprint.size(), digest, &length, EVP_sha256(), nullptr);
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+            value = (value << 8) | digest[i];
+        return value;
+    }
+
+    /**
+     * @brief Builds the bytes a list signature covers.
+     * @param body Header and entries (View::signedData or encodeBody()).
+     * @return SigningContext followed by @p body.
+     */
+    static std::string signingPayload(std::string_view body)
+    {
+        std::string payload;
+        payload.reserve(SigningContext.size() + body.size());
+        payload.append(SigningContext.data(), SigningContext.size());
+        payload.append(body.data(), body.size());
+        return payload;
+    }
+
+    /**
+     * @brief Parses a full list in place.
+     * @param data Buffer holding the list (e.g. a memory-mapped file).
+     * @param size Size of @p data in bytes.
+     * @param view Receives views into @p data.
+     * @return true if the layout is valid. The signature is not checked.
+     */
+    static bool parse(const char *data, std::size_t size, View &view)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+        if (size < HeaderSize + 2 || std::memcmp(data, "CRVL", 4) != 0 || bytes[4] != Version)
+            return false;
+
+        std::size_t signatureLength = bytes[size - 2] | (static_cast<std::size_t>(bytes[size - 1]) << 8);
+        std::uint64_t count = readU64(bytes + 16);
+        if (count > (size - HeaderSize - 2) / 8 || HeaderSize + count * 8 + signatureLength + 2 != size)
+            return false;
+
+        view.sequence = readU64(bytes + 8);
+        view.count = count;
+        view.entries = bytes + HeaderSize;
+        view.signedData = std::string_view(data, HeaderSize + count * 8);
+        view.signature = std::string_view(data + HeaderSize + count * 8, signatureLength);
+        return signatureLength > 0;
+    }
+
+    /**
+     * @brief Checks whether an entry is in a list (binary search).
+     * @param view Parsed list.
+     * @param entry Value from hashFingerprint().
+     * @return true if @p entry is revoked.
+     */
+    static bool contains(const View &view, std::uint64_t entry)
+    {
+        std::uint64_t low = 0;
+        std::uint64_t high = view.count;
+        while (low < high) {
+            std::uint64_t mid = low + (high - low) / 2;
+            std::uint64_t value = readU64(view.entries + mid * 8);
+            if (value == entry)
+                return true;
+            if (value < entry)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the entries of a list.
+     * @param view Parsed list.
+     * @return Sorted entries.
+     */
+    static std::vector<std::uint64_t> entries(const View &view)
+    {
+        std::vector<std::uint64_t> values(static_cast<std::size_t>(view.count));
+        for (std::size_t i = 0; i < values.size(); ++i)
+            values[i] = readU64(view.entries + i * 8);
+        return values;
+    }
+
+    /**
+     * @brief Encodes the signed part of a full list.
+     * @param sequence List version.
+     * @param entries Sorted, unique entries.
+     * @return Header and entries; append the signature with appendSignature().
+     */
+    static std::string encodeBody(std::uint64_t sequence, const std::vector<std::uint64_t> &entries)
+    {
+        std::string out("CRVL", 4);
+        out.push_back(static_cast<char>(Version));
+        out.append(3, '\0');
+        appendU64(out, sequence);
+        appendU64(out, entries.size());
+        appendU64(out, 0);
+        for (std::uint64_t entry : entries)
+            appendU64(out, entry);
+        return out;
+    }
+
+    /**
+     * @brief Encodes a delta without its signature.
+     * @param baseSequence Sequence the delta applies to.
+     * @param targetSequence Sequence of the resulting list.
+     * @param added Sorted entries to add.
+     * @param removed Sorted entries to remove.
+     * @return Delta bytes; append the target list's signature with appendSignature().
+     */
+    static std::string encodeDelta(std::uint64_t baseSequence, std::uint64_t targetSequence,
+                                   const std::vector<std::uint64_t> &added, const std::vector<std::uint64_t> &removed)
+    {
+        std::string out("CRVD", 4);
+        out.push_back(static_cast<char>(Version));
+        out.append(3, '\0');
+        appendU64(out, baseSequence);
+        appendU64(out, targetSequence);
+        appendU64(out, added.size());
+        appendU64(out, removed.size());
+        for (std::uint64_t entry : added)
+            appendU64(out, entry);
+        for (std::uint64_t entry : removed)
+            appendU64(out, entry);
+        return out;
+    }
+
+    /**
+     * @brief Appends a signature and its length trailer.
+     * @param out List body or delta.
+     * @param signature Raw signature bytes (at most 65535).
+     */
+    static void appendSignature(std::string &out, std::string_view signature)
+    {
+        std::size_t length = std::min<std::size_t>(signature.size(), 0xFFFF);
+        out.append(signature.data(), length);
+        out.push_back(static_cast<char>(length & 0xFF));
+        out.push_back(static_cast<char>((length >> 8) & 0xFF));
+    }
+
+    /**
+     * @brief Parses a delta in place.
+     * @param data Buffer holding the delta.
+     * @param size Size of @p data in bytes.
+     * @param delta Receives views into @p data.
+     * @return true if the layout is valid.
+     */
+    static bool parseDelta(const char *data, std::size_t size, DeltaView &delta)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+        if (size < DeltaHeaderSize + 2 || std::memcmp(data, "CRVD", 4) != 0 || bytes[4] != Version)
+            return false;
+
+        std::size_t signatureLength = bytes[size - 2] | (static_cast<std::size_t>(bytes[size - 1]) << 8);
+        std::uint64_t addCount = readU64(bytes + 24);
+        std::uint64_t removeCount = readU64(bytes + 32);
+        std::uint64_t maxEntries = (size - DeltaHeaderSize - 2) / 8;
+        if (addCount > maxEntries || removeCount > maxEntries - addCount ||
+            DeltaHeaderSize + (addCount + removeCount) * 8 + signatureLength + 2 != size)
+            return false;
+
+        delta.baseSequence = readU64(bytes + 8);
+        delta.targetSequence = readU64(bytes + 16);
+        delta.addCount = addCount;
+        delta.removeCount = removeCount;
+        delta.added = bytes + DeltaHeaderSize;
+        delta.removed = delta.added + addCount * 8;
+        delta.signature = std::string_view(data + DeltaHeaderSize + (addCount + removeCount) * 8, signatureLength);
+        return signatureLength > 0 && delta.targetSequence > delta.baseSequence;
+    }
+
+    /**
+     * @brief Applies a delta to a list.
+     * @param base Parsed list at the delta's base sequence.
+     * @param delta Parsed delta.
+     * @param body Receives the signed part of the resulting list (see encodeBody()).
+     * @return false if the delta does not apply to @p base.
+     */
+    static bool applyDelta(const View &base, const DeltaView &delta, std::string &body)
+    {
+        if (base.sequence != delta.baseSequence)
+            return false;
+
+        std::vector<std::uint64_t> current = entries(base);
+        std::vector<std::uint64_t> removed(static_cast<std::size_t>(delta.removeCount));
+        for (std::size_t i = 0; i < removed.size(); ++i)
+            removed[i] = readU64(delta.removed + i * 8);
+        std::vector<std::uint64_t> added(static_cast<std::size_t>(delta.addCount));
+        for (std::size_t i = 0; i < added.size(); ++i)
+            added[i] = readU64(delta.added + i * 8);
+        std::sort(removed.begin(), removed.end());
+        std::sort(added.begin(), added.end());
+
+        std::vector<std::uint64_t> kept;
+        kept.reserve(current.size());
+        std::set_difference(current.begin(), current.end(), removed.begin(), removed.end(), std::back_inserter(kept));
+        std::vector<std::uint64_t> result;
+        result.reserve(kept.size() + added.size());
+        std::set_union(kept.begin(), kept.end(), added.begin(), added.end(), std::back_inserter(result));
+
+        body = encodeBody(delta.targetSequence, result);
+        return true;
+    }
+
+private:
+    /**
+     * @brief Reads a little-endian u64.
+     * @param data Input bytes (no alignment required).
+     * @return Decoded value.
+     */
+    static std::uint64_t readU64(const unsigned char *data)
+    {
+        std::uint64_t value = 0;
+        for (int i = 7; i >= 0; --i)
+            value = (value << 8) | data[i];
+        return value;
+    }
+
+    /**
+     * @brief Appends a little-endian u64.
+     * @param out Output buffer.
+     * @param value Value to append.
+     */
+    static void appendU64(std::string &out, std::uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+};
+
+#endif // REVOCATIONLIST_H
@@ -0,0 +1,101 @@
+#include "licenseaudit.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/**
+ * @brief Returns the number of files that did not pass.
+ * @return total minus the valid count.
+ */
+std::size_t LicenseAudit::Summary::failed() const {
+    auto valid = counts.find(LicenseValidator::Status::Valid);
+    return total - (valid == counts.end() ? 0 : valid->second);
+}
+
+/**
+ * @brief Returns the achieved throughput.
+ * @return Licenses per second, or 0 if the run took no measurable time.
+ */
+double LicenseAudit::Summary::licensesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(total) / seconds : 0.0;
+}
+
+/**
+ * @brief Expands files and directories into a sorted list of license files.
+ * @param paths Files (taken as given) and directories (searched for `*.lic`).
+ * @param recursive Also search subdirectories.
+ * @return License file paths, sorted and without duplicates.
+ */
+QStringList LicenseAudit::collect(const QStringList &paths, bool recursive) {
+    QStringList files;
+    for (const QString &path : paths) {
+        if (!QFileInfo(path).isDir()) {
+            files << path;
+            continue;
+        }
+        QDirIterator it(path, QStringList() << "*.lic", QDir::Files,
+                        recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+        while (it.hasNext())
+            files << it.next();
+    }
+    files.sort();
+    files.removeDuplicates();
+    return files;
+}
+
+/**
+ * @brief Audits license files in parallel.
+ *
+ * Each worker claims the next file index with a relaxed fetch_add and writes
+ * only its own entry, so the workers share no lock; per-status counts are
+ * tallied once all of them have finished.
+ *
+ * @param files License files to check.
+ * @param verifier Verifier holding the public key; shared by all workers.
+ * @param options Audit settings.
+ * @param entries Receives one entry per file, in the order of @p files.
+ * @return Totals of the run.
+ */
+LicenseAudit::Summary LicenseAudit::run(const QStringList &files, const LicenseVerifier &verifier,
+                                        const Options &options, std::vector<Entry> &entries) {
+    Summary summary;
+    summary.total = static_cast<std::size_t>(files.size());
+    entries.assign(summary.total, Entry());
+
+    unsigned threadCount = options.threads;
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<std::size_t>(threadCount, std::max<std::size_t>(1, summary.total)));
+    summary.threadCount = threadCount;
+
+    const std::int64_t now = options.now != 0 ? options.now : LicenseValidator::now();
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < summary.total;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            Entry &entry = entries[i];
+            entry.path = files.at(static_cast<int>(i));
+            entry.result = LicenseValidator::audit(entry.path, verifier, options.revocations, now);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread &thread : workers)
+        thread.join();
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const Entry &entry : entries)
+        ++summary.counts[entry.result.status];
+    return summary;
+}
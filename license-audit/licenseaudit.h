@@ -0,0 +1,87 @@
+#ifndef LICENSEAUDIT_H
+#define LICENSEAUDIT_H
+
+#include <QString>
+#include <QStringList>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "licensevalidator.h"
+
+class LicenseVerifier;
+class RevocationChecker;
+
+/**
+ * @brief Verifies a corpus of issued license files in parallel.
+ *
+ * Every file is checked with LicenseValidator::audit() against one shared,
+ * pre-parsed LicenseVerifier, so the public key is read once no matter how
+ * many licenses are audited. Files are handed out to the worker threads
+ * through an atomic index; results are stored by input position, so the
+ * report order is independent of the thread count.
+ */
+class LicenseAudit {
+public:
+    /**
+     * @brief Audit settings.
+     */
+    struct Options {
+        unsigned threads = 0;                           ///< Worker threads; 0 = one per core
+        std::int64_t now = 0;                           ///< Reference time for expiry; 0 = current time
+        const RevocationChecker *revocations = nullptr; ///< Loaded revocation list; may be null
+    };
+
+    /**
+     * @brief Outcome for one license file.
+     */
+    struct Entry {
+        QString path;                    ///< License file
+        LicenseValidator::Result result; ///< Status and parsed license
+    };
+
+    /**
+     * @brief Totals of an audit run.
+     */
+    struct Summary {
+        std::size_t total = 0;                                  ///< Files audited
+        std::map<LicenseValidator::Status, std::size_t> counts; ///< Files per status
+        double seconds = 0.0;                                   ///< Wall-clock duration
+        unsigned threadCount = 0;                               ///< Worker threads used
+
+        /**
+         * @brief Returns the number of files that did not pass.
+         * @return total minus the valid count.
+         */
+        std::size_t failed() const;
+
+        /**
+         * @brief Returns the achieved throughput.
+         * @return Licenses per second, or 0 if the run took no measurable time.
+         */
+        double licensesPerSecond() const;
+    };
+
+    /**
+     * @brief Expands files and directories into a sorted list of license files.
+     * @param paths Files (taken as given) and directories (searched for `*.lic`).
+     * @param recursive Also search subdirectories.
+     * @return License file paths, sorted and without duplicates.
+     */
+    static QStringList collect(const QStringList &paths, bool recursive);
+
+    /**
+     * @brief Audits license files in parallel.
+     * @param files License files to check.
+     * @param verifier Verifier holding the public key; shared by all workers.
+     * @param options Audit settings.
+     * @param entries Receives one entry per file, in the order of @p files.
+     * @return Totals of the run.
+     */
+    static Summary run(const QStringList &files, const LicenseVerifier &verifier, const Options &options,
+                       std::vector<Entry> &entries);
+};
+
+#endif // LICENSEAUDIT_H
@@ -0,0 +1,160 @@
+#include "licenseaudit.h"
+#include "licenseverifier.h"
+#include "revocationchecker.h"
+
+#include <QCoreApplication>
+#include <QString>
+#include <QStringList>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Prints the command-line usage.
+ */
+static void printUsage()
+{
+    std::cerr << "Usage:\n"
+              << "  CryptoAudit [--key <public_key.pem>]... [--revocation-list <file>] [--threads <n>]\n"
+              << "              [--recursive] [--at <unix-seconds>] [--report <file>] [--failures-only]\n"
+              << "              <license file or directory>...\n"
+              << "      Verify every license (directories: all *.lic files) against the public key(s)\n"
+              << "      on <n> threads (default: one per core). One line per file is written to\n"
+              << "      stdout or <file>: status, path, fingerprint, algorithm, kid and expiresAt.\n"
+              << "      The summary goes to stderr; the exit code is 0 only if all licenses pass.\n";
+}
+
+/**
+ * @brief Writes the per-file report as tab-separated lines.
+ * @param out Destination stream.
+ * @param entries Audit results.
+ * @param failuresOnly Skip licenses that passed.
+ */
+static void writeReport(std::ostream &out, const std::vector<LicenseAudit::Entry> &entries, bool failuresOnly)
+{
+    for (const LicenseAudit::Entry &entry : entries) {
+        const LicenseValidator::Result &result = entry.result;
+        if (failuresOnly && result.status == LicenseValidator::Status::Valid)
+            continue;
+        out << LicenseValidator::statusName(result.status) << '\t' << entry.path.toStdString() << '\t'
+            << result.license.fingerprint << '\t'
+            << (result.license.algorithm.empty() ? std::string_view("RS256") : result.license.algorithm) << '\t'
+            << (result.license.keyId.empty() ? std::string_view("-") : result.license.keyId) << '\t'
+            << result.license.claims.expiresAt;
+        if (!result.detail.isEmpty())
+            out << '\t' << result.detail.toStdString();
+        out << '\n';
+    }
+    out.flush();
+}
+
+/**
+ * @brief Writes the audit summary.
+ * @param out Destination stream.
+ * @param summary Totals of the run.
+ */
+static void writeSummary(std::ostream &out, const LicenseAudit::Summary &summary)
+{
+    out << (summary.failed() == 0 ? "✅ " : "❌ ") << summary.total << " license(s) audited, "
+        << summary.failed() << " failed\n";
+    for (const auto &count : summary.counts)
+        out << "   " << LicenseValidator::statusName(count.first) << ": " << count.second << '\n';
+    out << "⏱ " << summary.seconds << " s on " << summary.threadCount << " thread(s), "
+        << summary.licensesPerSecond() << " licenses/sec\n";
+}
+
+/**
+ * @brief Entry point of the headless license audit tool.
+ *
+ * Verifies a corpus of issued licenses, e.g. after a key rotation, with the
+ * same rules as the client (LicenseValidator) but against the fingerprint
+ * stored in each license instead of the local machine. The public key and the
+ * optional revocation list are loaded once and shared by all worker threads.
+ *
+ * @param argc Argument count
+ * @param argv Argument values
+ * @return int 0 if every license passed, 1 if any failed, 2 on usage or setup errors
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList publicKeyPaths;
+    QString revocationList;
+    QString reportPath;
+    QStringList paths;
+    LicenseAudit::Options options;
+    bool recursive = false;
+    bool failuresOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--key") == 0 && i + 1 < argc) {
+            publicKeyPaths << QString::fromLocal8Bit(argv[++i]);
+        } else if (std::strcmp(argv[i], "--revocation-list") == 0 && i + 1 < argc) {
+            revocationList = QString::fromLocal8Bit(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+            options.now = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            reportPath = QString::fromLocal8Bit(argv[++i]);
+        } else if (std::strcmp(argv[i], "--recursive") == 0) {
+            recursive = true;
+        } else if (std::strcmp(argv[i], "--failures-only") == 0) {
+            failuresOnly = true;
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            printUsage();
+            return 2;
+        } else {
+            paths << QString::fromLocal8Bit(argv[i]);
+        }
+    }
+
+    if (paths.isEmpty()) {
+        printUsage();
+        return 2;
+    }
+
+    // The first key replaces, further keys join the keyring (licenses pick theirs by `kid`)
+    if (publicKeyPaths.isEmpty())
+        publicKeyPaths << "public_key.pem";
+    LicenseVerifier verifier;
+    for (const QString &publicKeyPath : publicKeyPaths) {
+        const std::string path = publicKeyPath.toStdString();
+        bool loaded = verifier.isLoaded() ? verifier.addPublicKey(path) : verifier.loadPublicKey(path);
+        if (!loaded) {
+            std::cerr << "❌ Could not load public key " << path << ".\n";
+            return 2;
+        }
+    }
+
+    RevocationChecker revocations;
+    if (!revocationList.isEmpty()) {
+        if (!revocations.load(revocationList, verifier)) {
+            std::cerr << "❌ Could not load revocation list " << revocationList.toStdString() << ".\n";
+            return 2;
+        }
+        options.revocations = &revocations;
+    }
+
+    const QStringList files = LicenseAudit::collect(paths, recursive);
+    std::vector<LicenseAudit::Entry> entries;
+    const LicenseAudit::Summary summary = LicenseAudit::run(files, verifier, options, entries);
+
+    if (reportPath.isEmpty()) {
+        writeReport(std::cout, entries, failuresOnly);
+    } else {
+        std::ofstream report(reportPath.toStdString(), std::ios::binary | std::ios::trunc);
+        if (!report.is_open()) {
+            std::cerr << "❌ Could not write " << reportPath.toStdString() << ".\n";
+            return 2;
+        }
+        writeReport(report, entries, failuresOnly);
+    }
+    writeSummary(std::cerr, summary);
+    return summary.failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief A blocking FIFO queue with a fixed capacity.
+ *
+ * Producers block in push() while the queue is full and consumers block in
+ * pop() while it is empty. After close() no more items are accepted and
+ * pop() drains the remaining items before returning false.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    /**
+     * @brief Constructs a queue that holds at most @p capacity items.
+     * @param capacity Maximum number of queued items (at least 1).
+     */
+    explicit BoundedQueue(std::size_t capacity)
+        : m_capacity(capacity > 0 ? capacity : 1), m_closed(false)
+    {
+    }
+
+    /**
+     * @brief Appends an item, waiting while the queue is full.
+     * @param item Item to enqueue.
+     * @return false if the queue was closed, true otherwise.
+     */
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed)
+            return false;
+        m_items.push_back(std::move(item));
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest item, waiting while the queue is empty.
+     * @param item Receives the dequeued item.
+     * @return false once the queue is closed and drained, true otherwise.
+     */
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+        if (m_items.empty())
+            return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Stops accepting items and wakes all waiting threads.
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+    /**
+     * @brief Returns the number of currently queued items.
+     * @return Queue depth.
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_items.size();
+    }
+
+private:
+    const std::size_t m_capacity;       ///< Maximum number of queued items
+    bool m_closed;                      ///< Set once close() has been called
+    std::deque<T> m_items;              ///< Queued items
+    mutable std::mutex m_mutex;         ///< Guards all members above
+    std::condition_variable m_notEmpty; ///< Signalled when an item is added
+    std::condition_variable m_notFull;  ///< Signalled when an item is removed
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -0,0 +1,277 @@
+#include "licensecache.h"
+#include "licensesigner.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+
+#include <openssl/evp.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Creates a cache.
+ * @param capacity Maximum number of licenses kept in memory (0 keeps none).
+ * @param directory Directory used as persistent store; empty for memory only.
+ */
+LicenseCache::LicenseCache(std::size_t capacity, const std::string &directory)
+    : m_capacity(capacity), m_directory(directory)
+{
+    std::error_code ec;
+    if (!m_directory.empty() && !fs::create_directories(m_directory, ec) && ec) {
+        std::cerr << "❌ Could not create cache directory " << m_directory << ", caching in memory only.\n";
+        m_directory.clear();
+    }
+}
+
+/**
+ * @brief Appends one length-prefixed field to a cache key.
+ * @param key Key under construction.
+ * @param value Field value.
+ */
+static void appendField(std::string &key, const std::string &value)
+{
+    key += std::to_string(value.size());
+    key += ':';
+    key += value;
+    key += '|';
+}
+
+/**
+ * @brief Builds the cache key for a license request.
+ *
+ * Every field is length-prefixed and always present, so no hardware ID can
+ * spell out the claims of another request and share its key.
+ *
+ * @param hardwareId The hardware fingerprint or ID.
+ * @param keyId Identifier of the signing key (LicenseSigner::keyId()).
+ * @param format Encoding of the license file.
+ * @param claims Expiry, features and component hashes signed into the license.
+ * @return Cache key.
+ */
+std::string LicenseCache::makeKey(const std::string &hardwareId, const std::string &keyId, LicenseFormat format,
+                                  const LicenseClaims &claims)
+{
+    std::string key;
+    appendField(key, keyId);
+    appendField(key, format == LicenseFormat::Binary ? "bin" : "json");
+    appendField(key, hardwareId);
+    appendField(key, std::to_string(claims.expiresAt));
+    appendField(key, claims.featureList());
+    appendField(key, LicenseClaims::componentList(claims.components));
+    appendField(key, std::to_string(claims.hasComponents() ? claims.effectiveRequiredMatches() : 0));
+    return key;
+}
+
+/**
+ * @brief Returns a cached license or produces, caches and returns a new one.
+ * @param key Cache key from makeKey().
+ * @param produce Called at most once per concurrent group of misses.
+ * @param license Receives the license file contents.
+ * @param cached Set to true if no new license had to be produced; may be null.
+ * @return true if a license is available, false if @p produce failed.
+ * @throws Whatever @p produce throws; waiting callers receive the same exception.
+ */
+bool LicenseCache::getOrCreate(const std::string &key, const Producer &produce, std::string &license, bool *cached)
+{
+    if (cached)
+        *cached = true;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (lookup(key, license))
+        return true;
+
+    // Someone is already producing this license: wait for their result
+    auto inFlight = m_inFlight.find(key);
+    if (inFlight != m_inFlight.end()) {
+        std::shared_future<std::string> pending = inFlight->second;
+        lock.unlock();
+        license = pending.get();
+        return !license.empty();
+    }
+
+    std::promise<std::string> promise;
+    m_inFlight.emplace(key, promise.get_future().share());
+    lock.unlock();
+
+    std::string result;
+    try {
+        if (!loadFromDisk(key, result)) {
+            if (cached)
+                *cached = false;
+            if (produce(result))
+                storeOnDisk(key, result);
+            else
+                result.clear();
+        }
+    } catch (...) {
+        // Release the key so the next request retries, and hand the error to the waiters
+        lock.lock();
+        m_inFlight.erase(key);
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    lock.lock();
+    if (!result.empty())
+        insert(key, result);
+    m_inFlight.erase(key);
+    lock.unlock();
+
+    promise.set_value(result);
+    license = std::move(result);
+    return !license.empty();
+}
+
+/**
+ * @brief Returns the number of licenses held in memory.
+ * @return Entry count.
+ */
+std::size_t LicenseCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+/**
+ * @brief Looks a key up in memory and marks it most recently used.
+ * @param key Cache key.
+ * @param license Receives the license on a hit.
+ * @return true on a hit.
+ */
+bool LicenseCache::lookup(const std::string &key, std::string &license)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+        return false;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    license = it->second->second;
+    return true;
+}
+
+/**
+ * @brief Inserts a license into memory, evicting the least recently used entry.
+ * @param key Cache key.
+ * @param license License file contents.
+ */
+void LicenseCache::insert(const std::string &key, const std::string &license)
+{
+    if (m_capacity == 0)
+        return;
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        it->second->second = license;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+
+    m_entries.emplace_front(key, license);
+    m_index.emplace(key, m_entries.begin());
+    if (m_entries.size() > m_capacity) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+}
+
+/**
+ * @brief Maps a cache key to its file in the persistent store.
+ *
+ * Keys contain arbitrary hardware IDs, so files are named by the SHA-256 of
+ * the key.
+ *
+ * @param key Cache key.
+ * @return File path.
+ */
+std::string LicenseCache::diskPath(const std::string &key) const
+{
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestLength = 0;
+    EVP_Digest(key.data(), key.size(), digest, &digestLength, EVP_sha256(), nullptr);
+    std::string name = LicenseSigner::toHex(std::string(reinterpret_cast<const char *>(digest), digestLength));
+    return (fs::path(m_directory) / (name + ".lic")).string();
+}
+
+/**
+ * @brief Reads a license from the persistent store.
+ * @param key Cache key.
+ * @param license Receives the license file contents.
+ * @return true if the license was found.
+ */
+bool LicenseCache::loadFromDisk(const std::string &key, std::string &license) const
+{
+    if (m_directory.empty())
+        return false;
+
+    std::ifstream in(diskPath(key), std::ios::binary);
+    if (!in.is_open())
+        return false;
+    license.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !license.empty();
+}
+
+/**
+ * @brief Flushes a closed file to stable storage.
+ * @param path File path.
+ * @return true on success.
+ */
+static bool syncFile(const std::string &path)
+{
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(fs::path(path).c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    bool ok = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    return ok;
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+/**
+ * @brief Writes a license to the persistent store (atomically, via rename).
+ *
+ * The temporary file is flushed, closed and synced before it replaces the
+ * entry, so a short write is never installed as a cached license.
+ *
+ * @param key Cache key.
+ * @param license License file contents.
+ */
+void LicenseCache::storeOnDisk(const std::string &key, const std::string &license) const
+{
+    if (m_directory.empty())
+        return;
+
+    std::string path = diskPath(key);
+    std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    out.write(license.data(), static_cast<std::streamsize>(license.size()));
+    out.flush();
+    out.close();
+
+    std::error_code ec;
+    if (!out || !syncFile(tempPath)) {
+        std::cerr << "❌ Could not write cache file " << tempPath << ".\n";
+        fs::remove(tempPath, ec);
+        return;
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec)
+        fs::remove(tempPath, ec);
+}
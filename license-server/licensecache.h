@@ -0,0 +1,124 @@
+#ifndef LICENSECACHE_H
+#define LICENSECACHE_H
+
+#include "licensegenerator.h"
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief The LicenseCache class
+ *
+ * Thread-safe cache of signed license files, keyed by hardware ID, signing
+ * key and output format. Recently issued licenses are kept in an in-memory
+ * LRU; optionally every license is also stored in a directory so that the
+ * cache survives restarts. Concurrent requests for the same key are
+ * coalesced: the first caller signs, the others wait for its result.
+ */
+class LicenseCache
+{
+public:
+    /**
+     * @brief Produces a license on a cache miss.
+     *
+     * Receives the license file contents; returns false if it failed.
+     */
+    using Producer = std::function<bool(std::string &license)>;
+
+    /**
+     * @brief Creates a cache.
+     * @param capacity Maximum number of licenses kept in memory (0 keeps none).
+     * @param directory Directory used as persistent store; empty for memory only.
+     */
+    explicit LicenseCache(std::size_t capacity, const std::string &directory = std::string());
+
+    /**
+     * @brief Builds the cache key for a license request.
+     * @param hardwareId The hardware fingerprint or ID.
+     * @param keyId Identifier of the signing key (LicenseSigner::keyId()).
+     * @param format Encoding of the license file.
+     * @param claims Expiry, features and component hashes signed into the license.
+     * @return Cache key.
+     */
+    static std::string makeKey(const std::string &hardwareId, const std::string &keyId, LicenseFormat format,
+                               const LicenseClaims &claims = LicenseClaims());
+
+    /**
+     * @brief Returns a cached license or produces, caches and returns a new one.
+     *
+     * Lookup order is memory, then disk, then @p produce. While one thread is
+     * producing a license for @p key, other callers with the same key block
+     * and receive the same result instead of signing again. If @p produce
+     * throws, the exception reaches this caller and every waiting one, and
+     * the key is released so that the next call produces again.
+     *
+     * @param key Cache key from makeKey().
+     * @param produce Called at most once per concurrent group of misses.
+     * @param license Receives the license file contents.
+     * @param cached Set to true if no new license had to be produced; may be null.
+     * @return true if a license is available, false if @p produce failed.
+     * @throws Whatever @p produce throws; waiting callers receive the same exception.
+     */
+    bool getOrCreate(const std::string &key, const Producer &produce, std::string &license, bool *cached = nullptr);
+
+    /**
+     * @brief Returns the number of licenses held in memory.
+     * @return Entry count.
+     */
+    std::size_t size() const;
+
+private:
+    using Entry = std::pair<std::string, std::string>; ///< Key and license
+
+    /**
+     * @brief Looks a key up in memory and marks it most recently used.
+     * @param key Cache key.
+     * @param license Receives the license on a hit.
+     * @return true on a hit.
+     */
+    bool lookup(const std::string &key, std::string &license);
+
+    /**
+     * @brief Inserts a license into memory, evicting the least recently used entry.
+     * @param key Cache key.
+     * @param license License file contents.
+     */
+    void insert(const std::string &key, const std::string &license);
+
+    /**
+     * @brief Maps a cache key to its file in the persistent store.
+     * @param key Cache key.
+     * @return File path.
+     */
+    std::string diskPath(const std::string &key) const;
+
+    /**
+     * @brief Reads a license from the persistent store.
+     * @param key Cache key.
+     * @param license Receives the license file contents.
+     * @return true if the license was found.
+     */
+    bool loadFromDisk(const std::string &key, std::string &license) const;
+
+    /**
+     * @brief Writes a license to the persistent store (atomically, via rename).
+     * @param key Cache key.
+     * @param license License file contents.
+     */
+    void storeOnDisk(const std::string &key, const std::string &license) const;
+
+    std::size_t m_capacity;  ///< Maximum number of entries in memory
+    std::string m_directory; ///< Persistent store, or empty
+    mutable std::mutex m_mutex; ///< Guards the members below
+    std::list<Entry> m_entries; ///< Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index; ///< Key to position in m_entries
+    std::unordered_map<std::string, std::shared_future<std::string>> m_inFlight; ///< Licenses being produced
+};
+
+#endif // LICENSECACHE_H
@@ -0,0 +1,265 @@
+#include "licensepipeline.h"
+#include "boundedqueue.h"
+#include "licensegenerator.h"
+#include "licenseregistry.h"
+#include "licensesigner.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A hardware ID waiting to be signed.
+ */
+struct SignJob
+{
+    std::size_t sequence = 0; ///< Position in the input stream
+    std::string hardwareId;   ///< Hardware ID to sign
+    LicenseClaims::ComponentHashes components; ///< Component hashes from the request line, if any
+};
+
+/**
+ * @brief A signed (or failed) license waiting to be written.
+ */
+struct SignedLicense
+{
+    std::size_t sequence = 0; ///< Position in the input stream
+    std::string hardwareId;   ///< Hardware ID that was signed
+    std::string licenseText;  ///< Encoded license (empty on failure)
+    bool ok = false;          ///< true if signing succeeded
+};
+
+/**
+ * @brief Writes one signed license to its file (or the NDJSON stream) and updates the counters.
+ * @param license License produced by a worker.
+ * @param outputDir Directory that receives the generated license files.
+ * @param stream NDJSON output, or null to write one file per license.
+ * @param registry Registry that records the license, or null.
+ * @param signer Signer whose algorithm and key ID are recorded.
+ * @param result Counters to update.
+ */
+static void writeSignedLicense(const SignedLicense &license, const std::string &outputDir, std::ostream *stream,
+                               LicenseRegistry *registry, const LicenseSigner &signer,
+                               LicensePipeline::Result &result)
+{
+    if (!license.ok) {
+        std::cerr << "❌ License generation failed for: " << license.hardwareId << "\n";
+        ++result.failed;
+        return;
+    }
+
+    if (stream) {
+        // Buffered by the stream; one line per license
+        *stream << license.licenseText << '\n';
+        if (!*stream) {
+            std::cerr << "❌ Could not write license for " << license.hardwareId << " to the output stream.\n";
+            ++result.failed;
+            return;
+        }
+    } else {
+        std::filesystem::path outputFile = std::filesystem::path(outputDir) / LicenseGenerator::licenseFileName(license.hardwareId);
+        std::ofstream out(outputFile, std::ios::binary);
+        if (out.is_open()) {
+            out << license.licenseText;
+            out.close();
+        }
+        if (!out) {
+            // Covers a full disk or I/O error while writing or closing, not only a failed open
+            std::cerr << "❌ Could not write " << outputFile.string() << ".\n";
+            ++result.failed;
+            return;
+        }
+    }
+
+    // Queued for the registry's next group commit; made durable before run() returns
+    if (registry && !registry->append(license.hardwareId, signer.algorithm(), signer.keyId(), license.licenseText, false)) {
+        std::cerr << "❌ Could not record license for " << license.hardwareId << " in the registry.\n";
+        ++result.failed;
+        return;
+    }
+    ++result.generated;
+}
+
+/**
+ * @brief Signs every hardware ID in a stream using a pool of worker threads.
+ *
+ * Pipeline layout:
+ * 1. The calling thread reads hardware IDs into a bounded input queue
+ * 2. N worker threads sign them, each with its own copy of the key
+ * 3. One writer thread stores the results, re-ordering them by input
+ *    position when Options::ordered is set, and queues them for the
+ *    LicenseRegistry (if configured), which group-commits them
+ *
+ * In ordered mode the reader never runs more than queueCapacity + threadCount
+ * IDs ahead of the writer, so a stalled worker cannot make the re-order
+ * buffer grow without bound.
+ *
+ * @param hardwareIds Stream of hardware IDs, one per line (file or stdin).
+ * @param privateKeyPath Path to the private key file (`private_key.pem`).
+ * @param outputDir Directory that receives the generated license files.
+ * @param options Thread count, queue size and output ordering.
+ * @param result Receives counters and timing for the run.
+ * @return false if the key or output directory could not be prepared, true otherwise.
+ */
+bool LicensePipeline::run(std::istream &hardwareIds, const std::string &privateKeyPath,
+                          const std::string &outputDir, const Options &options, Result &result)
+{
+    result = Result();
+
+    // Parse the PEM once; workers copy the parsed key
+    LicenseSigner master;
+    if (!master.loadPrivateKey(privateKeyPath)) {
+        return false;
+    }
+
+    if (options.stream && options.format == LicenseFormat::Binary) {
+        std::cerr << "❌ NDJSON output requires the JSON license format.\n";
+        return false;
+    }
+
+    std::error_code ec;
+    if (!options.stream)
+        std::filesystem::create_directories(outputDir, ec);
+    if (ec) {
+        std::cerr << "❌ Could not create output directory " << outputDir << ".\n";
+        return false;
+    }
+
+    std::unique_ptr<LicenseRegistry> registry;
+    std::size_t recordedBefore = 0;
+    if (!options.registryDirectory.empty()) {
+        registry.reset(new LicenseRegistry);
+        if (!registry->open(options.registryDirectory)) {
+            return false;
+        }
+        recordedBefore = registry->size();
+    }
+
+    // HSM signing waits on the device, not the CPU: keep more requests in flight
+    unsigned threadCount = options.threadCount;
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (options.threadCount == 0 && master.isHardwareBacked())
+        threadCount = std::max(threadCount, LicenseSigner::DefaultHardwareSessions);
+
+    std::vector<std::unique_ptr<LicenseSigner>> signers;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        std::unique_ptr<LicenseSigner> signer(new LicenseSigner);
+        if (!signer->copyKeyFrom(master)) {
+            return false;
+        }
+        signers.push_back(std::move(signer));
+    }
+    result.threadCount = threadCount;
+
+    BoundedQueue<SignJob> jobs(options.queueCapacity);
+    BoundedQueue<SignedLicense> signedLicenses(options.queueCapacity);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Signing workers
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        LicenseSigner *signer = signers[i].get();
+        workers.emplace_back([signer, &jobs, &signedLicenses, &options]() {
+            SignJob job;
+            std::string signature;
+            LicenseClaims claims = options.claims;
+            while (jobs.pop(job)) {
+                SignedLicense license;
+                license.sequence = job.sequence;
+                claims.components = std::move(job.components);
+                license.ok = LicenseGenerator::isValidHardwareId(job.hardwareId) &&
+                             signer->signRaw(LicenseClaims::signingPayload(job.hardwareId, claims), signature);
+                if (license.ok && options.stream)
+                    license.licenseText = LicenseGenerator::buildLicenseJson(job.hardwareId, LicenseSigner::toHex(signature),
+                                                                             signer->algorithm(), claims, signer->kid(), -1);
+                else if (license.ok)
+                    license.licenseText = LicenseGenerator::buildLicense(job.hardwareId, signature, signer->algorithm(),
+                                                                         options.format, claims, signer->kid());
+                license.hardwareId = std::move(job.hardwareId);
+                signedLicenses.push(std::move(license));
+            }
+        });
+    }
+
+    // Re-order window: sequence numbers the writer has not yet stored
+    const std::size_t window = std::max<std::size_t>(options.queueCapacity, 1) + threadCount;
+    std::mutex windowMutex;
+    std::condition_variable windowAdvanced;
+    std::size_t written = 0;
+
+    // Output writer
+    LicenseRegistry *registryPtr = registry.get();
+    std::thread writer([&signedLicenses, &outputDir, &options, &result, &master, registryPtr,
+                        &windowMutex, &windowAdvanced, &written]() {
+        std::map<std::size_t, SignedLicense> pending;
+        std::size_t nextSequence = 0;
+        SignedLicense license;
+        while (signedLicenses.pop(license)) {
+            if (!options.ordered) {
+                writeSignedLicense(license, outputDir, options.stream, registryPtr, master, result);
+                continue;
+            }
+
+            pending.emplace(license.sequence, std::move(license));
+            auto it = pending.begin();
+            while (it != pending.end() && it->first == nextSequence) {
+                writeSignedLicense(it->second, outputDir, options.stream, registryPtr, master, result);
+                it = pending.erase(it);
+                ++nextSequence;
+            }
+            {
+                std::lock_guard<std::mutex> lock(windowMutex);
+                written = nextSequence;
+            }
+            windowAdvanced.notify_one();
+        }
+    });
+
+    // Feed the input queue
+    std::size_t sequence = 0;
+    std::string line;
+    while (std::getline(hardwareIds, line)) {
+        SignJob job;
+        job.hardwareId = LicenseGenerator::parseRequestLine(line, job.components);
+        if (job.hardwareId.empty())
+            continue;
+        if (options.ordered) {
+            std::unique_lock<std::mutex> lock(windowMutex);
+            windowAdvanced.wait(lock, [&] { return sequence - written < window; });
+        }
+        job.sequence = sequence++;
+        jobs.push(std::move(job));
+    }
+
+    jobs.close();
+    for (std::thread &worker : workers)
+        worker.join();
+    signedLicenses.close();
+    writer.join();
+    if (options.stream && !options.stream->flush()) {
+        // Any part of the buffered output may be missing, so none of it counts as written
+        std::cerr << "❌ Could not write the output stream; " << result.generated << " license(s) may be lost.\n";
+        result.failed += result.generated;
+        result.generated = 0;
+    }
+    if (registry && !registry->flush()) {
+        // Licenses without a durable audit record count as failed, as the server never hands them out
+        std::size_t recorded = std::min(result.generated, registry->size() - recordedBefore);
+        std::cerr << "❌ License registry could not be written; " << result.generated - recorded
+                  << " license(s) are not recorded.\n";
+        result.failed += result.generated - recorded;
+        result.generated = recorded;
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
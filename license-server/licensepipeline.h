@@ -0,0 +1,81 @@
+#ifndef LICENSEPIPELINE_H
+#define LICENSEPIPELINE_H
+
+#include "licensegenerator.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief The LicensePipeline class
+ *
+ * Parallel bulk issuance engine. Hardware IDs are read into a bounded input
+ * queue, signed by a pool of worker threads that each own a private copy of
+ * the signing key and digest context, and handed to a single writer thread
+ * that stores the licenses either in input order or as soon as they are ready.
+ * Nothing is held per run beyond the bounded queues and, in ordered mode, a
+ * re-order window of about the same size, so memory use does not grow with the
+ * size of the batch.
+ */
+class LicensePipeline
+{
+public:
+    /**
+     * @brief Tuning knobs for a pipeline run.
+     */
+    struct Options
+    {
+        unsigned threadCount = 0;         ///< Number of signing threads (0 = one per core, at least LicenseSigner::DefaultHardwareSessions for an HSM key)
+        std::size_t queueCapacity = 1024; ///< Maximum number of queued hardware IDs
+        bool ordered = false;             ///< Write licenses in input order
+        LicenseFormat format = LicenseFormat::Json; ///< Encoding of the license files
+        std::string registryDirectory;    ///< Record issued licenses in this LicenseRegistry; empty to skip
+        LicenseClaims claims;             ///< Expiry and features signed into every license (components come from each line)
+        std::ostream *stream = nullptr;   ///< Write NDJSON (one compact JSON license per line) here instead of files
+    };
+
+    /**
+     * @brief Outcome of a pipeline run.
+     */
+    struct Result
+    {
+        std::size_t generated = 0; ///< Licenses written successfully
+        std::size_t failed = 0;    ///< Hardware IDs that could not be signed, written or recorded (all streamed ones if flushing failed)
+        unsigned threadCount = 0;  ///< Signing threads actually used
+        double seconds = 0.0;      ///< Wall-clock duration of the run
+
+        /**
+         * @brief Returns the achieved throughput.
+         * @return Generated licenses per second.
+         */
+        double licensesPerSecond() const
+        {
+            return seconds > 0.0 ? generated / seconds : 0.0;
+        }
+    };
+
+    /**
+     * @brief Signs every hardware ID in a stream using a pool of worker threads.
+     *
+     * Each non-empty line of @p hardwareIds is one hardware ID, optionally
+     * followed by its component hashes (see LicenseGenerator::parseRequestLine());
+     * its license is written to `<outputDir>/<hardwareId>.lic`, or appended as one line to
+     * Options::stream.
+     *
+     * @param hardwareIds Stream of hardware IDs, one per line (file or stdin).
+     * @param privateKeyPath Path to the private key file (`private_key.pem`).
+     * @param outputDir Directory that receives the generated license files (unused with Options::stream).
+     * @param options Thread count, queue size and output ordering.
+     * @param result Receives counters and timing for the run.
+     * @return false if the key or output directory could not be prepared, or
+     *         NDJSON output was requested with the binary format; true otherwise.
+     */
+    static bool run(std::istream &hardwareIds,
+                    const std::string &privateKeyPath,
+                    const std::string &outputDir,
+                    const Options &options,
+                    Result &result);
+};
+
+#endif // LICENSEPIPELINE_H
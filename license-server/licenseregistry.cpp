@@ -0,0 +1,996 @@
+#include "licenseregistry.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+/// Size of the per-record header: payload length and CRC32.
+static constexpr std::uint64_t RecordHeaderSize = 8;
+
+/// Fixed part of a record payload: issuedAt, previous, three u16 lengths and one u32 length.
+static constexpr std::uint32_t RecordFixedSize = 8 + 8 + 2 + 2 + 2 + 4;
+
+/// Size of the index header.
+static constexpr std::uint64_t IndexHeaderSize = 56;
+
+/// Size of one index slot: hardware ID hash and log offset + 1 (0 = empty).
+static constexpr std::uint64_t IndexSlotSize = 16;
+
+/// Index format version.
+static constexpr std::uint32_t IndexVersion = 2;
+
+/// Initial number of index slots (a power of two).
+static constexpr std::uint64_t InitialIndexCapacity = 1024;
+
+/**
+ * @brief Positional file I/O on a native handle.
+ *
+ * Reads may run concurrently with each other and with appends beyond the
+ * range being read.
+ */
+class LicenseRegistry::File
+{
+public:
+    ~File() { close(); }
+
+    /**
+     * @brief Opens a file for reading and writing, creating it if needed.
+     * @param path File path.
+     * @return true on success.
+     */
+    bool open(const fs::path &path)
+    {
+#ifdef _WIN32
+        m_handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                               OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return m_handle != INVALID_HANDLE_VALUE;
+#else
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        return m_fd >= 0;
+#endif
+    }
+
+    /**
+     * @brief Closes the file.
+     */
+    void close()
+    {
+#ifdef _WIN32
+        if (m_handle != INVALID_HANDLE_VALUE)
+            CloseHandle(m_handle);
+        m_handle = INVALID_HANDLE_VALUE;
+#else
+        if (m_fd >= 0)
+            ::close(m_fd);
+        m_fd = -1;
+#endif
+    }
+
+    /**
+     * @brief Reads exactly @p size bytes at @p offset.
+     * @param offset File offset.
+     * @param data Output buffer.
+     * @param size Number of bytes.
+     * @return true if all bytes were read.
+     */
+    bool readAt(std::uint64_t offset, void *data, std::size_t size) const
+    {
+        char *out = static_cast<char *>(data);
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD chunk = 0;
+            DWORD request = static_cast<DWORD>(std::min<std::size_t>(size, 1u << 30));
+            if (!ReadFile(m_handle, out, request, &chunk, &overlapped) || chunk == 0)
+                return false;
+#else
+            ssize_t chunk = ::pread(m_fd, out, size, static_cast<off_t>(offset));
+            if (chunk <= 0)
+                return false;
+#endif
+            out += chunk;
+            offset += static_cast<std::uint64_t>(chunk);
+            size -= static_cast<std::size_t>(chunk);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes exactly @p size bytes at @p offset.
+     * @param offset File offset.
+     * @param data Bytes to write.
+     * @param size Number of bytes.
+     * @return true if all bytes were written.
+     */
+    bool writeAt(std::uint64_t offset, const void *data, std::size_t size)
+    {
+        const char *in = static_cast<const char *>(data);
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD chunk = 0;
+            DWORD request = static_cast<DWORD>(std::min<std::size_t>(size, 1u << 30));
+            if (!WriteFile(m_handle, in, request, &chunk, &overlapped) || chunk == 0)
+                return false;
+#else
+            ssize_t chunk = ::pwrite(m_fd, in, size, static_cast<off_t>(offset));
+            if (chunk <= 0)
+                return false;
+#endif
+            in += chunk;
+            offset += static_cast<std::uint64_t>(chunk);
+            size -= static_cast<std::size_t>(chunk);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Flushes written data to stable storage.
+     * @return true on success.
+     */
+    bool sync()
+    {
+#ifdef _WIN32
+        return FlushFileBuffers(m_handle) != 0;
+#elif defined(__APPLE__)
+        return ::fsync(m_fd) == 0;
+#else
+        return ::fdatasync(m_fd) == 0;
+#endif
+    }
+
+    /**
+     * @brief Truncates or extends the file.
+     * @param size New file size.
+     * @return true on success.
+     */
+    bool truncate(std::uint64_t size)
+    {
+#ifdef _WIN32
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(size);
+        return SetFilePointerEx(m_handle, position, nullptr, FILE_BEGIN) && SetEndOfFile(m_handle);
+#else
+        return ::ftruncate(m_fd, static_cast<off_t>(size)) == 0;
+#endif
+    }
+
+    /**
+     * @brief Returns the current file size.
+     * @return Size in bytes.
+     */
+    std::uint64_t size() const
+    {
+#ifdef _WIN32
+        LARGE_INTEGER size;
+        return GetFileSizeEx(m_handle, &size) ? static_cast<std::uint64_t>(size.QuadPart) : 0;
+#else
+        struct stat info;
+        return ::fstat(m_fd, &info) == 0 ? static_cast<std::uint64_t>(info.st_size) : 0;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE m_handle = INVALID_HANDLE_VALUE; ///< Native file handle
+#else
+    int m_fd = -1;                          ///< Native file descriptor
+#endif
+};
+
+/**
+ * @brief CRC32 (IEEE 802.3) lookup table.
+ */
+struct Crc32Table
+{
+    std::uint32_t values[256]; ///< CRC of every byte value
+
+    constexpr Crc32Table() : values()
+    {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            values[i] = crc;
+        }
+    }
+};
+
+static constexpr Crc32Table CrcTable;
+
+/**
+ * @brief Computes the CRC32 of a buffer.
+ * @param data Bytes to checksum.
+ * @param size Number of bytes.
+ * @return CRC32 value.
+ */
+static std::uint32_t crc32(const unsigned char *data, std::size_t size)
+{
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i)
+        crc = CrcTable.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Hashes a hardware ID for the index (64-bit FNV-1a).
+ * @param hardwareId Hardware ID.
+ * @return Hash value.
+ */
+static std::uint64_t hashHardwareId(const std::string &hardwareId)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : hardwareId) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Appends a little-endian integer to a buffer.
+ * @param out Output buffer.
+ * @param value Value to append.
+ * @param bytes Number of bytes to write.
+ */
+static void putLittleEndian(std::string &out, std::uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * @brief Reads a little-endian integer.
+ * @param data Input bytes.
+ * @param bytes Number of bytes to read.
+ * @return Decoded value.
+ */
+static std::uint64_t getLittleEndian(const unsigned char *data, int bytes)
+{
+    std::uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+/**
+ * @brief Decodes a record payload.
+ * @param payload Payload bytes (after the record header).
+ * @param length Payload length.
+ * @param record Receives the fields (offset is left untouched).
+ * @return true if the field lengths match the payload length.
+ */
+static bool parsePayload(const unsigned char *payload, std::uint32_t length, LicenseRegistry::Record &record)
+{
+    if (length < RecordFixedSize)
+        return false;
+    std::size_t idLength = static_cast<std::size_t>(getLittleEndian(payload + 16, 2));
+    std::size_t algorithmLength = static_cast<std::size_t>(getLittleEndian(payload + 18, 2));
+    std::size_t keyIdLength = static_cast<std::size_t>(getLittleEndian(payload + 20, 2));
+    std::size_t licenseLength = static_cast<std::size_t>(getLittleEndian(payload + 22, 4));
+    if (RecordFixedSize + idLength + algorithmLength + keyIdLength + licenseLength != length)
+        return false;
+
+    const char *text = reinterpret_cast<const char *>(payload + RecordFixedSize);
+    record.issuedAt = static_cast<std::int64_t>(getLittleEndian(payload, 8));
+    record.previous = getLittleEndian(payload + 8, 8);
+    record.hardwareId.assign(text, idLength);
+    record.algorithm.assign(text + idLength, algorithmLength);
+    record.keyId.assign(text + idLength + algorithmLength, keyIdLength);
+    record.license.assign(text + idLength + algorithmLength + keyIdLength, licenseLength);
+    return true;
+}
+
+/**
+ * @brief Returns the current time in milliseconds since the Unix epoch.
+ * @return Current time.
+ */
+static std::int64_t currentTimeMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+LicenseRegistry::LicenseRegistry()
+    : m_logSize(0), m_indexCapacity(0), m_indexCount(0), m_lastIssuedAt(0), m_recordCount(0),
+      m_timelineLoaded(false), m_enqueued(0), m_durable(0), m_failed(false), m_stopping(false)
+{
+}
+
+LicenseRegistry::~LicenseRegistry()
+{
+    close();
+}
+
+/**
+ * @brief Opens (or creates) the registry in a directory.
+ *
+ * The index is trusted only if it was closed cleanly and covers exactly the
+ * current log; the log is then not read at all. Otherwise the log is replayed
+ * and the index rebuilt. Until close() the index is marked dirty so that a
+ * crash forces a rebuild.
+ *
+ * @param directory Directory holding `registry.log` and `registry.idx`.
+ * @param options Group commit settings.
+ * @return true if the registry is ready.
+ */
+bool LicenseRegistry::open(const std::string &directory, const Options &options)
+{
+    close();
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    m_log.reset(new File);
+    m_index.reset(new File);
+    if (!m_log->open(fs::path(directory) / "registry.log") || !m_index->open(fs::path(directory) / "registry.idx")) {
+        std::cerr << "❌ Could not open license registry in " << directory << ".\n";
+        m_log.reset();
+        m_index.reset();
+        return false;
+    }
+
+    unsigned char header[IndexHeaderSize];
+    bool indexValid = m_index->size() >= IndexHeaderSize && m_index->readAt(0, header, sizeof(header)) &&
+                      std::equal(header, header + 4, "CLRI") &&
+                      getLittleEndian(header + 4, 4) == IndexVersion &&
+                      getLittleEndian(header + 8, 4) == 1 &&
+                      getLittleEndian(header + 32, 8) == m_log->size();
+    if (indexValid) {
+        m_indexCapacity = getLittleEndian(header + 16, 8);
+        m_indexCount = getLittleEndian(header + 24, 8);
+        indexValid = m_indexCapacity >= InitialIndexCapacity && (m_indexCapacity & (m_indexCapacity - 1)) == 0 &&
+                     m_index->size() == IndexHeaderSize + m_indexCapacity * IndexSlotSize;
+    }
+    if (indexValid) {
+        m_logSize = getLittleEndian(header + 32, 8);
+        m_recordCount = getLittleEndian(header + 40, 8);
+        m_lastIssuedAt = static_cast<std::int64_t>(getLittleEndian(header + 48, 8));
+        m_timeline.clear();
+        m_timelineLoaded = false;
+    }
+
+    std::vector<std::pair<std::string, std::uint64_t>> ids;
+    if ((!indexValid && (!recoverLog(ids) || !rebuildIndex(ids))) ||
+        !writeIndexHeader(false) || !m_index->sync()) {
+        std::cerr << "❌ Could not recover license registry in " << directory << ".\n";
+        m_log.reset();
+        m_index.reset();
+        return false;
+    }
+
+    m_options = options;
+    m_queue.clear();
+    m_enqueued = 0;
+    m_durable = 0;
+    m_failed = false;
+    m_stopping = false;
+    m_writer = std::thread(&LicenseRegistry::writerLoop, this);
+    return true;
+}
+
+/**
+ * @brief Opens (or creates) the registry with default options.
+ * @param directory Directory holding `registry.log` and `registry.idx`.
+ * @return true if the registry is ready.
+ */
+bool LicenseRegistry::open(const std::string &directory)
+{
+    return open(directory, Options());
+}
+
+/**
+ * @brief Commits all queued records, stops the writer and closes the files.
+ */
+void LicenseRegistry::close()
+{
+    if (!m_writer.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopping = true;
+    }
+    m_queueReady.notify_all();
+    m_writer.join();
+
+    // A failed commit leaves the index dirty so that the next open() rebuilds it
+    if (!m_failed && (!writeIndexHeader(true) || !m_index->sync()))
+        std::cerr << "❌ Could not close license registry index.\n";
+
+    std::unique_lock<std::shared_mutex> lock(m_dataMutex);
+    m_log.reset();
+    m_index.reset();
+    m_timeline.clear();
+    m_timelineLoaded = false;
+    m_logSize = 0;
+    m_indexCapacity = 0;
+    m_indexCount = 0;
+    m_lastIssuedAt = 0;
+    m_recordCount = 0;
+}
+
+/**
+ * @brief Checks whether the registry is open.
+ * @return true between a successful open() and close().
+ */
+bool LicenseRegistry::isOpen() const
+{
+    return m_writer.joinable();
+}
+
+/**
+ * @brief Records an issued license.
+ * @param hardwareId Licensed hardware ID.
+ * @param algorithm Signature algorithm.
+ * @param keyId Signing key identifier.
+ * @param license License file contents.
+ * @param waitDurable Block until the record has been written and synced.
+ * @return false if the registry is closed or a write failed, true otherwise.
+ */
+bool LicenseRegistry::append(const std::string &hardwareId, const std::string &algorithm,
+                             const std::string &keyId, const std::string &license, bool waitDurable)
+{
+    if (hardwareId.size() > 0xFFFF || algorithm.size() > 0xFFFF || keyId.size() > 0xFFFF ||
+        license.size() > 0xFFFFFFFFu - RecordFixedSize - 3 * 0xFFFF)
+        return false;
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    if (!m_writer.joinable() || m_stopping || m_failed)
+        return false;
+
+    Pending pending;
+    pending.sequence = ++m_enqueued;
+    pending.hardwareId = hardwareId;
+    pending.algorithm = algorithm;
+    pending.keyId = keyId;
+    pending.license = license;
+    std::uint64_t sequence = pending.sequence;
+    m_queue.push_back(std::move(pending));
+    m_queueReady.notify_one();
+
+    if (!waitDurable)
+        return true;
+    m_committed.wait(lock, [this, sequence] { return m_durable >= sequence || m_failed; });
+    return m_durable >= sequence;
+}
+
+/**
+ * @brief Waits until every record appended so far is durable.
+ * @return false if a write failed, true otherwise.
+ */
+bool LicenseRegistry::flush()
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    std::uint64_t sequence = m_enqueued;
+    m_committed.wait(lock, [this, sequence] { return m_durable >= sequence || m_failed; });
+    return m_durable >= sequence;
+}
+
+/**
+ * @brief Writer thread main loop.
+ *
+ * Everything queued while a commit is in progress becomes the next batch,
+ * so the number of fsyncs adapts to the append rate.
+ */
+void LicenseRegistry::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    for (;;) {
+        m_queueReady.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_queue.empty())
+            break; // Stopping and drained
+
+        std::vector<Pending> batch;
+        if (m_queue.size() <= m_options.maxBatch) {
+            batch.swap(m_queue);
+        } else {
+            auto end = m_queue.begin() + static_cast<std::ptrdiff_t>(m_options.maxBatch);
+            batch.assign(std::make_move_iterator(m_queue.begin()), std::make_move_iterator(end));
+            m_queue.erase(m_queue.begin(), end);
+        }
+
+        lock.unlock();
+        bool ok = commit(batch);
+        lock.lock();
+
+        if (ok) {
+            m_durable = batch.back().sequence;
+        } else {
+            m_failed = true;
+            m_queue.clear();
+        }
+        m_committed.notify_all();
+    }
+}
+
+/**
+ * @brief Writes, syncs and indexes one batch of records.
+ *
+ * Record layout (little-endian):
+ *
+ *     u32 payload length | u32 CRC32 of payload |
+ *     u64 issuedAt | u64 previous | u16 idLen | u16 algLen | u16 keyIdLen | u32 licenseLen |
+ *     hardware ID | algorithm | key ID | license
+ *
+ * @param batch Records to commit.
+ * @return true on success.
+ */
+bool LicenseRegistry::commit(std::vector<Pending> &batch)
+{
+    std::string buffer;
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(batch.size());
+    std::unordered_map<std::string, std::uint64_t> batchLatest;
+    std::uint64_t logOffset;
+    std::int64_t issuedAt;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(m_dataMutex);
+        logOffset = m_logSize;
+        issuedAt = std::max(currentTimeMs(), m_lastIssuedAt);
+
+        for (const Pending &pending : batch) {
+            std::uint64_t previous = 0;
+            auto latest = batchLatest.find(pending.hardwareId);
+            if (latest != batchLatest.end()) {
+                previous = latest->second + 1;
+            } else {
+                std::uint64_t offset = 0;
+                std::uint64_t slot = 0;
+                if (lookupOffset(pending.hardwareId, offset, slot))
+                    previous = offset + 1;
+            }
+
+            std::string payload;
+            payload.reserve(RecordFixedSize + pending.hardwareId.size() + pending.algorithm.size() +
+                            pending.keyId.size() + pending.license.size());
+            putLittleEndian(payload, static_cast<std::uint64_t>(issuedAt), 8);
+            putLittleEndian(payload, previous, 8);
+            putLittleEndian(payload, pending.hardwareId.size(), 2);
+            putLittleEndian(payload, pending.algorithm.size(), 2);
+            putLittleEndian(payload, pending.keyId.size(), 2);
+            putLittleEndian(payload, pending.license.size(), 4);
+            payload += pending.hardwareId;
+            payload += pending.algorithm;
+            payload += pending.keyId;
+            payload += pending.license;
+
+            std::uint64_t recordOffset = logOffset + buffer.size();
+            putLittleEndian(buffer, payload.size(), 4);
+            putLittleEndian(buffer, crc32(reinterpret_cast<const unsigned char *>(payload.data()), payload.size()), 4);
+            buffer += payload;
+            batchLatest[pending.hardwareId] = recordOffset;
+            offsets.push_back(recordOffset);
+        }
+    }
+
+    // One write and one sync for the whole batch
+    if (!m_log->writeAt(logOffset, buffer.data(), buffer.size()) || (m_options.sync && !m_log->sync())) {
+        std::cerr << "❌ Could not write license registry log.\n";
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_dataMutex);
+    m_logSize = logOffset + buffer.size();
+    m_lastIssuedAt = issuedAt;
+    m_recordCount += batch.size();
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (m_timelineLoaded)
+            m_timeline.emplace_back(issuedAt, offsets[i]);
+        if (!indexRecord(batch[i].hardwareId, offsets[i])) {
+            std::cerr << "❌ Could not update license registry index.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the log sequentially and visits every valid record.
+ *
+ * Reads in large chunks and checks every record's length and CRC. A bad
+ * record only counts as a torn tail, i.e. an append cut short by a crash,
+ * if it reaches the end of the log or is followed by nothing but zeros
+ * (space a file system allocated but never wrote).
+ *
+ * @param size Number of log bytes to read.
+ * @param visit Called for each record, oldest first.
+ * @param end Receives the offset after the last valid record.
+ * @return How the replay ended.
+ */
+LicenseRegistry::Replay LicenseRegistry::replayLog(std::uint64_t size,
+                                                   const std::function<void(const Record &record)> &visit,
+                                                   std::uint64_t &end) const
+{
+    std::vector<unsigned char> chunk(1 << 20);
+    std::uint64_t chunkStart = 0;
+    std::size_t chunkLength = 0;
+    bool readFailed = false;
+
+    // Returns a pointer to [offset, offset + length) of the log, reading a new chunk when needed
+    auto view = [&](std::uint64_t offset, std::size_t length) -> const unsigned char * {
+        if (offset >= chunkStart && offset + length <= chunkStart + chunkLength)
+            return chunk.data() + (offset - chunkStart);
+        if (length > chunk.size())
+            chunk.resize(length);
+        chunkStart = offset;
+        chunkLength = static_cast<std::size_t>(std::min<std::uint64_t>(chunk.size(), size - offset));
+        if (chunkLength < length || !m_log->readAt(offset, chunk.data(), chunkLength)) {
+            readFailed = chunkLength >= length;
+            chunkLength = 0;
+            return nullptr;
+        }
+        return chunk.data();
+    };
+
+    // Checks whether [offset, size) holds only zero bytes
+    auto zeroTail = [&](std::uint64_t offset) {
+        for (; offset < size; offset += chunk.size()) {
+            std::size_t length = static_cast<std::size_t>(std::min<std::uint64_t>(chunk.size(), size - offset));
+            const unsigned char *data = view(offset, length);
+            if (!data || std::any_of(data, data + length, [](unsigned char c) { return c != 0; }))
+                return false;
+        }
+        return true;
+    };
+
+    std::uint64_t position = 0;
+    Record record;
+    while (position < size) {
+        if (position + RecordHeaderSize > size)
+            break; // Header cut short by the end of the log
+        const unsigned char *header = view(position, RecordHeaderSize);
+        if (!header) {
+            end = position;
+            return Replay::Corrupt;
+        }
+        std::uint32_t length = static_cast<std::uint32_t>(getLittleEndian(header, 4));
+        std::uint32_t crc = static_cast<std::uint32_t>(getLittleEndian(header + 4, 4));
+        const std::uint64_t recordEnd = position + RecordHeaderSize + length;
+        if (recordEnd > size)
+            break; // Payload cut short by the end of the log
+
+        const unsigned char *payload = length >= RecordFixedSize ? view(position + RecordHeaderSize, length) : nullptr;
+        if (!payload || crc32(payload, length) != crc || !parsePayload(payload, length, record)) {
+            end = position;
+            if (readFailed || (recordEnd != size && !zeroTail(position)))
+                return Replay::Corrupt;
+            return Replay::TornTail;
+        }
+
+        record.offset = position;
+        visit(record);
+        position = recordEnd;
+    }
+    end = position;
+    return position == size ? Replay::Complete : Replay::TornTail;
+}
+
+/**
+ * @brief Replays the log after an unclean shutdown, truncating a torn tail.
+ *
+ * Rebuilds the timeline, the record count and the newest issue time as a
+ * side effect.
+ *
+ * @param ids Receives hardware ID to latest offset (index rebuild).
+ * @return true on success, false if the log is corrupt.
+ */
+bool LicenseRegistry::recoverLog(std::vector<std::pair<std::string, std::uint64_t>> &ids)
+{
+    const std::uint64_t size = m_log->size();
+    std::unordered_map<std::string, std::uint64_t> latest;
+    m_timeline.clear();
+    m_lastIssuedAt = 0;
+
+    std::uint64_t position = 0;
+    Replay result = replayLog(size, [&](const Record &record) {
+        m_timeline.emplace_back(record.issuedAt, record.offset);
+        m_lastIssuedAt = std::max(m_lastIssuedAt, record.issuedAt);
+        latest[record.hardwareId] = record.offset;
+    }, position);
+
+    if (result == Replay::Corrupt) {
+        std::cerr << "❌ License registry log is damaged at offset " << position << " with "
+                  << (size - position) << " byte(s) after it; not truncating.\n";
+        return false;
+    }
+    if (result == Replay::TornTail) {
+        std::cerr << "⚠ Discarding " << (size - position) << " byte(s) of incomplete registry log.\n";
+        if (!m_log->truncate(position) || !m_log->sync())
+            return false;
+    }
+    m_logSize = position;
+    m_recordCount = m_timeline.size();
+    m_timelineLoaded = true;
+    ids.assign(latest.begin(), latest.end());
+    return true;
+}
+
+/**
+ * @brief Builds the timeline from the committed log (m_dataMutex held exclusively).
+ *
+ * Only needed for a registry opened through a clean index; the committed
+ * log is expected to consist of valid records only.
+ *
+ * @return true on success.
+ */
+bool LicenseRegistry::loadTimeline() const
+{
+    std::vector<std::pair<std::int64_t, std::uint64_t>> timeline;
+    timeline.reserve(static_cast<std::size_t>(m_recordCount));
+    std::uint64_t end = 0;
+    if (replayLog(m_logSize, [&](const Record &record) { timeline.emplace_back(record.issuedAt, record.offset); },
+                  end) != Replay::Complete) {
+        std::cerr << "❌ License registry log is damaged at offset " << end << ".\n";
+        return false;
+    }
+    m_timeline.swap(timeline);
+    m_timelineLoaded = true;
+    return true;
+}
+
+/**
+ * @brief Writes a fresh index for the given hardware IDs.
+ * @param ids Hardware ID and latest log offset of every licensed machine.
+ * @return true on success.
+ */
+bool LicenseRegistry::rebuildIndex(const std::vector<std::pair<std::string, std::uint64_t>> &ids)
+{
+    std::uint64_t capacity = InitialIndexCapacity;
+    while (ids.size() * 10 > capacity * 7)
+        capacity *= 2;
+
+    std::string slots(static_cast<std::size_t>(capacity * IndexSlotSize), '\0');
+    for (const auto &entry : ids) {
+        std::uint64_t hash = hashHardwareId(entry.first);
+        std::uint64_t slot = hash & (capacity - 1);
+        while (getLittleEndian(reinterpret_cast<const unsigned char *>(&slots[slot * IndexSlotSize + 8]), 8) != 0)
+            slot = (slot + 1) & (capacity - 1);
+        std::string value;
+        putLittleEndian(value, hash, 8);
+        putLittleEndian(value, entry.second + 1, 8);
+        slots.replace(static_cast<std::size_t>(slot * IndexSlotSize), IndexSlotSize, value);
+    }
+
+    m_indexCapacity = capacity;
+    m_indexCount = ids.size();
+    return m_index->truncate(0) && writeIndexHeader(false) &&
+           m_index->writeAt(IndexHeaderSize, slots.data(), slots.size());
+}
+
+/**
+ * @brief Writes the index header.
+ *
+ * Layout: magic "CLRI", u32 version, u32 clean flag, u32 reserved,
+ * u64 capacity, u64 entry count, u64 covered log size, u64 record count,
+ * i64 newest issue time.
+ *
+ * @param clean true when the index is consistent with the log.
+ * @return true on success.
+ */
+bool LicenseRegistry::writeIndexHeader(bool clean)
+{
+    std::string header("CLRI");
+    putLittleEndian(header, IndexVersion, 4);
+    putLittleEndian(header, clean ? 1 : 0, 4);
+    putLittleEndian(header, 0, 4);
+    putLittleEndian(header, m_indexCapacity, 8);
+    putLittleEndian(header, m_indexCount, 8);
+    putLittleEndian(header, m_logSize, 8);
+    putLittleEndian(header, m_recordCount, 8);
+    putLittleEndian(header, static_cast<std::uint64_t>(m_lastIssuedAt), 8);
+    return m_index->writeAt(0, header.data(), header.size());
+}
+
+/**
+ * @brief Finds the log offset of the latest record for a hardware ID.
+ *
+ * Linear probing from the hash's home slot; a slot whose hash matches is
+ * confirmed against the hardware ID stored in the log.
+ *
+ * @param hardwareId Hardware ID to look up.
+ * @param offset Receives the log offset.
+ * @param slot Receives the index slot holding the entry, or the free slot to use.
+ * @return true if the hardware ID is indexed.
+ */
+bool LicenseRegistry::lookupOffset(const std::string &hardwareId, std::uint64_t &offset, std::uint64_t &slot) const
+{
+    slot = m_indexCapacity;
+    if (m_indexCapacity == 0)
+        return false;
+
+    const std::uint64_t hash = hashHardwareId(hardwareId);
+    std::uint64_t position = hash & (m_indexCapacity - 1);
+    for (std::uint64_t probe = 0; probe < m_indexCapacity; ++probe) {
+        unsigned char raw[IndexSlotSize];
+        if (!m_index->readAt(IndexHeaderSize + position * IndexSlotSize, raw, sizeof(raw)))
+            return false;
+        std::uint64_t slotHash = getLittleEndian(raw, 8);
+        std::uint64_t slotOffset = getLittleEndian(raw + 8, 8);
+        if (slotOffset == 0) {
+            slot = position;
+            return false;
+        }
+        Record record;
+        if (slotHash == hash && readRecord(slotOffset - 1, record) && record.hardwareId == hardwareId) {
+            offset = slotOffset - 1;
+            slot = position;
+            return true;
+        }
+        position = (position + 1) & (m_indexCapacity - 1);
+    }
+    return false;
+}
+
+/**
+ * @brief Points the index entry of a hardware ID at a new record.
+ * @param hardwareId Hardware ID.
+ * @param offset Log offset of its latest record.
+ * @return true on success.
+ */
+bool LicenseRegistry::indexRecord(const std::string &hardwareId, std::uint64_t offset)
+{
+    std::uint64_t existing = 0;
+    std::uint64_t slot = 0;
+    if (!lookupOffset(hardwareId, existing, slot)) {
+        if (slot >= m_indexCapacity)
+            return false;
+        ++m_indexCount;
+    }
+
+    std::string value;
+    putLittleEndian(value, hashHardwareId(hardwareId), 8);
+    putLittleEndian(value, offset + 1, 8);
+    if (!m_index->writeAt(IndexHeaderSize + slot * IndexSlotSize, value.data(), value.size()))
+        return false;
+
+    return m_indexCount * 10 <= m_indexCapacity * 7 || growIndex();
+}
+
+/**
+ * @brief Doubles the index capacity and rehashes all entries.
+ * @return true on success.
+ */
+bool LicenseRegistry::growIndex()
+{
+    std::string oldSlots(static_cast<std::size_t>(m_indexCapacity * IndexSlotSize), '\0');
+    if (!m_index->readAt(IndexHeaderSize, &oldSlots[0], oldSlots.size()))
+        return false;
+
+    const std::uint64_t capacity = m_indexCapacity * 2;
+    std::string slots(static_cast<std::size_t>(capacity * IndexSlotSize), '\0');
+    for (std::uint64_t i = 0; i < m_indexCapacity; ++i) {
+        const unsigned char *raw = reinterpret_cast<const unsigned char *>(&oldSlots[i * IndexSlotSize]);
+        if (getLittleEndian(raw + 8, 8) == 0)
+            continue;
+        std::uint64_t slot = getLittleEndian(raw, 8) & (capacity - 1);
+        while (getLittleEndian(reinterpret_cast<const unsigned char *>(&slots[slot * IndexSlotSize + 8]), 8) != 0)
+            slot = (slot + 1) & (capacity - 1);
+        slots.replace(static_cast<std::size_t>(slot * IndexSlotSize), IndexSlotSize,
+                      oldSlots, static_cast<std::size_t>(i * IndexSlotSize), IndexSlotSize);
+    }
+
+    m_indexCapacity = capacity;
+    return writeIndexHeader(false) && m_index->writeAt(IndexHeaderSize, slots.data(), slots.size());
+}
+
+/**
+ * @brief Reads and checks the record at a log offset.
+ * @param offset Log offset.
+ * @param record Receives the record.
+ * @return true if a valid record was read.
+ */
+bool LicenseRegistry::readRecord(std::uint64_t offset, Record &record) const
+{
+    unsigned char header[RecordHeaderSize];
+    if (!m_log->readAt(offset, header, sizeof(header)))
+        return false;
+    std::uint32_t length = static_cast<std::uint32_t>(getLittleEndian(header, 4));
+    std::uint32_t crc = static_cast<std::uint32_t>(getLittleEndian(header + 4, 4));
+    if (length < RecordFixedSize)
+        return false;
+
+    std::vector<unsigned char> payload(length);
+    if (!m_log->readAt(offset + RecordHeaderSize, payload.data(), length) ||
+        crc32(payload.data(), length) != crc || !parsePayload(payload.data(), length, record))
+        return false;
+    record.offset = offset;
+    return true;
+}
+
+/**
+ * @brief Looks up the latest license issued for a hardware ID.
+ * @param hardwareId Hardware ID to look up.
+ * @param record Receives the record.
+ * @return true if the hardware ID has been licensed.
+ */
+bool LicenseRegistry::find(const std::string &hardwareId, Record &record) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_dataMutex);
+    std::uint64_t offset = 0;
+    std::uint64_t slot = 0;
+    return m_index && lookupOffset(hardwareId, offset, slot) && readRecord(offset, record);
+}
+
+/**
+ * @brief Visits every license issued for a hardware ID, newest first.
+ * @param hardwareId Hardware ID to look up.
+ * @param visit Called for each record.
+ * @return false if a record could not be read, true otherwise.
+ */
+bool LicenseRegistry::history(const std::string &hardwareId, const Visitor &visit) const
+{
+    Record record;
+    if (!find(hardwareId, record))
+        return true;
+
+    std::shared_lock<std::shared_mutex> lock(m_dataMutex);
+    for (;;) {
+        if (!visit(record) || record.previous == 0)
+            return true;
+        if (!readRecord(record.previous - 1, record))
+            return false;
+    }
+}
+
+/**
+ * @brief Visits every license issued in a time range, oldest first.
+ *
+ * The starting record is found by binary search on the timeline; records
+ * are then read sequentially from the log.
+ *
+ * @param from Start of the range (inclusive), milliseconds since the epoch.
+ * @param to End of the range (inclusive), milliseconds since the epoch.
+ * @param visit Called for each record.
+ * @return false if a record could not be read, true otherwise.
+ */
+bool LicenseRegistry::scan(std::int64_t from, std::int64_t to, const Visitor &visit) const
+{
+    std::vector<std::uint64_t> offsets;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_dataMutex);
+        if (!m_timelineLoaded && (!m_log || !loadTimeline()))
+            return false;
+        auto it = std::lower_bound(m_timeline.begin(), m_timeline.end(), from,
+                                   [](const std::pair<std::int64_t, std::uint64_t> &entry, std::int64_t time) {
+                                       return entry.first < time;
+                                   });
+        for (; it != m_timeline.end() && it->first <= to; ++it)
+            offsets.push_back(it->second);
+    }
+
+    // Committed records never change, so they can be read without holding the lock
+    Record record;
+    for (std::uint64_t offset : offsets) {
+        if (!readRecord(offset, record))
+            return false;
+        if (!visit(record))
+            break;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the number of durable records.
+ * @return Record count.
+ */
+std::size_t LicenseRegistry::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_dataMutex);
+    return static_cast<std::size_t>(m_recordCount);
+}
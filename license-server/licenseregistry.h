@@ -0,0 +1,286 @@
+#ifndef LICENSEREGISTRY_H
+#define LICENSEREGISTRY_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The LicenseRegistry class
+ *
+ * Persistent record of every issued license, kept in a directory with two files:
+ *
+ * - `registry.log`: append-only log of issuance records (issue time, hardware
+ *   ID, algorithm, key ID and the license itself), each protected by a CRC32.
+ *   A torn record at the end of the log (crash during a write) is discarded
+ *   when the log is replayed; a damaged record followed by further data is
+ *   corruption, and open() fails rather than dropping the records after it.
+ * - `registry.idx`: open-addressing hash table mapping each hardware ID to the
+ *   log offset of its latest record, so lookups cost O(1) reads. The index is
+ *   derived data: it is rebuilt from the log if it is missing, stale or was not
+ *   closed cleanly. Its header also keeps the record count and the newest issue
+ *   time, so opening a cleanly closed registry does not read the log at all.
+ *
+ * Records of the same hardware ID are chained, so the full issuance history
+ * of a machine can be walked without scanning. Issue times never decrease
+ * along the log, which allows range scans by issue date through an in-memory
+ * timeline of (time, offset) pairs; it is built from the log by the first
+ * scan() unless a replay at open() already produced it.
+ *
+ * Appends use group commit: a single writer thread takes every record queued
+ * while the previous commit was in progress, writes them with one write and
+ * one fsync, and then wakes all waiting callers. The registry is thread-safe.
+ */
+class LicenseRegistry
+{
+public:
+    /**
+     * @brief One issuance record.
+     */
+    struct Record
+    {
+        std::uint64_t offset = 0;   ///< Position of the record in the log
+        std::uint64_t previous = 0; ///< Offset + 1 of the previous record for the same hardware ID (0 = none)
+        std::int64_t issuedAt = 0;  ///< Issue time in milliseconds since the Unix epoch
+        std::string hardwareId;     ///< Licensed hardware ID
+        std::string algorithm;      ///< Signature algorithm
+        std::string keyId;          ///< Signing key identifier (LicenseSigner::keyId())
+        std::string license;        ///< License file contents
+    };
+
+    /**
+     * @brief Tuning knobs for the registry.
+     */
+    struct Options
+    {
+        std::size_t maxBatch = 4096; ///< Maximum records per group commit
+        bool sync = true;            ///< fsync the log after every group commit
+    };
+
+    /**
+     * @brief Called for each record of a scan; return false to stop.
+     */
+    using Visitor = std::function<bool(const Record &record)>;
+
+    LicenseRegistry();
+    ~LicenseRegistry();
+
+    LicenseRegistry(const LicenseRegistry &) = delete;
+    LicenseRegistry &operator=(const LicenseRegistry &) = delete;
+
+    /**
+     * @brief Opens (or creates) the registry in a directory.
+     *
+     * Recovers the log, rebuilds the index when needed and starts the writer thread.
+     *
+     * @param directory Directory holding `registry.log` and `registry.idx`.
+     * @param options Group commit settings.
+     * @return true if the registry is ready.
+     */
+    bool open(const std::string &directory, const Options &options);
+
+    /**
+     * @brief Opens (or creates) the registry with default options.
+     * @param directory Directory holding `registry.log` and `registry.idx`.
+     * @return true if the registry is ready.
+     */
+    bool open(const std::string &directory);
+
+    /**
+     * @brief Commits all queued records, stops the writer and closes the files.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the registry is open.
+     * @return true between a successful open() and close().
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Records an issued license.
+     * @param hardwareId Licensed hardware ID.
+     * @param algorithm Signature algorithm.
+     * @param keyId Signing key identifier.
+     * @param license License file contents.
+     * @param waitDurable Block until the record has been written and synced.
+     * @return false if the registry is closed or a write failed, true otherwise.
+     */
+    bool append(const std::string &hardwareId, const std::string &algorithm,
+                const std::string &keyId, const std::string &license, bool waitDurable = true);
+
+    /**
+     * @brief Waits until every record appended so far is durable.
+     * @return false if a write failed, true otherwise.
+     */
+    bool flush();
+
+    /**
+     * @brief Looks up the latest license issued for a hardware ID.
+     * @param hardwareId Hardware ID to look up.
+     * @param record Receives the record.
+     * @return true if the hardware ID has been licensed.
+     */
+    bool find(const std::string &hardwareId, Record &record) const;
+
+    /**
+     * @brief Visits every license issued for a hardware ID, newest first.
+     * @param hardwareId Hardware ID to look up.
+     * @param visit Called for each record.
+     * @return false if a record could not be read, true otherwise.
+     */
+    bool history(const std::string &hardwareId, const Visitor &visit) const;
+
+    /**
+     * @brief Visits every license issued in a time range, oldest first.
+     * @param from Start of the range (inclusive), milliseconds since the epoch.
+     * @param to End of the range (inclusive), milliseconds since the epoch.
+     * @param visit Called for each record.
+     * @return false if a record could not be read, true otherwise.
+     */
+    bool scan(std::int64_t from, std::int64_t to, const Visitor &visit) const;
+
+    /**
+     * @brief Returns the number of durable records.
+     * @return Record count.
+     */
+    std::size_t size() const;
+
+private:
+    class File;
+
+    /**
+     * @brief A record waiting for the writer thread.
+     */
+    struct Pending
+    {
+        std::uint64_t sequence = 0; ///< Append order
+        std::string hardwareId;     ///< Licensed hardware ID
+        std::string algorithm;      ///< Signature algorithm
+        std::string keyId;          ///< Signing key identifier
+        std::string license;        ///< License file contents
+    };
+
+    /**
+     * @brief Writer thread main loop.
+     */
+    void writerLoop();
+
+    /**
+     * @brief Writes, syncs and indexes one batch of records.
+     * @param batch Records to commit.
+     * @return true on success.
+     */
+    bool commit(std::vector<Pending> &batch);
+
+    /**
+     * @brief How a log replay ended.
+     */
+    enum class Replay
+    {
+        Complete, ///< Every byte belongs to a valid record
+        TornTail, ///< The first bad record runs to the end of the log
+        Corrupt   ///< A bad record is followed by more data, or the log could not be read
+    };
+
+    /**
+     * @brief Reads the log sequentially and visits every valid record.
+     * @param size Number of log bytes to read.
+     * @param visit Called for each record, oldest first.
+     * @param end Receives the offset after the last valid record.
+     * @return How the replay ended.
+     */
+    Replay replayLog(std::uint64_t size, const std::function<void(const Record &record)> &visit,
+                     std::uint64_t &end) const;
+
+    /**
+     * @brief Replays the log after an unclean shutdown, truncating a torn tail.
+     * @param ids Receives hardware ID to latest offset (index rebuild).
+     * @return true on success, false if the log is corrupt.
+     */
+    bool recoverLog(std::vector<std::pair<std::string, std::uint64_t>> &ids);
+
+    /**
+     * @brief Builds the timeline from the committed log (m_dataMutex held exclusively).
+     * @return true on success.
+     */
+    bool loadTimeline() const;
+
+    /**
+     * @brief Writes a fresh index for the given hardware IDs.
+     * @param ids Hardware ID and latest log offset of every licensed machine.
+     * @return true on success.
+     */
+    bool rebuildIndex(const std::vector<std::pair<std::string, std::uint64_t>> &ids);
+
+    /**
+     * @brief Writes the index header.
+     * @param clean true when the index is consistent with the log.
+     * @return true on success.
+     */
+    bool writeIndexHeader(bool clean);
+
+    /**
+     * @brief Finds the log offset of the latest record for a hardware ID.
+     * @param hardwareId Hardware ID to look up.
+     * @param offset Receives the log offset.
+     * @param slot Receives the index slot holding the entry, or the free slot to use.
+     * @return true if the hardware ID is indexed.
+     */
+    bool lookupOffset(const std::string &hardwareId, std::uint64_t &offset, std::uint64_t &slot) const;
+
+    /**
+     * @brief Points the index entry of a hardware ID at a new record.
+     * @param hardwareId Hardware ID.
+     * @param offset Log offset of its latest record.
+     * @return true on success.
+     */
+    bool indexRecord(const std::string &hardwareId, std::uint64_t offset);
+
+    /**
+     * @brief Doubles the index capacity and rehashes all entries.
+     * @return true on success.
+     */
+    bool growIndex();
+
+    /**
+     * @brief Reads and checks the record at a log offset.
+     * @param offset Log offset.
+     * @param record Receives the record.
+     * @return true if a valid record was read.
+     */
+    bool readRecord(std::uint64_t offset, Record &record) const;
+
+    Options m_options;                  ///< Active options
+    std::unique_ptr<File> m_log;        ///< registry.log
+    std::unique_ptr<File> m_index;      ///< registry.idx
+
+    mutable std::shared_mutex m_dataMutex; ///< Guards the committed state below
+    std::uint64_t m_logSize;            ///< Committed log length
+    std::uint64_t m_indexCapacity;      ///< Number of index slots
+    std::uint64_t m_indexCount;         ///< Used index slots
+    std::int64_t m_lastIssuedAt;        ///< Issue time of the newest record
+    std::uint64_t m_recordCount;        ///< Committed records
+    mutable bool m_timelineLoaded;      ///< m_timeline covers the whole committed log
+    mutable std::vector<std::pair<std::int64_t, std::uint64_t>> m_timeline; ///< (issuedAt, offset) in log order
+
+    std::mutex m_queueMutex;               ///< Guards the writer queue below
+    std::condition_variable m_queueReady;  ///< Signals the writer
+    std::condition_variable m_committed;   ///< Signals waiting appenders
+    std::vector<Pending> m_queue;          ///< Records waiting for the writer
+    std::uint64_t m_enqueued;              ///< Sequence of the last queued record
+    std::uint64_t m_durable;               ///< Sequence of the last committed record
+    bool m_failed;                         ///< A write failed; the registry rejects further appends
+    bool m_stopping;                       ///< close() was called
+    std::thread m_writer;                  ///< Group commit thread
+};
+
+#endif // LICENSEREGISTRY_H
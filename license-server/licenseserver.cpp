@@ -0,0 +1,536 @@
+#include "licenseserver.h"
+#include "revocationpublisher.h"
+#include <revocationlist.h>
+
+#include <QCryptographicHash>
+#include <QMetaObject>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <json.hpp>
+#include <openssl/crypto.h>
+
+using json = nlohmann::json;
+
+/**
+ * @brief An I/O thread with its event loop context, signing key and metrics.
+ */
+struct LicenseServer::Worker
+{
+    QThread thread;           ///< Thread running the event loop
+    QObject *context = nullptr; ///< Lives in @c thread; parent of its sockets
+    LicenseSigner signer;     ///< Private copy of the signing key
+    ServerMetrics::ThreadCounters *metrics = nullptr; ///< Counters owned by this thread
+};
+
+/**
+ * @brief Returns the reason phrase for a status code.
+ * @param status HTTP status code.
+ * @return Reason phrase.
+ */
+static const char *statusText(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 501: return "Not Implemented";
+    default: return "Internal Server Error";
+    }
+}
+
+/**
+ * @brief Builds a JSON error response.
+ * @param status HTTP status code.
+ * @param message Error description.
+ * @return Response with body `{"error": message}`.
+ */
+static LicenseServer::Response errorResponse(int status, const std::string &message)
+{
+    LicenseServer::Response response;
+    response.status = status;
+    response.contentType = "application/json";
+    response.body = QByteArray::fromStdString(json{{"error", message}}.dump());
+    return response;
+}
+
+/**
+ * @brief Writes a response to a connection.
+ * @param socket Client connection.
+ * @param response Response to send.
+ * @param keepAlive false to close the connection once the response is sent.
+ */
+static void sendResponse(QTcpSocket &socket, const LicenseServer::Response &response, bool keepAlive)
+{
+    QByteArray out;
+    out.reserve(128 + response.body.size());
+    out += "HTTP/1.1 ";
+    out += QByteArray::number(response.status);
+    out += ' ';
+    out += statusText(response.status);
+    out += "\r\nContent-Type: ";
+    out += response.contentType;
+    out += "\r\nContent-Length: ";
+    out += QByteArray::number(response.body.size());
+    if (response.status == 401)
+        out += "\r\nWWW-Authenticate: Bearer";
+    out += keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+    out += response.body;
+    socket.write(out);
+    if (!keepAlive)
+        socket.disconnectFromHost();
+}
+
+LicenseServer::LicenseServer() : m_nextWorker(0) {}
+
+LicenseServer::~LicenseServer()
+{
+    stop();
+}
+
+/**
+ * @brief Loads the signing key, starts the I/O threads and begins listening.
+ * @param privateKeyPath Path to the private key file (`private_key.pem`).
+ * @param options Listen address, port and thread count.
+ * @return true if the service is listening, false otherwise.
+ */
+bool LicenseServer::start(const std::string &privateKeyPath, const Options &options)
+{
+    if (options.authTokens.empty()) {
+        std::cerr << "❌ No API tokens configured; the server does not sign for anonymous clients (--auth-tokens).\n";
+        return false;
+    }
+    if (!m_signer.loadPrivateKey(privateKeyPath)) {
+        return false;
+    }
+    m_options = options;
+    m_tokenHashes.clear();
+    for (const std::string &token : options.authTokens)
+        m_tokenHashes.push_back(QCryptographicHash::hash(QByteArray::fromStdString(token), QCryptographicHash::Sha256));
+    m_cache = std::make_unique<LicenseCache>(options.cacheCapacity, options.cacheDirectory);
+    if (!options.registryDirectory.empty()) {
+        m_registry = std::make_unique<LicenseRegistry>();
+        if (!m_registry->open(options.registryDirectory)) {
+            m_registry.reset();
+            return false;
+        }
+    }
+
+    // Requests are signed on their I/O thread, which blocks while the HSM signs; there is no
+    // separate signing pool, so an HSM key gets more I/O threads than cores to keep the device busy
+    unsigned threadCount = options.threadCount;
+    if (threadCount == 0)
+        threadCount = static_cast<unsigned>(std::max(1, QThread::idealThreadCount()));
+    if (options.threadCount == 0 && m_signer.isHardwareBacked())
+        threadCount = std::max(threadCount, LicenseSigner::DefaultHardwareSessions);
+
+    m_metrics = std::make_unique<ServerMetrics>(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        auto worker = std::make_unique<Worker>();
+        if (!worker->signer.copyKeyFrom(m_signer)) {
+            stop();
+            return false;
+        }
+        worker->metrics = &m_metrics->thread(i);
+        worker->context = new QObject;
+        worker->context->moveToThread(&worker->thread);
+        QObject::connect(&worker->thread, &QThread::finished, worker->context, &QObject::deleteLater);
+        worker->thread.start();
+        m_workers.push_back(std::move(worker));
+    }
+
+    if (!listen(options.address, options.port)) {
+        std::cerr << "❌ Could not listen on port " << options.port << ": " << errorString().toStdString() << "\n";
+        stop();
+        return false;
+    }
+
+    std::cout << "✅ License server listening on " << serverAddress().toString().toStdString() << ":" << serverPort()
+              << " with " << threadCount << " thread(s), " << m_signer.algorithm() << " key\n";
+    return true;
+}
+
+/**
+ * @brief Stops listening, closes all connections and joins the I/O threads.
+ *
+ * Deleting a worker's context on its own thread also deletes the sockets it owns.
+ */
+void LicenseServer::stop()
+{
+    close();
+    for (auto &worker : m_workers) {
+        worker->thread.quit();
+        worker->thread.wait();
+    }
+    m_workers.clear();
+    m_registry.reset();
+}
+
+/**
+ * @brief Reads bearer tokens from a file.
+ * @param path Token file: one token per line; blank lines and lines starting with '#' are skipped.
+ * @param tokens Receives the tokens.
+ * @return true if the file was read and holds at least one token.
+ */
+bool LicenseServer::readTokenFile(const std::string &path, std::vector<std::string> &tokens)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "❌ " << path << " not found.\n";
+        return false;
+    }
+    tokens.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (!line.empty() && line[0] != '#')
+            tokens.push_back(line);
+    }
+    if (tokens.empty()) {
+        std::cerr << "❌ " << path << " contains no tokens.\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks a bearer token against the configured tokens.
+ *
+ * Both sides are hashed first, so the comparison time does not depend on
+ * how much of a guessed token is correct.
+ *
+ * @param authorization Value of the `Authorization` header.
+ * @return true if it is `Bearer <token>` with an accepted token.
+ */
+bool LicenseServer::isAuthorized(const QByteArray &authorization) const
+{
+    static const QByteArray scheme = "bearer ";
+    if (authorization.size() <= scheme.size() || authorization.left(scheme.size()).toLower() != scheme)
+        return false;
+    QByteArray hash = QCryptographicHash::hash(authorization.mid(scheme.size()).trimmed(), QCryptographicHash::Sha256);
+    bool match = false;
+    for (const QByteArray &accepted : m_tokenHashes)
+        match |= CRYPTO_memcmp(accepted.constData(), hash.constData(), static_cast<std::size_t>(hash.size())) == 0;
+    return match;
+}
+
+/**
+ * @brief Hands an accepted connection to the next I/O thread.
+ * @param socketDescriptor Native descriptor of the accepted socket.
+ */
+void LicenseServer::incomingConnection(qintptr socketDescriptor)
+{
+    Worker &worker = *m_workers[m_nextWorker++ % m_workers.size()];
+    worker.metrics->queueDepth.fetch_add(1, std::memory_order_relaxed);
+    QMetaObject::invokeMethod(worker.context, [this, socketDescriptor, &worker] {
+        serveConnection(socketDescriptor, worker);
+    }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief Sets up a connection on its I/O thread.
+ *
+ * The socket, its receive buffer and its idle timer live on the worker's
+ * thread; all reads are driven by that thread's event loop.
+ *
+ * @param socketDescriptor Native descriptor of the accepted socket.
+ * @param worker I/O thread that owns the connection.
+ */
+void LicenseServer::serveConnection(qintptr socketDescriptor, Worker &worker)
+{
+    worker.metrics->queueDepth.fetch_sub(1, std::memory_order_relaxed);
+    QTcpSocket *socket = new QTcpSocket(worker.context);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        return;
+    }
+
+    auto buffer = std::make_shared<QByteArray>();
+    QTimer *idleTimer = new QTimer(socket);
+    idleTimer->setSingleShot(true);
+    idleTimer->setInterval(m_options.idleTimeoutMs);
+
+    QObject::connect(idleTimer, &QTimer::timeout, socket, [socket] { socket->disconnectFromHost(); });
+    QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket, buffer, idleTimer, &worker] {
+        idleTimer->start();
+        buffer->append(socket->readAll());
+        processRequests(*socket, *buffer, worker);
+    });
+    idleTimer->start();
+}
+
+/**
+ * @brief Answers every complete request buffered for a connection.
+ *
+ * Requests are parsed incrementally: incomplete headers or bodies stay in
+ * @p buffer until more data arrives. Only `Content-Length` bodies are
+ * supported; malformed or oversized requests are answered and the connection
+ * is closed.
+ *
+ * @param socket Client connection.
+ * @param buffer Bytes received but not yet consumed.
+ * @param worker I/O thread that owns the connection.
+ */
+void LicenseServer::processRequests(QTcpSocket &socket, QByteArray &buffer, Worker &worker) const
+{
+    while (socket.state() == QAbstractSocket::ConnectedState && !buffer.isEmpty()) {
+        int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0 || headerEnd > MaxHeaderSize) {
+            if (headerEnd > MaxHeaderSize || buffer.size() > MaxHeaderSize)
+                sendResponse(socket, errorResponse(431, "request header too large"), false);
+            return;
+        }
+
+        QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+        QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() != 3 || !requestLine[2].startsWith("HTTP/1.")) {
+            sendResponse(socket, errorResponse(400, "malformed request line"), false);
+            return;
+        }
+
+        bool keepAlive = requestLine[2] == "HTTP/1.1";
+        qint64 contentLength = 0;
+        bool lengthOk = true;
+        QByteArray authorization;
+        for (int i = 1; i < lines.size(); ++i) {
+            int colon = lines[i].indexOf(':');
+            if (colon <= 0)
+                continue;
+            QByteArray name = lines[i].left(colon).trimmed().toLower();
+            QByteArray value = lines[i].mid(colon + 1).trimmed();
+            if (name == "authorization") {
+                authorization = value; // Tokens are case-sensitive
+                continue;
+            }
+            value = value.toLower();
+            if (name == "content-length") {
+                contentLength = value.toLongLong(&lengthOk);
+            } else if (name == "connection") {
+                keepAlive = value == "close" ? false : (value == "keep-alive" ? true : keepAlive);
+            } else if (name == "transfer-encoding") {
+                sendResponse(socket, errorResponse(501, "chunked requests are not supported"), false);
+                return;
+            }
+        }
+        if (!lengthOk || contentLength < 0) {
+            sendResponse(socket, errorResponse(400, "invalid Content-Length"), false);
+            return;
+        }
+        if (contentLength > MaxBodySize) {
+            sendResponse(socket, errorResponse(413, "request body too large"), false);
+            return;
+        }
+
+        int requestSize = headerEnd + 4 + static_cast<int>(contentLength);
+        if (buffer.size() < requestSize)
+            return; // Wait for the rest of the body
+
+        QByteArray body = buffer.mid(headerEnd + 4, static_cast<int>(contentLength));
+        buffer.remove(0, requestSize);
+        sendResponse(socket, handleRequest(requestLine[0], requestLine[1], authorization, body, worker), keepAlive);
+    }
+}
+
+/**
+ * @brief Builds the claims for a license issued now.
+ *
+ * The expiry is rounded up to the next UTC midnight, so repeated requests on
+ * the same day produce the same claims and are served from the cache.
+ *
+ * @return Expiry and features from the options.
+ */
+LicenseClaims LicenseServer::issueClaims() const
+{
+    static constexpr std::int64_t Day = 24 * 60 * 60;
+
+    LicenseClaims claims;
+    claims.features = m_options.features;
+    if (m_options.validitySeconds > 0) {
+        std::int64_t expiresAt = static_cast<std::int64_t>(std::time(nullptr)) + m_options.validitySeconds;
+        claims.expiresAt = (expiresAt + Day - 1) / Day * Day;
+    }
+    return claims;
+}
+
+/**
+ * @brief Serves the revocation list or a delta.
+ * @param query Request query; `since=<sequence>` asks for an update.
+ * @return Response to send.
+ */
+LicenseServer::Response LicenseServer::revocationResponse(const QByteArray &query) const
+{
+    if (m_options.revocationList.empty())
+        return errorResponse(404, "revocation list not configured");
+
+    std::string list;
+    RevocationList::View view;
+    if (!RevocationPublisher::readFile(m_options.revocationList, list) ||
+        !RevocationList::parse(list.data(), list.size(), view))
+        return errorResponse(500, "revocation list unavailable");
+
+    Response response;
+    response.contentType = "application/octet-stream";
+    for (const QByteArray &parameter : query.split('&')) {
+        if (!parameter.startsWith("since="))
+            continue;
+        bool ok = false;
+        std::uint64_t since = parameter.mid(6).toULongLong(&ok);
+        if (ok && since == view.sequence) {
+            response.status = 204;
+            return response;
+        }
+        std::string delta;
+        if (ok && RevocationPublisher::readFile(RevocationPublisher::deltaPath(m_options.revocationList, since), delta)) {
+            response.body = QByteArray(delta.data(), static_cast<int>(delta.size()));
+            return response;
+        }
+    }
+
+    response.body = QByteArray(list.data(), static_cast<int>(list.size()));
+    return response;
+}
+
+/**
+ * @brief Routes a request and builds its response.
+ *
+ * License requests are timed per stage (parse, sign, encode, write) on the
+ * calling worker's counters; cache hits only record the parse stage.
+ *
+ * @param method HTTP method.
+ * @param target Request target (path and optional query).
+ * @param authorization Value of the `Authorization` header, or empty.
+ * @param body Request body.
+ * @param worker Calling I/O thread (signer and metrics).
+ * @return Response to send.
+ */
+LicenseServer::Response LicenseServer::handleRequest(const QByteArray &method, const QByteArray &target,
+                                                     const QByteArray &authorization, const QByteArray &body,
+                                                     Worker &worker) const
+{
+    int queryStart = target.indexOf('?');
+    QByteArray path = queryStart < 0 ? target : target.left(queryStart);
+    QByteArray query = queryStart < 0 ? QByteArray() : target.mid(queryStart + 1);
+
+    if (path == "/health") {
+        if (method != "GET")
+            return errorResponse(405, "use GET");
+        Response response;
+        response.contentType = "text/plain";
+        response.body = "ok\n";
+        return response;
+    }
+
+    if (path == "/metrics") {
+        if (method != "GET")
+            return errorResponse(405, "use GET");
+        if (!isAuthorized(authorization))
+            return errorResponse(401, "missing or invalid bearer token");
+        Response response;
+        response.contentType = "text/plain; version=0.0.4";
+        response.body = QByteArray::fromStdString(m_metrics->render());
+        return response;
+    }
+
+    if (path == "/v1/revocations") {
+        if (method != "GET")
+            return errorResponse(405, "use GET");
+        return revocationResponse(query);
+    }
+
+    if (path != "/v1/licenses")
+        return errorResponse(404, "not found");
+    if (method != "POST")
+        return errorResponse(405, "use POST");
+    if (!isAuthorized(authorization))
+        return errorResponse(401, "missing or invalid bearer token");
+
+    LicenseSigner &signer = worker.signer;
+    ServerMetrics::ThreadCounters &metrics = *worker.metrics;
+    ServerMetrics::Timer parseTimer(metrics, ServerMetrics::Parse);
+    LicenseFormat format = m_options.format;
+    for (const QByteArray &parameter : query.split('&')) {
+        if (parameter == "format=binary")
+            format = LicenseFormat::Binary;
+        else if (parameter == "format=json")
+            format = LicenseFormat::Json;
+    }
+
+    json request = json::parse(body.constData(), body.constData() + body.size(), nullptr, false);
+    if (request.is_discarded() || !request.is_object() || !request.contains("hardwareId") ||
+        !request["hardwareId"].is_string())
+        return errorResponse(400, "expected {\"hardwareId\": \"...\"}");
+
+    std::string hardwareId = LicenseGenerator::trimHardwareId(request["hardwareId"].get<std::string>());
+    if (!LicenseGenerator::isValidHardwareId(hardwareId))
+        return errorResponse(400, "invalid hardwareId");
+
+    LicenseClaims claims = issueClaims();
+    if (request.contains("components")) {
+        const json &components = request["components"];
+        if (!components.is_object())
+            return errorResponse(400, "components must be an object");
+        std::string list;
+        for (int i = 0; i < LicenseClaims::ComponentCount; ++i) {
+            const char *name = LicenseClaims::componentName(i);
+            if (!components.contains(name))
+                continue;
+            if (!components[name].is_string())
+                return errorResponse(400, "invalid components");
+            list += (list.empty() ? "" : ",") + std::string(name) + ":" + components[name].get<std::string>();
+        }
+        if (!LicenseClaims::parseComponentList(list, claims.components))
+            return errorResponse(400, "invalid components");
+        // An empty object means no components (exact-match license); a partial set is refused
+        if (claims.hasComponents() && !claims.hasAllComponents())
+            return errorResponse(400, "components must include mac, disk and cpu");
+    }
+    std::string key = LicenseCache::makeKey(hardwareId, signer.keyId(), format, claims);
+    parseTimer.stop();
+
+    std::string license;
+    bool cached = false;
+    bool signedLicense = false;
+    try {
+        signedLicense = m_cache->getOrCreate(key, [&](std::string &out) {
+            std::string signature;
+            ServerMetrics::Timer signTimer(metrics, ServerMetrics::Sign);
+            if (!signer.signRaw(LicenseClaims::signingPayload(hardwareId, claims), signature))
+                return false;
+            signTimer.stop();
+            ServerMetrics::ThreadCounters::increment(metrics.signatures);
+
+            ServerMetrics::Timer encodeTimer(metrics, ServerMetrics::Encode);
+            out = LicenseGenerator::buildLicense(hardwareId, signature, signer.algorithm(), format, claims, signer.kid());
+            encodeTimer.stop();
+
+            // Not handed out until it is durably recorded (group commit with concurrent requests)
+            if (!m_registry)
+                return true;
+            ServerMetrics::Timer writeTimer(metrics, ServerMetrics::Write);
+            return m_registry->append(hardwareId, signer.algorithm(), signer.keyId(), out);
+        }, license, &cached);
+    } catch (const std::exception &e) {
+        // Must not escape into the I/O thread's event loop
+        std::cerr << "❌ Issuing a license failed: " << e.what() << "\n";
+    }
+    ServerMetrics::ThreadCounters::increment(cached ? metrics.cacheHits : metrics.cacheMisses);
+    if (!signedLicense)
+        return errorResponse(500, "signing failed");
+
+    Response response;
+    response.contentType = format == LicenseFormat::Binary ? "application/octet-stream" : "application/json";
+    response.body = QByteArray(license.data(), static_cast<int>(license.size()));
+    return response;
+}
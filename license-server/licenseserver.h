@@ -0,0 +1,191 @@
+#ifndef LICENSESERVER_H
+#define LICENSESERVER_H
+
+#include "licensecache.h"
+#include "licensegenerator.h"
+#include "licenseregistry.h"
+#include "licensesigner.h"
+#include "servermetrics.h"
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QTcpServer>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class QTcpSocket;
+
+/**
+ * @brief The LicenseServer class
+ *
+ * Long-running HTTP/1.1 license issuance service. The private key is parsed
+ * once at start-up. Accepted connections are spread round-robin over a pool of
+ * I/O threads, each running its own event loop and owning a private copy of
+ * the signing key, so many branches can request licenses concurrently without
+ * paying process start-up or key parsing per request.
+ *
+ * Endpoints:
+ * - `POST /v1/licenses` with the body `{"hardwareId": "<fingerprint>"}` returns
+ *   the license file contents (JSON, or binary with `?format=binary`); an
+ *   optional `"components": {"mac": ..., "disk": ..., "cpu": ...}` object (all
+ *   three required) binds the per-component hashes into the license
+ * - `GET /v1/revocations` returns the signed revocation list; with
+ *   `?since=<sequence>` it returns the delta from that sequence when
+ *   available, or `204 No Content` if the client is up to date
+ * - `GET /health` returns `ok`
+ * - `GET /metrics` returns issuance metrics in the Prometheus text format
+ *   (see ServerMetrics)
+ *
+ * `POST /v1/licenses` and `GET /metrics` require an `Authorization: Bearer
+ * <token>` header with one of Options::authTokens and are answered with
+ * `401 Unauthorized` otherwise; the server does not start without tokens.
+ * `/health` and `/v1/revocations` stay public, the list is signed anyway.
+ * The default listen address is the loopback interface; listening on other
+ * interfaces is an explicit choice (`--listen`).
+ *
+ * Connections are kept alive between requests until the client closes them
+ * or they stay idle for Options::idleTimeoutMs. Issued licenses are kept in a
+ * LicenseCache, so a branch that asks again for the same fingerprint gets the
+ * stored license without a new signature. Every newly signed license is
+ * recorded in the LicenseRegistry before it is returned, if one is configured.
+ */
+class LicenseServer : public QTcpServer
+{
+public:
+    /// Largest accepted request header block in bytes.
+    static constexpr int MaxHeaderSize = 8192;
+
+    /// Largest accepted request body in bytes.
+    static constexpr int MaxBodySize = 4096;
+
+    /**
+     * @brief Listen address and tuning knobs for the service.
+     */
+    struct Options
+    {
+        QHostAddress address = QHostAddress::LocalHost; ///< Listen address
+        quint16 port = 8080;                        ///< Listen port
+        unsigned threadCount = 0;                   ///< I/O threads, each signing its own requests (0 = one per core, at least LicenseSigner::DefaultHardwareSessions for an HSM key)
+        int idleTimeoutMs = 30000;                  ///< Keep-alive idle timeout
+        LicenseFormat format = LicenseFormat::Json; ///< Encoding when the request does not choose one
+        std::size_t cacheCapacity = 10000;          ///< Licenses kept in memory (0 = no memory cache)
+        std::string cacheDirectory;                 ///< Persistent license cache; empty for memory only
+        std::string registryDirectory;              ///< Record issued licenses in this LicenseRegistry; empty to skip
+        std::string revocationList;                 ///< Revocation list served to clients; empty to disable
+        std::int64_t validitySeconds = 0;           ///< Lifetime of issued licenses (0 = never expire)
+        std::vector<std::string> features;          ///< Features signed into every issued license
+        std::vector<std::string> authTokens;        ///< Bearer tokens accepted for issuance and metrics (required)
+    };
+
+    /**
+     * @brief An HTTP response produced for one request.
+     */
+    struct Response
+    {
+        int status = 200;        ///< HTTP status code
+        QByteArray contentType;  ///< Content-Type header value
+        QByteArray body;         ///< Response body
+    };
+
+    LicenseServer();
+    ~LicenseServer() override;
+
+    LicenseServer(const LicenseServer &) = delete;
+    LicenseServer &operator=(const LicenseServer &) = delete;
+
+    /**
+     * @brief Loads the signing key, starts the I/O threads and begins listening.
+     * @param privateKeyPath Path to the private key file (`private_key.pem`).
+     * @param options Listen address, port and thread count.
+     * @return true if the service is listening, false otherwise.
+     */
+    bool start(const std::string &privateKeyPath, const Options &options);
+
+    /**
+     * @brief Stops listening, closes all connections and joins the I/O threads.
+     */
+    void stop();
+
+    /**
+     * @brief Reads bearer tokens from a file.
+     * @param path Token file: one token per line; blank lines and lines starting with '#' are skipped.
+     * @param tokens Receives the tokens.
+     * @return true if the file was read and holds at least one token.
+     */
+    static bool readTokenFile(const std::string &path, std::vector<std::string> &tokens);
+
+protected:
+    /**
+     * @brief Hands an accepted connection to the next I/O thread.
+     * @param socketDescriptor Native descriptor of the accepted socket.
+     */
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    struct Worker;
+
+    /**
+     * @brief Sets up a connection on its I/O thread.
+     * @param socketDescriptor Native descriptor of the accepted socket.
+     * @param worker I/O thread that owns the connection.
+     */
+    void serveConnection(qintptr socketDescriptor, Worker &worker);
+
+    /**
+     * @brief Answers every complete request buffered for a connection.
+     * @param socket Client connection.
+     * @param buffer Bytes received but not yet consumed.
+     * @param worker I/O thread that owns the connection.
+     */
+    void processRequests(QTcpSocket &socket, QByteArray &buffer, Worker &worker) const;
+
+    /**
+     * @brief Routes a request and builds its response.
+     * @param method HTTP method.
+     * @param target Request target (path and optional query).
+     * @param authorization Value of the `Authorization` header, or empty.
+     * @param body Request body.
+     * @param worker Calling I/O thread (signer and metrics).
+     * @return Response to send.
+     */
+    Response handleRequest(const QByteArray &method, const QByteArray &target, const QByteArray &authorization,
+                           const QByteArray &body, Worker &worker) const;
+
+    /**
+     * @brief Checks a bearer token against the configured tokens.
+     * @param authorization Value of the `Authorization` header.
+     * @return true if it is `Bearer <token>` with an accepted token.
+     */
+    bool isAuthorized(const QByteArray &authorization) const;
+
+    /**
+     * @brief Serves the revocation list or a delta.
+     * @param query Request query; `since=<sequence>` asks for an update.
+     * @return Response to send.
+     */
+    Response revocationResponse(const QByteArray &query) const;
+
+    /**
+     * @brief Builds the claims for a license issued now.
+     *
+     * The expiry is rounded up to the next UTC midnight, so repeated requests
+     * on the same day produce the same claims and are served from the cache.
+     *
+     * @return Expiry and features from the options.
+     */
+    LicenseClaims issueClaims() const;
+
+    Options m_options;                              ///< Active options
+    std::vector<QByteArray> m_tokenHashes;          ///< SHA-256 of every accepted bearer token
+    LicenseSigner m_signer;                         ///< Master key, copied into every worker
+    std::unique_ptr<LicenseCache> m_cache;          ///< Issued licenses, shared by all workers
+    std::unique_ptr<LicenseRegistry> m_registry;    ///< Record of issued licenses, or null
+    std::unique_ptr<ServerMetrics> m_metrics;       ///< Counters served by `GET /metrics`
+    std::vector<std::unique_ptr<Worker>> m_workers; ///< I/O threads
+    unsigned m_nextWorker;                          ///< Round-robin cursor (listener thread only)
+};
+
+#endif // LICENSESERVER_H
@@ -1,25 +1,344 @@
 #include "licensegenerator.h"
+#include "licensepipeline.h"
+#include "licenseregistry.h"
+#include "licenseserver.h"
+#include "licensesigner.h"
+#include "revocationpublisher.h"
+#include <QCoreApplication>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <fstream>
 #include <iostream>
+#include <vector>
+
+/**
+ * @brief Prints command line usage.
+ */
+static void printUsage()
+{
+    std::cerr << "Usage:\n"
+              << "  CryptoProject [--format json|binary]\n"
+              << "      Sign hardware_id.txt into license.lic\n"
+              << "  CryptoProject --batch <ids.txt|-> [--output-dir <dir>] [--key <private_key.pem>]\n"
+              << "                [--threads <n>] [--ordered] [--format json|binary] [--output <file|->]\n"
+              << "      Sign every hardware ID in the file (or stdin for '-') into <dir>/<id>.lic\n"
+              << "      using <n> signing threads (default: one per core); with --output, write\n"
+              << "      all licenses as NDJSON (one JSON license per line) to <file> or stdout\n"
+              << "  CryptoProject --serve [--listen <address>] [--port <port>] [--key <private_key.pem>]\n"
+              << "                --auth-tokens <file> [--threads <n>] [--format json|binary] [--cache-size <n>]\n"
+              << "                [--cache-dir <dir>]\n"
+              << "      Run the HTTP issuance service (POST /v1/licenses) on <n> I/O threads,\n"
+              << "      caching up to <n> issued licenses in memory and optionally in <dir>;\n"
+              << "      listens on 127.0.0.1 unless --listen is given, and only signs for clients\n"
+              << "      sending \"Authorization: Bearer <token>\" with a token from <file> (one per line)\n"
+              << "  CryptoProject --registry <dir> --lookup <hardwareId>\n"
+              << "      Print the latest license issued for a hardware ID\n"
+              << "  CryptoProject --registry <dir> --list-issued <from> <to>\n"
+              << "      List licenses issued between two Unix timestamps (seconds)\n"
+              << "  --registry <dir> with --batch or --serve records every issued license\n"
+              << "  CryptoProject --revocation-list <file> [--revoke <hardwareId>]... [--reinstate <hardwareId>]...\n"
+              << "                [--key <private_key.pem>]\n"
+              << "      Update the signed revocation list (and write a delta for clients)\n"
+              << "  --revocation-list <file> with --serve publishes it at GET /v1/revocations\n"
+              << "  --valid-days <n> and --features <a,b,...> sign an expiry and feature flags into\n"
+              << "      every license issued by the single, --batch and --serve modes\n"
+              << "  --key also accepts a key store URI (e.g. \"pkcs11:object=license-key\") to sign in an\n"
+              << "      HSM; --key-provider <name> loads the OpenSSL provider for it (e.g. pkcs11)\n";
+}
+
+/**
+ * @brief Runs the parallel batch pipeline and prints its throughput.
+ *
+ * With @p outputStream, all licenses are written as NDJSON to that file
+ * (through a 1 MiB buffer) or to stdout for '-'; the summary then goes to
+ * stderr so it does not mix with the licenses.
+ *
+ * @param input Stream of hardware IDs.
+ * @param privateKeyPath Path to the private key file.
+ * @param outputDir Directory that receives the generated license files.
+ * @param outputStream NDJSON output file, '-' for stdout, or empty for one file per license.
+ * @param options Pipeline options.
+ * @return int Application exit code (0 for success, 1 for error)
+ */
+static int runBatch(std::istream &input, const std::string &privateKeyPath, const std::string &outputDir,
+                    const std::string &outputStream, LicensePipeline::Options options)
+{
+    std::vector<char> buffer;
+    std::ofstream file;
+    if (outputStream == "-") {
+        options.stream = &std::cout;
+    } else if (!outputStream.empty()) {
+        buffer.resize(1 << 20);
+        file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.open(outputStream, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "❌ Could not write " << outputStream << ".\n";
+            return 1;
+        }
+        options.stream = &file;
+    }
+
+    LicensePipeline::Result result;
+    if (!LicensePipeline::run(input, privateKeyPath, outputDir, options, result)) {
+        return 1;
+    }
+    if (file.is_open()) {
+        // Closing can still fail (e.g. on network file systems); then nothing counts as written
+        file.close();
+        if (!file) {
+            std::cerr << "❌ Could not write " << outputStream << ".\n";
+            result.failed += result.generated;
+            result.generated = 0;
+        }
+    }
+
+    std::ostream &report = options.stream == &std::cout ? std::cerr : std::cout;
+    report << "✅ " << result.generated << " license(s) generated in "
+           << (outputStream.empty() ? outputDir : outputStream == "-" ? std::string("stdout") : outputStream);
+    if (result.failed > 0)
+        report << ", " << result.failed << " failed";
+    report << "\n"
+           << "⏱ " << result.seconds << " s on " << result.threadCount << " thread(s), "
+           << result.licensesPerSecond() << " licenses/sec\n";
+    return result.failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Prints the latest license issued for a hardware ID.
+ * @param registryDir Registry directory.
+ * @param hardwareId Hardware ID to look up.
+ * @return int Application exit code (0 if found, 1 otherwise)
+ */
+static int lookupLicense(const std::string &registryDir, const std::string &hardwareId)
+{
+    LicenseRegistry registry;
+    LicenseRegistry::Record record;
+    if (!registry.open(registryDir)) {
+        return 1;
+    }
+    if (!registry.find(hardwareId, record)) {
+        std::cerr << "❌ No license issued for " << hardwareId << ".\n";
+        return 1;
+    }
+    std::cout << record.license;
+    return 0;
+}
+
+/**
+ * @brief Lists the licenses issued in a time range as tab-separated lines.
+ * @param registryDir Registry directory.
+ * @param from Start of the range, Unix seconds.
+ * @param to End of the range, Unix seconds.
+ * @return int Application exit code (0 for success, 1 for error)
+ */
+static int listIssued(const std::string &registryDir, std::int64_t from, std::int64_t to)
+{
+    LicenseRegistry registry;
+    if (!registry.open(registryDir)) {
+        return 1;
+    }
+    bool ok = registry.scan(from * 1000, to * 1000 + 999, [](const LicenseRegistry::Record &record) {
+        std::time_t seconds = static_cast<std::time_t>(record.issuedAt / 1000);
+        char issued[32] = "";
+        if (const std::tm *utc = std::gmtime(&seconds))
+            std::strftime(issued, sizeof(issued), "%Y-%m-%dT%H:%M:%SZ", utc);
+        std::cout << issued << '\t' << record.hardwareId << '\t' << record.algorithm << '\t' << record.keyId << '\n';
+        return true;
+    });
+    return ok ? 0 : 1;
+}
 
 /**
  * @brief Application entry point for license generation.
  *
- * This program:
+ * Without arguments this program:
  * 1. Reads the hardware ID from `hardware_id.txt`
  * 2. Generates a license file (`license.lic`) by signing the hardware ID
- *    using a provided RSA private key (`private_key.pem`)
+ *    using a provided private key (`private_key.pem`; RSA, EC or Ed25519)
+ *
+ * With `--batch`, every line of the given file (or stdin) is signed with a
+ * private key that is loaded only once, and one license per hardware ID is
+ * written to the output directory (default: `licenses`). Signing is spread
+ * over `--threads` workers and the achieved licenses/sec is reported.
+ * `--format binary` writes the compact binary encoding instead of JSON.
+ * `--output <file|->` streams all licenses into one NDJSON file (or stdout)
+ * instead of one file per license; memory use stays flat for any batch size.
+ *
+ * `--revocation-list <file>` with `--revoke`/`--reinstate` maintains the
+ * signed revocation list that branch clients check at start-up.
+ *
+ * `--valid-days <n>` and `--features <a,b,...>` sign an expiry date and
+ * feature flags into the issued licenses (see LicenseClaims).
+ *
+ * `--registry <dir>` records every issued license in a LicenseRegistry, which
+ * can then be queried with `--lookup` and `--list-issued`.
+ *
+ * With `--serve`, the program runs as a long-lived HTTP issuance service
+ * (see LicenseServer) that keeps the key resident and signs licenses on
+ * request until it is terminated.
+ *
+ * `--key` accepts a key store URI instead of a PEM path, e.g. a PKCS#11 URI
+ * for a key held in an HSM; `--key-provider <name>` loads the OpenSSL
+ * provider that serves it (see LicenseSigner).
  *
  * Expected files in the same directory:
  * - hardware_id.txt : Contains the target machine's hardware fingerprint
- * - private_key.pem : RSA private key for signing
+ * - private_key.pem : RSA, EC or Ed25519 private key for signing
  *
  * Output:
  * - license.lic : Generated JSON license file containing hardware ID and signature
  *
+ * @param argc Argument count
+ * @param argv Argument values
  * @return int Application exit code (0 for success, 1 for error)
  */
-int main() {
+int main(int argc, char *argv[]) {
+    std::string batchInput;
+    std::string outputDir = "licenses";
+    std::string outputStream;
+    std::string privateKeyPath = "private_key.pem";
+    LicensePipeline::Options options;
+    bool serve = false;
+    std::string lookupId;
+    std::string revocationList;
+    std::vector<std::string> revoke;
+    std::vector<std::string> reinstate;
+    bool listRange = false;
+    std::int64_t listFrom = 0;
+    std::int64_t listTo = 0;
+    LicenseServer::Options serverOptions;
+    std::int64_t validDays = 0;
+    std::vector<std::string> features;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchInput = argv[++i];
+        } else if (std::strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputStream = argv[++i];
+        } else if (std::strcmp(argv[i], "--key") == 0 && i + 1 < argc) {
+            privateKeyPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--key-provider") == 0 && i + 1 < argc) {
+            if (!LicenseSigner::loadProvider(argv[++i])) {
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threadCount = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+        } else if (std::strcmp(argv[i], "--listen") == 0 && i + 1 < argc) {
+            if (!serverOptions.address.setAddress(QString::fromLocal8Bit(argv[++i]))) {
+                printUsage();
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--auth-tokens") == 0 && i + 1 < argc) {
+            if (!LicenseServer::readTokenFile(argv[++i], serverOptions.authTokens)) {
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            serverOptions.port = static_cast<quint16>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--registry") == 0 && i + 1 < argc) {
+            options.registryDirectory = argv[++i];
+            serverOptions.registryDirectory = options.registryDirectory;
+        } else if (std::strcmp(argv[i], "--revocation-list") == 0 && i + 1 < argc) {
+            revocationList = argv[++i];
+            serverOptions.revocationList = revocationList;
+        } else if (std::strcmp(argv[i], "--revoke") == 0 && i + 1 < argc) {
+            revoke.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--reinstate") == 0 && i + 1 < argc) {
+            reinstate.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--lookup") == 0 && i + 1 < argc) {
+            lookupId = argv[++i];
+        } else if (std::strcmp(argv[i], "--list-issued") == 0 && i + 2 < argc) {
+            listRange = true;
+            listFrom = std::strtoll(argv[++i], nullptr, 10);
+            listTo = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            serverOptions.cacheCapacity = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            serverOptions.cacheDirectory = argv[++i];
+        } else if (std::strcmp(argv[i], "--valid-days") == 0 && i + 1 < argc) {
+            validDays = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--features") == 0 && i + 1 < argc) {
+            features = LicenseClaims::parseFeatureList(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ordered") == 0) {
+            options.ordered = true;
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format == "json") {
+                options.format = LicenseFormat::Json;
+            } else if (format == "binary") {
+                options.format = LicenseFormat::Binary;
+            } else {
+                printUsage();
+                return 1;
+            }
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Claims signed into every license issued by this run
+    static constexpr std::int64_t Day = 24 * 60 * 60;
+    options.claims.features = features;
+    if (validDays > 0)
+        options.claims.expiresAt = static_cast<std::int64_t>(std::time(nullptr)) + validDays * Day;
+    serverOptions.validitySeconds = validDays > 0 ? validDays * Day : 0;
+    serverOptions.features = features;
+
+    // Revocation list maintenance
+    if (!revoke.empty() || !reinstate.empty()) {
+        LicenseSigner signer;
+        if (revocationList.empty()) {
+            printUsage();
+            return 1;
+        }
+        if (!signer.loadPrivateKey(privateKeyPath) ||
+            !RevocationPublisher::update(revocationList, revoke, reinstate, signer)) {
+            return 1;
+        }
+        return 0;
+    }
+
+    // Registry queries
+    if (!lookupId.empty() || listRange) {
+        if (options.registryDirectory.empty()) {
+            printUsage();
+            return 1;
+        }
+        return lookupId.empty() ? listIssued(options.registryDirectory, listFrom, listTo)
+                                : lookupLicense(options.registryDirectory, lookupId);
+    }
+
+    // Service mode: resident key, licenses issued over HTTP
+    if (serve) {
+        QCoreApplication app(argc, argv);
+        serverOptions.threadCount = options.threadCount;
+        serverOptions.format = options.format;
+        LicenseServer server;
+        if (!server.start(privateKeyPath, serverOptions)) {
+            return 1;
+        }
+        return app.exec();
+    }
+
+    // Batch mode: one key load, many licenses, signed in parallel
+    if (!batchInput.empty()) {
+        if (batchInput == "-") {
+            return runBatch(std::cin, privateKeyPath, outputDir, outputStream, options);
+        }
+        std::ifstream input(batchInput);
+        if (!input.is_open()) {
+            std::cerr << "❌ " << batchInput << " not found.\n";
+            return 1;
+        }
+        return runBatch(input, privateKeyPath, outputDir, outputStream, options);
+    }
+
     // Open hardware ID file
     std::ifstream file("hardware_id.txt");
     if (!file.is_open()) {
@@ -27,13 +346,15 @@ int main() {
         return 1;
     }
 
-    // Read hardware ID
-    std::string hardwareId;
-    std::getline(file, hardwareId);
+    // Read hardware ID (and component hashes, if the client wrote them)
+    std::string line;
+    std::getline(file, line);
     file.close();
+    LicenseClaims claims = options.claims;
+    std::string hardwareId = LicenseGenerator::parseRequestLine(line, claims.components);
 
     // Generate license
-    if (!LicenseGenerator::generateLicense(hardwareId, "private_key.pem", "license.lic")) {
+    if (!LicenseGenerator::generateLicense(hardwareId, privateKeyPath, "license.lic", options.format, claims)) {
         return 1;
     }
 
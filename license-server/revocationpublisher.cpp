@@ -0,0 +1,140 @@
+#include "revocationpublisher.h"
+#include "licensesigner.h"
+#include <revocationlist.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+/**
+ * @brief Writes a file atomically (temporary file and rename).
+ * @param path Destination path.
+ * @param data File contents.
+ * @return true on success.
+ */
+static bool writeFileAtomically(const std::string &path, const std::string &data)
+{
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            std::cerr << "❌ Could not write " << tempPath << ".\n";
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "❌ Could not replace " << path << ".\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Hashes and sorts a set of fingerprints.
+ * @param fingerprints Hardware fingerprints.
+ * @return Sorted, unique list entries.
+ */
+static std::vector<std::uint64_t> toEntries(const std::vector<std::string> &fingerprints)
+{
+    std::vector<std::uint64_t> entries;
+    entries.reserve(fingerprints.size());
+    for (const std::string &fingerprint : fingerprints)
+        entries.push_back(RevocationList::hashFingerprint(fingerprint));
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    return entries;
+}
+
+/**
+ * @brief Reads a file completely.
+ * @param path File path.
+ * @param data Receives the file contents.
+ * @return true if the file was read.
+ */
+bool RevocationPublisher::readFile(const std::string &path, std::string &data)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+        return false;
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/**
+ * @brief Returns the path of the delta that starts at a given sequence.
+ * @param listPath Path of the full list.
+ * @param baseSequence Sequence the delta applies to.
+ * @return Delta file path.
+ */
+std::string RevocationPublisher::deltaPath(const std::string &listPath, std::uint64_t baseSequence)
+{
+    return listPath + "." + std::to_string(baseSequence) + ".delta";
+}
+
+/**
+ * @brief Revokes and/or reinstates hardware fingerprints.
+ *
+ * The delta only records entries whose state actually changes, so it stays
+ * small no matter how large the list grows.
+ *
+ * @param listPath Path of the full list (created if missing).
+ * @param revoke Fingerprints to add to the list.
+ * @param reinstate Fingerprints to remove from the list.
+ * @param signer Signer holding the license signing key.
+ * @return true if the new list and delta were written.
+ */
+bool RevocationPublisher::update(const std::string &listPath, const std::vector<std::string> &revoke,
+                                 const std::vector<std::string> &reinstate, LicenseSigner &signer)
+{
+    std::vector<std::uint64_t> current;
+    std::uint64_t sequence = 0;
+    std::string existing;
+    if (readFile(listPath, existing)) {
+        RevocationList::View view;
+        if (!RevocationList::parse(existing.data(), existing.size(), view)) {
+            std::cerr << "❌ " << listPath << " is not a valid revocation list.\n";
+            return false;
+        }
+        current = RevocationList::entries(view);
+        sequence = view.sequence;
+    }
+
+    std::vector<std::uint64_t> toAdd = toEntries(revoke);
+    std::vector<std::uint64_t> toRemove = toEntries(reinstate);
+
+    // Effective changes: new revocations, and reinstatements of listed entries
+    std::vector<std::uint64_t> added;
+    std::set_difference(toAdd.begin(), toAdd.end(), current.begin(), current.end(), std::back_inserter(added));
+    std::vector<std::uint64_t> removed;
+    std::set_intersection(toRemove.begin(), toRemove.end(), current.begin(), current.end(), std::back_inserter(removed));
+
+    std::vector<std::uint64_t> kept;
+    std::set_difference(current.begin(), current.end(), removed.begin(), removed.end(), std::back_inserter(kept));
+    std::vector<std::uint64_t> entries;
+    std::set_union(kept.begin(), kept.end(), added.begin(), added.end(), std::back_inserter(entries));
+
+    std::string list = RevocationList::encodeBody(sequence + 1, entries);
+    std::string signature;
+    if (!signer.signRaw(RevocationList::signingPayload(list), signature)) {
+        return false;
+    }
+    RevocationList::appendSignature(list, signature);
+
+    // The delta goes out first so that no client sees the new list without a way to reach it
+    if (!existing.empty()) {
+        std::string delta = RevocationList::encodeDelta(sequence, sequence + 1, added, removed);
+        RevocationList::appendSignature(delta, signature);
+        if (!writeFileAtomically(deltaPath(listPath, sequence), delta))
+            return false;
+    }
+    if (!writeFileAtomically(listPath, list))
+        return false;
+
+    std::cout << "✅ Revocation list " << listPath << " updated to sequence " << (sequence + 1) << ": "
+              << entries.size() << " revoked (" << added.size() << " added, " << removed.size() << " removed)\n";
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef REVOCATIONPUBLISHER_H
+#define REVOCATIONPUBLISHER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class LicenseSigner;
+
+/**
+ * @brief The RevocationPublisher class
+ *
+ * Maintains the signed revocation list (see RevocationList) distributed to
+ * branch clients. Every update writes a new full list with the next sequence
+ * number and a delta `<list>.<previous sequence>.delta` that takes clients
+ * from the previous list to the new one.
+ */
+class RevocationPublisher
+{
+public:
+    /**
+     * @brief Revokes and/or reinstates hardware fingerprints.
+     * @param listPath Path of the full list (created if missing).
+     * @param revoke Fingerprints to add to the list.
+     * @param reinstate Fingerprints to remove from the list.
+     * @param signer Signer holding the license signing key.
+     * @return true if the new list and delta were written.
+     */
+    static bool update(const std::string &listPath, const std::vector<std::string> &revoke,
+                       const std::vector<std::string> &reinstate, LicenseSigner &signer);
+
+    /**
+     * @brief Returns the path of the delta that starts at a given sequence.
+     * @param listPath Path of the full list.
+     * @param baseSequence Sequence the delta applies to.
+     * @return Delta file path.
+     */
+    static std::string deltaPath(const std::string &listPath, std::uint64_t baseSequence);
+
+    /**
+     * @brief Reads a file completely.
+     * @param path File path.
+     * @param data Receives the file contents.
+     * @return true if the file was read.
+     */
+    static bool readFile(const std::string &path, std::string &data);
+};
+
+#endif // REVOCATIONPUBLISHER_H
@@ -0,0 +1,187 @@
+#include "servermetrics.h"
+
+#include <cstdio>
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "metrics counters must be lock-free");
+
+/**
+ * @brief Returns the label value of a stage.
+ * @param stage Issuance stage.
+ * @return "parse", "sign", "encode" or "write".
+ */
+static const char *stageName(int stage)
+{
+    static const char *const names[ServerMetrics::StageCount] = {"parse", "sign", "encode", "write"};
+    return names[stage];
+}
+
+/**
+ * @brief Formats a floating-point sample value.
+ * @param value Value to format.
+ * @return Shortest round-trippable text, e.g. "0.0025".
+ */
+static std::string number(double value)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    return text;
+}
+
+/**
+ * @brief Appends the HELP and TYPE lines of a metric.
+ * @param out Exposition text.
+ * @param name Metric name.
+ * @param type Prometheus metric type.
+ * @param help Description.
+ */
+static void appendHeader(std::string &out, const char *name, const char *type, const char *help)
+{
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+ServerMetrics::ThreadCounters::ThreadCounters()
+{
+    for (auto &stage : buckets) {
+        for (std::atomic<std::uint64_t> &bucket : stage)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<std::uint64_t> &duration : durationNs)
+        duration.store(0, std::memory_order_relaxed);
+    signatures.store(0, std::memory_order_relaxed);
+    cacheHits.store(0, std::memory_order_relaxed);
+    cacheMisses.store(0, std::memory_order_relaxed);
+    queueDepth.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Adds a latency sample.
+ * @param stage Stage that was measured.
+ * @param elapsedNs Duration in nanoseconds.
+ */
+void ServerMetrics::ThreadCounters::record(Stage stage, std::uint64_t elapsedNs)
+{
+    std::size_t bucket = 0;
+    while (bucket < BucketCount && elapsedNs > BucketBoundsNs[bucket])
+        ++bucket;
+    increment(buckets[stage][bucket]);
+    durationNs[stage].store(durationNs[stage].load(std::memory_order_relaxed) + elapsedNs, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Starts measuring.
+ * @param counters Counters of the calling worker.
+ * @param stage Stage being measured.
+ */
+ServerMetrics::Timer::Timer(ThreadCounters &counters, Stage stage)
+    : m_counters(counters), m_stage(stage), m_start(std::chrono::steady_clock::now()), m_running(true)
+{
+}
+
+ServerMetrics::Timer::~Timer()
+{
+    stop();
+}
+
+/**
+ * @brief Records the elapsed time; later calls do nothing.
+ */
+void ServerMetrics::Timer::stop()
+{
+    if (!m_running)
+        return;
+    m_running = false;
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+    m_counters.record(m_stage, static_cast<std::uint64_t>(elapsed.count()));
+}
+
+/**
+ * @brief Creates the counters for a fixed number of workers.
+ * @param threadCount Number of I/O worker threads.
+ */
+ServerMetrics::ServerMetrics(unsigned threadCount)
+    : m_threadCount(threadCount), m_threads(new ThreadCounters[threadCount]),
+      m_startTime(std::chrono::steady_clock::now())
+{
+}
+
+/**
+ * @brief Returns the counters of a worker.
+ * @param index Worker index (0 to threadCount - 1).
+ * @return Counters owned by that worker.
+ */
+ServerMetrics::ThreadCounters &ServerMetrics::thread(unsigned index)
+{
+    return m_threads[index];
+}
+
+/**
+ * @brief Renders all metrics in the Prometheus text format (version 0.0.4).
+ *
+ * Histograms and cache counters are summed over all workers; signatures and
+ * queue depth are reported per worker.
+ *
+ * @return Exposition text.
+ */
+std::string ServerMetrics::render() const
+{
+    std::string out;
+    out.reserve(8192);
+
+    appendHeader(out, "license_server_stage_duration_seconds", "histogram",
+                 "Time spent per license issuance stage.");
+    for (int stage = 0; stage < StageCount; ++stage) {
+        std::uint64_t cumulative = 0;
+        std::uint64_t durationNs = 0;
+        const std::string label = std::string("{stage=\"") + stageName(stage) + "\"";
+        for (std::size_t bucket = 0; bucket <= BucketCount; ++bucket) {
+            for (unsigned i = 0; i < m_threadCount; ++i)
+                cumulative += m_threads[i].buckets[stage][bucket].load(std::memory_order_relaxed);
+            out += "license_server_stage_duration_seconds_bucket" + label + ",le=\"";
+            out += bucket < BucketCount ? number(BucketBoundsNs[bucket] / 1e9) : std::string("+Inf");
+            out += "\"} " + std::to_string(cumulative) + '\n';
+        }
+        for (unsigned i = 0; i < m_threadCount; ++i)
+            durationNs += m_threads[i].durationNs[stage].load(std::memory_order_relaxed);
+        out += "license_server_stage_duration_seconds_sum" + label + "} " + number(durationNs / 1e9) + '\n';
+        out += "license_server_stage_duration_seconds_count" + label + "} " + std::to_string(cumulative) + '\n';
+    }
+
+    appendHeader(out, "license_server_signatures_total", "counter", "Licenses signed per worker thread.");
+    for (unsigned i = 0; i < m_threadCount; ++i) {
+        out += "license_server_signatures_total{worker=\"" + std::to_string(i) + "\"} " +
+               std::to_string(m_threads[i].signatures.load(std::memory_order_relaxed)) + '\n';
+    }
+
+    appendHeader(out, "license_server_queue_depth", "gauge",
+                 "Connections handed to a worker thread but not yet picked up.");
+    for (unsigned i = 0; i < m_threadCount; ++i) {
+        out += "license_server_queue_depth{worker=\"" + std::to_string(i) + "\"} " +
+               std::to_string(m_threads[i].queueDepth.load(std::memory_order_relaxed)) + '\n';
+    }
+
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    for (unsigned i = 0; i < m_threadCount; ++i) {
+        hits += m_threads[i].cacheHits.load(std::memory_order_relaxed);
+        misses += m_threads[i].cacheMisses.load(std::memory_order_relaxed);
+    }
+    appendHeader(out, "license_server_cache_requests_total", "counter", "License requests by cache result.");
+    out += "license_server_cache_requests_total{result=\"hit\"} " + std::to_string(hits) + '\n';
+    out += "license_server_cache_requests_total{result=\"miss\"} " + std::to_string(misses) + '\n';
+    appendHeader(out, "license_server_cache_hit_ratio", "gauge",
+                 "Share of license requests served from the cache since start.");
+    out += "license_server_cache_hit_ratio " + number(hits + misses > 0 ? double(hits) / (hits + misses) : 0.0) + '\n';
+
+    appendHeader(out, "license_server_uptime_seconds", "gauge", "Time since the server started.");
+    std::chrono::duration<double> uptime = std::chrono::steady_clock::now() - m_startTime;
+    out += "license_server_uptime_seconds " + number(uptime.count()) + '\n';
+    return out;
+}
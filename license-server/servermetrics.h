@@ -0,0 +1,137 @@
+#ifndef SERVERMETRICS_H
+#define SERVERMETRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief The ServerMetrics class
+ *
+ * Issuance metrics of the LicenseServer, rendered in the Prometheus text
+ * exposition format by `GET /metrics`:
+ *
+ * - per-stage latency histograms (parse, sign, encode, write)
+ * - queue depth: connections handed to a worker but not yet picked up
+ * - cache hits and misses, and the resulting hit ratio
+ * - signatures per worker thread (use `rate()` for signatures per second)
+ *
+ * Every I/O worker owns one ThreadCounters block, aligned to a cache line.
+ * Its counters are only ever written by that worker, so an update is a
+ * relaxed load and store: no locked instruction, no shared cache line and no
+ * mutex on the signing path. A scrape reads all blocks with relaxed loads and
+ * sums them; values may be a few events apart from each other, which is fine
+ * for monitoring.
+ */
+class ServerMetrics
+{
+public:
+    /// Issuance stages with a latency histogram.
+    enum Stage {
+        Parse,     ///< Decoding and validating the request body
+        Sign,      ///< Signing the payload (cache misses only)
+        Encode,    ///< Building the license file
+        Write,     ///< Recording a new license in the registry
+        StageCount
+    };
+
+    /// Number of finite histogram buckets.
+    static constexpr std::size_t BucketCount = 14;
+
+    /// Upper bounds of the finite buckets in nanoseconds (25 µs to 1 s).
+    static constexpr std::uint64_t BucketBoundsNs[BucketCount] = {
+        25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000,
+        10000000, 25000000, 50000000, 100000000, 250000000, 1000000000};
+
+    /**
+     * @brief Counters of one worker thread.
+     *
+     * Written by the owning worker only, except queueDepth, which the
+     * listener thread increments when it hands over a connection.
+     */
+    struct alignas(64) ThreadCounters
+    {
+        std::atomic<std::uint64_t> buckets[StageCount][BucketCount + 1]; ///< Samples per bucket (last = +Inf), not cumulative
+        std::atomic<std::uint64_t> durationNs[StageCount];                ///< Sum of all samples per stage
+        std::atomic<std::uint64_t> signatures;                            ///< Licenses signed
+        std::atomic<std::uint64_t> cacheHits;                             ///< Requests served from the cache
+        std::atomic<std::uint64_t> cacheMisses;                           ///< Requests that needed a new signature
+        std::atomic<std::int64_t> queueDepth;                             ///< Connections waiting for this worker
+
+        ThreadCounters();
+
+        /**
+         * @brief Adds a latency sample.
+         * @param stage Stage that was measured.
+         * @param elapsedNs Duration in nanoseconds.
+         */
+        void record(Stage stage, std::uint64_t elapsedNs);
+
+        /**
+         * @brief Increments a counter owned by this worker.
+         * @param counter One of the counters of this block.
+         */
+        static void increment(std::atomic<std::uint64_t> &counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Measures one stage from construction until stop() or destruction.
+     */
+    class Timer
+    {
+    public:
+        /**
+         * @brief Starts measuring.
+         * @param counters Counters of the calling worker.
+         * @param stage Stage being measured.
+         */
+        Timer(ThreadCounters &counters, Stage stage);
+        ~Timer();
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        /**
+         * @brief Records the elapsed time; later calls do nothing.
+         */
+        void stop();
+
+    private:
+        ThreadCounters &m_counters;                      ///< Counters of the measuring worker
+        Stage m_stage;                                   ///< Stage being measured
+        std::chrono::steady_clock::time_point m_start;   ///< Start of the measurement
+        bool m_running;                                  ///< false once recorded
+    };
+
+    /**
+     * @brief Creates the counters for a fixed number of workers.
+     * @param threadCount Number of I/O worker threads.
+     */
+    explicit ServerMetrics(unsigned threadCount);
+
+    /**
+     * @brief Returns the counters of a worker.
+     * @param index Worker index (0 to threadCount - 1).
+     * @return Counters owned by that worker.
+     */
+    ThreadCounters &thread(unsigned index);
+
+    /**
+     * @brief Renders all metrics in the Prometheus text format (version 0.0.4).
+     * @return Exposition text.
+     */
+    std::string render() const;
+
+private:
+    unsigned m_threadCount;                                  ///< Number of workers
+    std::unique_ptr<ThreadCounters[]> m_threads;             ///< One block per worker
+    std::chrono::steady_clock::time_point m_startTime;       ///< Creation time, for the uptime gauge
+};
+
+#endif // SERVERMETRICS_H
@@ -0,0 +1,52 @@
+#include "hardwarefingerprint.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Gives every test an empty stand-in for `/sys/block`.
+ */
+class HardwareFingerprintTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const ::testing::TestInfo *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        blockDirectory = fs::temp_directory_path() / (std::string("cryptotests-block-") + info->name());
+        fs::remove_all(blockDirectory);
+        fs::create_directories(blockDirectory);
+    }
+
+    void TearDown() override { fs::remove_all(blockDirectory); }
+
+    /**
+     * @brief Creates `<device>/device/serial` with the given contents.
+     * @param device Block device name.
+     * @param contents File contents.
+     */
+    void writeSerial(const std::string &device, const std::string &contents) {
+        fs::create_directories(blockDirectory / device / "device");
+        std::ofstream file(blockDirectory / device / "device" / "serial", std::ios::binary);
+        file << contents;
+    }
+
+    fs::path blockDirectory;
+};
+
+TEST_F(HardwareFingerprintTest, LegacyDiskSerialIsTheFirstLineOfSdaWithoutWhitespace) {
+    writeSerial("sda", "  WD-WCC4 E1234567\t\r\nsecond line\n");
+    EXPECT_EQ(HardwareFingerprint::legacyDiskSerialNumber(blockDirectory.string()), "WD-WCC4E1234567");
+}
+
+TEST_F(HardwareFingerprintTest, LegacyDiskSerialReadsNoOtherDevice) {
+    // The legacy client only ever read sda; NVMe machines were licensed with UNKNOWN_DISK
+    writeSerial("nvme0n1", "S4EWNX0R123456\n");
+    writeSerial("sdb", "Z1E2F3G4\n");
+    EXPECT_EQ(HardwareFingerprint::legacyDiskSerialNumber(blockDirectory.string()), "");
+
+    writeSerial("sda", " \n");
+    EXPECT_EQ(HardwareFingerprint::legacyDiskSerialNumber(blockDirectory.string()), "");
+}
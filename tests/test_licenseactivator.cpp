@@ -0,0 +1,47 @@
+#include "licenseactivator.h"
+
+#include <licenseclaims.h>
+
+#include <gtest/gtest.h>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <string>
+
+namespace {
+
+/**
+ * @brief Parses a license request body.
+ * @param components Component hashes passed to the activator; may be null.
+ * @return Request JSON.
+ */
+QJsonObject request(const LicenseClaims::ComponentHashes *components) {
+    return QJsonDocument::fromJson(LicenseActivator::requestPayload("machine-a", components)).object();
+}
+
+} // namespace
+
+TEST(LicenseActivatorTest, SendsCompleteComponentSets) {
+    LicenseClaims::ComponentHashes components;
+    for (int i = 0; i < LicenseClaims::ComponentCount; ++i)
+        components[i] = std::string(64, "abc"[i]);
+
+    QJsonObject body = request(&components);
+    EXPECT_EQ(body["hardwareId"].toString(), "machine-a");
+    ASSERT_TRUE(body["components"].isObject());
+    QJsonObject sent = body["components"].toObject();
+    EXPECT_EQ(sent.size(), LicenseClaims::ComponentCount);
+    EXPECT_EQ(sent["disk"].toString().toStdString(), components[LicenseClaims::Disk]);
+}
+
+TEST(LicenseActivatorTest, LeavesOutIncompleteComponentSets) {
+    // E.g. Linux, where the CPU ID is a constant and is not hashed
+    LicenseClaims::ComponentHashes components;
+    components[LicenseClaims::Mac] = std::string(64, 'a');
+    components[LicenseClaims::Disk] = std::string(64, 'b');
+    EXPECT_FALSE(request(&components).contains("components"));
+
+    EXPECT_FALSE(request(nullptr).contains("components"));
+    EXPECT_EQ(request(nullptr)["hardwareId"].toString(), "machine-a");
+}
@@ -0,0 +1,138 @@
+#include "licensecache.h"
+
+#include <licenseclaims.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(LicenseCacheTest, KeysCannotBeForgedThroughTheHardwareId) {
+    LicenseClaims withComponents;
+    for (int i = 0; i < LicenseClaims::ComponentCount; ++i)
+        withComponents.components[i] = std::string(64, "abc"[i]);
+
+    const std::string key = LicenseCache::makeKey("X", "kid", LicenseFormat::Json, withComponents);
+    const std::string forged = "X|0||" + LicenseClaims::componentList(withComponents.components) + "|2";
+    EXPECT_NE(LicenseCache::makeKey(forged, "kid", LicenseFormat::Json), key);
+    EXPECT_NE(LicenseCache::makeKey("X", "kid", LicenseFormat::Json), key);
+    EXPECT_NE(LicenseCache::makeKey("X", "kid", LicenseFormat::Binary, withComponents), key);
+    EXPECT_EQ(LicenseCache::makeKey("X", "kid", LicenseFormat::Json, withComponents), key);
+}
+
+TEST(LicenseCacheTest, ProducesOncePerKey) {
+    LicenseCache cache(4, std::string());
+    int produced = 0;
+    auto produce = [&](std::string &out) {
+        ++produced;
+        out = "license";
+        return true;
+    };
+    std::string license;
+    bool cached = true;
+    ASSERT_TRUE(cache.getOrCreate("a", produce, license, &cached));
+    EXPECT_FALSE(cached);
+    ASSERT_TRUE(cache.getOrCreate("a", produce, license, &cached));
+    EXPECT_TRUE(cached);
+    EXPECT_EQ(license, "license");
+    EXPECT_EQ(produced, 1);
+}
+
+namespace {
+
+constexpr int CallerCount = 8;
+
+/**
+ * @brief Runs @p call on CallerCount threads while the first producer is held.
+ *
+ * @p produce must signal @p started once it runs and then wait for
+ * @p release; the other callers are started only after that, so they find
+ * the key in flight. The producer is released once every caller is running.
+ */
+void runWhileProducing(const std::function<void()> &call, std::promise<void> &started, std::promise<void> &release)
+{
+    std::atomic<int> running(0);
+    std::vector<std::thread> callers;
+    callers.emplace_back([&] { ++running; call(); });
+    started.get_future().wait();
+    for (int i = 1; i < CallerCount; ++i)
+        callers.emplace_back([&] { ++running; call(); });
+    while (running < CallerCount)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    release.set_value();
+    for (std::thread &caller : callers)
+        caller.join();
+}
+
+} // namespace
+
+TEST(LicenseCacheTest, CoalescesConcurrentMisses) {
+    LicenseCache cache(4, std::string());
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> produced(0);
+    auto produce = [&](std::string &out) {
+        if (++produced == 1)
+            started.set_value();
+        released.wait();
+        out = "license";
+        return true;
+    };
+
+    std::atomic<int> succeeded(0);
+    std::atomic<int> misses(0);
+    runWhileProducing([&] {
+        std::string license;
+        bool cached = true;
+        if (cache.getOrCreate("a", produce, license, &cached) && license == "license")
+            ++succeeded;
+        if (!cached)
+            ++misses;
+    }, started, release);
+
+    EXPECT_EQ(produced, 1);
+    EXPECT_EQ(misses, 1);
+    EXPECT_EQ(succeeded, CallerCount);
+}
+
+TEST(LicenseCacheTest, HandsProducerErrorsToWaitersAndRetries) {
+    LicenseCache cache(4, std::string());
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> produced(0);
+    auto fail = [&](std::string &) -> bool {
+        if (++produced == 1)
+            started.set_value();
+        released.wait();
+        throw std::runtime_error("signing failed");
+    };
+
+    std::atomic<int> errors(0);
+    runWhileProducing([&] {
+        std::string license;
+        try {
+            cache.getOrCreate("a", fail, license);
+        } catch (const std::runtime_error &) {
+            ++errors;
+        }
+    }, started, release);
+
+    EXPECT_EQ(errors, CallerCount);
+    EXPECT_LT(produced, CallerCount);
+    EXPECT_EQ(cache.size(), 0u);
+
+    // The failed key is released, so the next request produces again
+    std::string license;
+    bool cached = true;
+    ASSERT_TRUE(cache.getOrCreate("a", [](std::string &out) { out = "license"; return true; }, license, &cached));
+    EXPECT_FALSE(cached);
+    EXPECT_EQ(license, "license");
+}
@@ -0,0 +1,73 @@
+#include "hardwarefingerprint.h"
+#include "licensegenerator.h"
+
+#include <licenseclaims.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+const std::string Fingerprint = HardwareFingerprint::combine("AA:BB:CC:DD:EE:FF", "DISK123", "GenuineIntel_906ea");
+
+/**
+ * @brief Returns the component hashes of the test machine with some parts replaced.
+ * @param mac MAC address.
+ * @param disk Disk serial number.
+ * @param cpu CPU identifier.
+ * @return Hashes keyed with the licensed fingerprint.
+ */
+LicenseClaims::ComponentHashes machine(const std::string &mac = "AA:BB:CC:DD:EE:FF",
+                                       const std::string &disk = "DISK123",
+                                       const std::string &cpu = "GenuineIntel_906ea") {
+    return HardwareFingerprint::componentHashes(mac, disk, cpu, Fingerprint);
+}
+
+} // namespace
+
+TEST(LicenseClaimsTest, ToleratesOneChangeButNotOfTheDisk) {
+    LicenseClaims claims;
+    claims.components = machine();
+    ASSERT_TRUE(claims.hasAllComponents());
+
+    EXPECT_TRUE(claims.componentsMatch(machine()));
+    EXPECT_TRUE(claims.componentsMatch(machine("11:22:33:44:55:66")));
+    EXPECT_TRUE(claims.componentsMatch(machine("AA:BB:CC:DD:EE:FF", "DISK123", "AuthenticAMD_a20f10")));
+    EXPECT_FALSE(claims.componentsMatch(machine("AA:BB:CC:DD:EE:FF", "OTHERDISK")));
+    EXPECT_FALSE(claims.componentsMatch(machine("11:22:33:44:55:66", "DISK123", "AuthenticAMD_a20f10")));
+}
+
+TEST(LicenseClaimsTest, RejectsPartialComponentSets) {
+    LicenseClaims claims;
+    claims.components = machine();
+    claims.components[LicenseClaims::Cpu].clear();
+    EXPECT_FALSE(claims.hasAllComponents());
+    EXPECT_FALSE(claims.componentsMatch(machine()));
+
+
+    LicenseClaims::ComponentHashes parsed;
+    const std::string partial = "mac:" + claims.components[LicenseClaims::Mac] +
+                                ",disk:" + claims.components[LicenseClaims::Disk];
+    EXPECT_EQ(LicenseGenerator::parseRequestLine(Fingerprint + " " + partial, parsed), Fingerprint);
+    EXPECT_TRUE(parsed[LicenseClaims::Mac].empty());
+
+    const std::string complete = LicenseClaims::componentList(machine());
+    EXPECT_EQ(LicenseGenerator::parseRequestLine(Fingerprint + " " + complete, parsed), Fingerprint);
+    EXPECT_EQ(parsed, machine());
+}
+
+TEST(LicenseClaimsTest, LeavesOutConstantComponents) {
+    LicenseClaims::ComponentHashes onLinux = machine("AA:BB:CC:DD:EE:FF", "DISK123", "0");
+    EXPECT_FALSE(onLinux[LicenseClaims::Mac].empty());
+    EXPECT_TRUE(onLinux[LicenseClaims::Cpu].empty());
+    EXPECT_TRUE(machine("00:00:00:00:00:00")[LicenseClaims::Mac].empty());
+    EXPECT_TRUE(machine("AA:BB:CC:DD:EE:FF", "UNKNOWN_DISK")[LicenseClaims::Disk].empty());
+}
+
+TEST(LicenseClaimsTest, KeysComponentHashesWithTheFingerprint) {
+    LicenseClaims::ComponentHashes other =
+        HardwareFingerprint::componentHashes("AA:BB:CC:DD:EE:FF", "DISK123", "GenuineIntel_906ea", "other");
+    EXPECT_NE(other[LicenseClaims::Mac], machine()[LicenseClaims::Mac]);
+    EXPECT_EQ(machine()[LicenseClaims::Disk].size(), 64u);
+}
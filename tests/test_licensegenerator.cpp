@@ -0,0 +1,51 @@
+#include "licensegenerator.h"
+#include "licensesigner.h"
+#include "testkeys.h"
+
+#include <licenseclaims.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+TEST(LicenseGeneratorTest, RejectsHardwareIdsThatNeedEscaping) {
+    EXPECT_TRUE(LicenseGenerator::isValidHardwareId("MACHINE-01_a.b"));
+    EXPECT_FALSE(LicenseGenerator::isValidHardwareId(""));
+    EXPECT_FALSE(LicenseGenerator::isValidHardwareId("two words"));
+    EXPECT_FALSE(LicenseGenerator::isValidHardwareId("quote\"d"));
+    EXPECT_FALSE(LicenseGenerator::isValidHardwareId("back\\slash"));
+    EXPECT_FALSE(LicenseGenerator::isValidHardwareId("tab\there"));
+    EXPECT_FALSE(LicenseGenerator::isValidHardwareId(std::string(257, 'a')));
+
+    LicenseSigner signer;
+    ASSERT_TRUE(signer.loadPrivateKey(TestKeys::instance().privateKeyPath));
+    EXPECT_FALSE(LicenseGenerator::generateLicense("quote\"d", signer, TestKeys::instance().directory + "/bad.lic",
+                                                   LicenseFormat::Json, LicenseClaims()));
+}
+
+TEST(LicenseGeneratorTest, ReportsFailedWrites) {
+    if (!std::filesystem::exists("/dev/full"))
+        GTEST_SKIP() << "needs /dev/full";
+    LicenseSigner signer;
+    ASSERT_TRUE(signer.loadPrivateKey(TestKeys::instance().privateKeyPath));
+    EXPECT_FALSE(LicenseGenerator::generateLicense("MACHINE-01", signer, "/dev/full", LicenseFormat::Json,
+                                                   LicenseClaims()));
+}
+
+TEST(LicenseGeneratorTest, MapsDifferentIdsToDifferentFiles) {
+    const std::string fingerprint = "3f9a0c1d2e4b5a6978c0d1e2f3a4b5c6";
+    EXPECT_EQ(LicenseGenerator::licenseFileName(fingerprint), fingerprint + ".lic");
+    EXPECT_EQ(LicenseGenerator::licenseFileName("machine-01_a"), "machine-01_a.lic");
+
+    const std::string ids[] = {"a:b", "a.b", "a_b", "AB", "ab", "../ab"};
+    for (const std::string &a : ids) {
+        const std::string name = LicenseGenerator::licenseFileName(a);
+        EXPECT_EQ(name.find('/'), std::string::npos) << a;
+        for (const std::string &b : ids) {
+            if (a != b) {
+                EXPECT_NE(name, LicenseGenerator::licenseFileName(b)) << a << " " << b;
+            }
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#include "licensegenerator.h"
+#include "licenseparser.h"
+#include "licensesigner.h"
+#include "licenseverifier.h"
+#include "testkeys.h"
+
+#include <licenseclaims.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+/**
+ * @brief Signs licenses with the test key and parses them back.
+ */
+class LicenseParserTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(signer.loadPrivateKey(TestKeys::instance().privateKeyPath));
+        ASSERT_TRUE(verifier.loadPublicKey(TestKeys::instance().publicKeyPath));
+
+        claims.expiresAt = 1893456000;
+        claims.features = LicenseClaims::parseFeatureList("reports,export");
+        for (int i = 0; i < LicenseClaims::ComponentCount; ++i)
+            claims.components[i] = std::string(64, "abc"[i]);
+    }
+
+    /**
+     * @brief Issues a license the way LicenseGenerator does.
+     * @param format Output encoding.
+     * @param licenseClaims Claims to sign.
+     * @return License file contents.
+     */
+    std::string issue(LicenseFormat format, const LicenseClaims &licenseClaims) {
+        std::string signature;
+        EXPECT_TRUE(signer.signRaw(LicenseClaims::signingPayload(HardwareId, licenseClaims), signature));
+        return LicenseGenerator::buildLicense(HardwareId, signature, signer.algorithm(), format, licenseClaims,
+                                              signer.kid());
+    }
+
+    /**
+     * @brief Checks that a parsed license matches what was issued.
+     * @param view Parsed license.
+     * @param licenseClaims Claims that were signed.
+     */
+    void expectIssued(const LicenseParser::View &view, const LicenseClaims &licenseClaims) const {
+        EXPECT_TRUE(view.isComplete());
+        EXPECT_EQ(view.fingerprint, HardwareId);
+        EXPECT_EQ(view.algorithm, signer.algorithm());
+        EXPECT_EQ(view.keyId, signer.kid());
+        EXPECT_EQ(view.claims.expiresAt, licenseClaims.expiresAt);
+        EXPECT_EQ(view.claims.features, licenseClaims.features);
+        EXPECT_EQ(view.claims.components, licenseClaims.components);
+        EXPECT_EQ(view.claims.effectiveRequiredMatches(), licenseClaims.effectiveRequiredMatches());
+        EXPECT_TRUE(LicenseParser::verify(view, verifier));
+    }
+
+    static constexpr const char *HardwareId = "3f9a0c1d2e4b5a6978c0d1e2f3a4b5c6d7e8f90a1b2c3d4e5f60718293a4b5c6";
+
+    LicenseSigner signer;
+    LicenseVerifier verifier;
+    LicenseClaims claims;
+};
+
+TEST_F(LicenseParserTest, RoundTripsJsonLicense) {
+    const std::string license = issue(LicenseFormat::Json, claims);
+    LicenseParser::View view;
+    std::string error;
+    ASSERT_TRUE(LicenseParser::parse(license.data(), license.size(), view, &error)) << error;
+    expectIssued(view, claims);
+    EXPECT_FALSE(view.signature.empty());
+}
+
+TEST_F(LicenseParserTest, RoundTripsBinaryLicense) {
+    const std::string license = issue(LicenseFormat::Binary, claims);
+    LicenseParser::View view;
+    std::string error;
+    ASSERT_TRUE(LicenseParser::parse(license.data(), license.size(), view, &error)) << error;
+    expectIssued(view, claims);
+    EXPECT_FALSE(view.rawSignature.empty());
+}
+
+TEST_F(LicenseParserTest, RoundTripsLicenseWithoutClaims) {
+    for (LicenseFormat format : {LicenseFormat::Json, LicenseFormat::Binary}) {
+        const std::string license = issue(format, LicenseClaims());
+        LicenseParser::View view;
+        ASSERT_TRUE(LicenseParser::parse(license.data(), license.size(), view));
+        EXPECT_TRUE(view.claims.isEmpty());
+        expectIssued(view, LicenseClaims());
+    }
+}
+
+TEST_F(LicenseParserTest, DetectsTamperedClaims) {
+    std::string license = issue(LicenseFormat::Json, claims);
+    license.replace(license.find("1893456000"), 10, "1893456001");
+    LicenseParser::View view;
+    ASSERT_TRUE(LicenseParser::parse(license.data(), license.size(), view));
+    EXPECT_FALSE(LicenseParser::verify(view, verifier));
+}
+
+TEST(LicenseParserJsonTest, RejectsEscapedFields) {
+    const std::string escapedFields[] = {
+        R"({"hardwareFingerprint": "ab\u0063", "signature": "00"})",
+        R"({"hardwareFingerprint": "abc", "signature": "0\"0"})",
+        R"({"hardwareFingerprint": "abc", "signature": "00", "kid": "k\\1"})",
+        R"({"hardwareFingerprint": "abc", "signature": "00", "features": ["rep\u006frts"]})",
+    };
+    for (const std::string &license : escapedFields) {
+        LicenseParser::View view;
+        std::string error;
+        EXPECT_FALSE(LicenseParser::parse(license.data(), license.size(), view, &error)) << license;
+        EXPECT_FALSE(error.empty());
+    }
+}
+
+TEST(LicenseParserJsonTest, SkipsUnknownFields) {
+    const std::string license = " {\"note\": \"a \\\"quoted\\\" word\", \"extra\": [1, {\"x\": null}, true],\n"
+                                "  \"hardwareId\": \"abc\", \"signature\": \"00\"}\n";
+    LicenseParser::View view;
+    std::string error;
+    ASSERT_TRUE(LicenseParser::parse(license.data(), license.size(), view, &error)) << error;
+    EXPECT_EQ(view.fingerprint, "abc");
+    EXPECT_EQ(view.signature, "00");
+}
+
+TEST(LicenseParserJsonTest, RejectsMalformedDocuments) {
+    const std::string malformed[] = {
+        R"({"hardwareFingerprint": "abc", "signature": "00")",
+        R"({"hardwareFingerprint": "abc"} trailing)",
+        R"({"hardwareFingerprint": "abc", "expiresAt": "soon"})",
+        R"({"hardwareFingerprint": "abc", "components": {"mac": "1234"}})",
+        std::string(64, '[') + std::string(64, ']'),
+        "{\"deep\": " + std::string(64, '[') + std::string(64, ']') + "}",
+    };
+    for (const std::string &license : malformed) {
+        LicenseParser::View view;
+        EXPECT_FALSE(LicenseParser::parse(license.data(), license.size(), view)) << license;
+    }
+}
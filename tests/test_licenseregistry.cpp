@@ -0,0 +1,217 @@
+#include "licenseregistry.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Gives every test an empty registry directory.
+ */
+class LicenseRegistryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const ::testing::TestInfo *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        directory = fs::temp_directory_path() / (std::string("cryptotests-registry-") + info->name());
+        fs::remove_all(directory);
+    }
+
+    void TearDown() override { fs::remove_all(directory); }
+
+    /**
+     * @brief Opens the registry, appends licenses for some IDs and closes it cleanly.
+     * @param ids Hardware IDs to record, in order.
+     */
+    void populate(const std::vector<std::string> &ids) {
+        LicenseRegistry registry;
+        ASSERT_TRUE(registry.open(directory.string()));
+        for (const std::string &id : ids)
+            ASSERT_TRUE(registry.append(id, "RSA-SHA256", "key-1", "license-of-" + id));
+        registry.close();
+    }
+
+    /**
+     * @brief Appends raw bytes to registry.log.
+     * @param bytes Bytes to append.
+     */
+    void appendToLog(const std::string &bytes) {
+        std::ofstream log(logPath(), std::ios::binary | std::ios::app);
+        log.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    /**
+     * @brief Flips one byte of registry.log.
+     * @param offset Byte offset.
+     */
+    void corruptLog(std::uint64_t offset) {
+        std::fstream log(logPath(), std::ios::binary | std::ios::in | std::ios::out);
+        log.seekg(static_cast<std::streamoff>(offset));
+        char c = 0;
+        log.get(c);
+        log.seekp(static_cast<std::streamoff>(offset));
+        log.put(static_cast<char>(c ^ 0x5A));
+    }
+
+    fs::path logPath() const { return directory / "registry.log"; }
+    fs::path indexPath() const { return directory / "registry.idx"; }
+
+    fs::path directory;
+};
+
+/// Offset of the first hardware ID byte in the first record (record header and fixed payload fields).
+static constexpr std::uint64_t FirstIdOffset = 8 + 26;
+
+TEST_F(LicenseRegistryTest, FindsLatestLicenseAfterCleanReopen) {
+    populate({"machine-a", "machine-b", "machine-a"});
+
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    EXPECT_EQ(registry.size(), 3u);
+
+    LicenseRegistry::Record record;
+    ASSERT_TRUE(registry.find("machine-a", record));
+    EXPECT_EQ(record.license, "license-of-machine-a");
+    EXPECT_EQ(record.algorithm, "RSA-SHA256");
+    EXPECT_EQ(record.keyId, "key-1");
+    EXPECT_NE(record.previous, 0u);
+    EXPECT_FALSE(registry.find("machine-c", record));
+
+    int versions = 0;
+    EXPECT_TRUE(registry.history("machine-a", [&](const LicenseRegistry::Record &) { return ++versions > 0; }));
+    EXPECT_EQ(versions, 2);
+}
+
+TEST_F(LicenseRegistryTest, ScansTimelineLoadedAfterCleanReopen) {
+    populate({"machine-a", "machine-b"});
+
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    ASSERT_TRUE(registry.append("machine-c", "Ed25519", "key-2", "license-of-machine-c"));
+
+    std::vector<std::string> ids;
+    EXPECT_TRUE(registry.scan(0, INT64_MAX, [&](const LicenseRegistry::Record &record) {
+        ids.push_back(record.hardwareId);
+        return true;
+    }));
+    EXPECT_EQ(ids, (std::vector<std::string>{"machine-a", "machine-b", "machine-c"}));
+}
+
+TEST_F(LicenseRegistryTest, RebuildsMissingIndex) {
+    populate({"machine-a", "machine-b", "machine-a"});
+    fs::remove(indexPath());
+
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    EXPECT_EQ(registry.size(), 3u);
+    LicenseRegistry::Record record;
+    ASSERT_TRUE(registry.find("machine-b", record));
+    EXPECT_EQ(record.license, "license-of-machine-b");
+}
+
+TEST_F(LicenseRegistryTest, RebuildsIndexThatGrew) {
+    std::vector<std::string> ids;
+    for (int i = 0; i < 2000; ++i)
+        ids.push_back("machine-" + std::to_string(i));
+    populate(ids);
+
+    for (bool rebuild : {false, true}) {
+        if (rebuild)
+            fs::remove(indexPath());
+        LicenseRegistry registry;
+        ASSERT_TRUE(registry.open(directory.string()));
+        EXPECT_EQ(registry.size(), ids.size());
+        LicenseRegistry::Record record;
+        for (const std::string &id : ids) {
+            ASSERT_TRUE(registry.find(id, record)) << id;
+            EXPECT_EQ(record.license, "license-of-" + id);
+        }
+    }
+}
+
+TEST_F(LicenseRegistryTest, TruncatesTornTail) {
+    populate({"machine-a", "machine-b"});
+    const std::uintmax_t committed = fs::file_size(logPath());
+
+    // Record header that promises more payload than was written
+    appendToLog(std::string("\xFF\x00\x00\x00\x12\x34\x56\x78partial", 15));
+
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_EQ(fs::file_size(logPath()), committed);
+    ASSERT_TRUE(registry.append("machine-c", "RSA-SHA256", "key-1", "license-of-machine-c"));
+    LicenseRegistry::Record record;
+    EXPECT_TRUE(registry.find("machine-a", record));
+    EXPECT_TRUE(registry.find("machine-c", record));
+}
+
+TEST_F(LicenseRegistryTest, TruncatesZeroFilledTail) {
+    populate({"machine-a"});
+    const std::uintmax_t committed = fs::file_size(logPath());
+    appendToLog(std::string(4096, '\0'));
+
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    EXPECT_EQ(registry.size(), 1u);
+    EXPECT_EQ(fs::file_size(logPath()), committed);
+}
+
+TEST_F(LicenseRegistryTest, TruncatesDamagedLastRecord) {
+    populate({"machine-a"});
+    const std::uintmax_t firstRecord = fs::file_size(logPath());
+    populate({"machine-b"});
+    corruptLog(firstRecord + FirstIdOffset);
+    fs::remove(indexPath());
+
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    EXPECT_EQ(registry.size(), 1u);
+    EXPECT_EQ(fs::file_size(logPath()), firstRecord);
+}
+
+TEST_F(LicenseRegistryTest, RefusesToTruncateAfterDamagedRecord) {
+    populate({"machine-a", "machine-b", "machine-c"});
+    const std::uintmax_t size = fs::file_size(logPath());
+    corruptLog(FirstIdOffset);
+    fs::remove(indexPath());
+
+    LicenseRegistry registry;
+    EXPECT_FALSE(registry.open(directory.string()));
+    EXPECT_FALSE(registry.isOpen());
+    EXPECT_EQ(fs::file_size(logPath()), size);
+}
+
+TEST_F(LicenseRegistryTest, CleanIndexOpensWithoutReadingLog) {
+    populate({"machine-a", "machine-b"});
+    corruptLog(FirstIdOffset);
+
+    // The damage is only found once a scan needs the timeline
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    EXPECT_EQ(registry.size(), 2u);
+    LicenseRegistry::Record record;
+    EXPECT_TRUE(registry.find("machine-b", record));
+    EXPECT_FALSE(registry.scan(0, INT64_MAX, [](const LicenseRegistry::Record &) { return true; }));
+}
+
+TEST_F(LicenseRegistryTest, RebuildsIndexAfterUncleanShutdown) {
+    populate({"machine-a"});
+    {
+        LicenseRegistry registry;
+        ASSERT_TRUE(registry.open(directory.string()));
+        ASSERT_TRUE(registry.append("machine-b", "RSA-SHA256", "key-1", "license-of-machine-b"));
+        // Keep a copy of the dirty index as a crash would leave it
+        fs::copy_file(indexPath(), directory / "dirty.idx");
+    }
+    fs::copy_file(directory / "dirty.idx", indexPath(), fs::copy_options::overwrite_existing);
+
+    LicenseRegistry registry;
+    ASSERT_TRUE(registry.open(directory.string()));
+    EXPECT_EQ(registry.size(), 2u);
+    LicenseRegistry::Record record;
+    EXPECT_TRUE(registry.find("machine-b", record));
+}
@@ -0,0 +1,24 @@
+#include "licensesigner.h"
+#include "testkeys.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(LicenseSignerTest, RecognizesKeyStoreUris) {
+    EXPECT_TRUE(LicenseSigner::isKeyUri("pkcs11:token=licensing;object=license-key"));
+    EXPECT_TRUE(LicenseSigner::isKeyUri("file:/etc/cryptolicense/private_key.pem"));
+    EXPECT_FALSE(LicenseSigner::isKeyUri("private_key.pem"));
+    EXPECT_FALSE(LicenseSigner::isKeyUri("C:\\keys\\private_key.pem"));
+}
+
+TEST(LicenseSignerTest, FileUriIsNotHardwareBacked) {
+    LicenseSigner pemSigner;
+    ASSERT_TRUE(pemSigner.loadPrivateKey(TestKeys::instance().privateKeyPath));
+    EXPECT_FALSE(pemSigner.isHardwareBacked());
+
+    LicenseSigner uriSigner;
+    ASSERT_TRUE(uriSigner.loadPrivateKey("file:" + TestKeys::instance().privateKeyPath));
+    EXPECT_FALSE(uriSigner.isHardwareBacked());
+    EXPECT_EQ(uriSigner.keyId(), pemSigner.keyId());
+}
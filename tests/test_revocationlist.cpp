@@ -0,0 +1,91 @@
+#include "licensesigner.h"
+#include "licenseverifier.h"
+#include "revocationpublisher.h"
+#include "testkeys.h"
+
+#include <revocationlist.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Publishes revocation lists with the test key.
+ */
+class RevocationListTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        listPath = (fs::path(TestKeys::instance().directory) / "revocations.lst").string();
+        fs::remove(listPath);
+        fs::remove(RevocationPublisher::deltaPath(listPath, 1));
+        ASSERT_TRUE(signer.loadPrivateKey(TestKeys::instance().privateKeyPath));
+        ASSERT_TRUE(verifier.loadPublicKey(TestKeys::instance().publicKeyPath));
+    }
+
+    /**
+     * @brief Reads and parses a published list.
+     * @param data Receives the file contents the view points into.
+     * @param view Receives the parsed list.
+     */
+    void readList(std::string &data, RevocationList::View &view) {
+        ASSERT_TRUE(RevocationPublisher::readFile(listPath, data));
+        ASSERT_TRUE(RevocationList::parse(data.data(), data.size(), view));
+    }
+
+    /**
+     * @brief Checks a signature the way RevocationChecker does.
+     * @param signedData Header and entries.
+     * @param signature Raw signature.
+     * @return true if the signature is valid for the list.
+     */
+    bool verify(std::string_view signedData, std::string_view signature) const {
+        return verifier.verifyRawWithAnyKey(RevocationList::signingPayload(signedData),
+                                            reinterpret_cast<const unsigned char *>(signature.data()),
+                                            signature.size());
+    }
+
+    std::string listPath;
+    LicenseSigner signer;
+    LicenseVerifier verifier;
+};
+
+TEST_F(RevocationListTest, SignsListWithContextPrefix) {
+    ASSERT_TRUE(RevocationPublisher::update(listPath, {"machine-a", "machine-b"}, {}, signer));
+
+    std::string data;
+    RevocationList::View view;
+    readList(data, view);
+    EXPECT_EQ(view.sequence, 1u);
+    EXPECT_EQ(view.count, 2u);
+    EXPECT_TRUE(RevocationList::contains(view, RevocationList::hashFingerprint("machine-a")));
+    EXPECT_FALSE(RevocationList::contains(view, RevocationList::hashFingerprint("machine-c")));
+
+    EXPECT_TRUE(verify(view.signedData, view.signature));
+    const unsigned char *signature = reinterpret_cast<const unsigned char *>(view.signature.data());
+    EXPECT_FALSE(verifier.verifyRawWithAnyKey(view.signedData, signature, view.signature.size()));
+}
+
+TEST_F(RevocationListTest, DeltaRebuildsSignedList) {
+    ASSERT_TRUE(RevocationPublisher::update(listPath, {"machine-a", "machine-b"}, {}, signer));
+    std::string base;
+    RevocationList::View baseView;
+    readList(base, baseView);
+
+    ASSERT_TRUE(RevocationPublisher::update(listPath, {"machine-c"}, {"machine-a"}, signer));
+    std::string target;
+    RevocationList::View targetView;
+    readList(target, targetView);
+    EXPECT_EQ(targetView.sequence, 2u);
+
+    std::string delta;
+    ASSERT_TRUE(RevocationPublisher::readFile(RevocationPublisher::deltaPath(listPath, 1), delta));
+    RevocationList::DeltaView deltaView;
+    ASSERT_TRUE(RevocationList::parseDelta(delta.data(), delta.size(), deltaView));
+    std::string body;
+    ASSERT_TRUE(RevocationList::applyDelta(baseView, deltaView, body));
+    EXPECT_EQ(body, std::string(targetView.signedData));
+    EXPECT_TRUE(verify(body, deltaView.signature));
+}
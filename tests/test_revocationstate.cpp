@@ -0,0 +1,99 @@
+#include "licensegenerator.h"
+#include "licensesigner.h"
+#include "licensevalidator.h"
+#include "licenseverifier.h"
+#include "revocationpublisher.h"
+#include "revocationstate.h"
+#include "testkeys.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Validates a license against revocation lists published with the test key.
+ *
+ * Qt's test mode keeps the sealing key and the states out of the user's real
+ * application data directory.
+ */
+class RevocationStateTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        QCoreApplication::setApplicationName("CryptoClientTests");
+        QStandardPaths::setTestModeEnabled(true);
+        QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).removeRecursively();
+    }
+
+    void SetUp() override {
+        const fs::path directory = TestKeys::instance().directory;
+        const std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        listPath = (directory / (name + ".lst")).string();
+        licensePath = (directory / (name + ".lic")).string();
+        fs::remove(listPath);
+        fs::remove(RevocationPublisher::deltaPath(listPath, 1));
+        ASSERT_TRUE(signer.loadPrivateKey(TestKeys::instance().privateKeyPath));
+        ASSERT_TRUE(verifier.loadPublicKey(TestKeys::instance().publicKeyPath));
+        ASSERT_TRUE(LicenseGenerator::generateLicense(Fingerprint, signer, licensePath, LicenseFormat::Json,
+                                                      LicenseClaims()));
+    }
+
+    /**
+     * @brief Validates the test license on the licensed machine.
+     * @return Outcome of the revocation check.
+     */
+    LicenseValidator::Status validate() const {
+        return LicenseValidator::validate(QString::fromStdString(licensePath), QString::fromLatin1(Fingerprint),
+                                          verifier, QString::fromStdString(listPath))
+            .status;
+    }
+
+    static constexpr const char *Fingerprint = "machine-a";
+
+    std::string listPath;
+    std::string licensePath;
+    LicenseSigner signer;
+    LicenseVerifier verifier;
+};
+
+TEST_F(RevocationStateTest, KeepsStateAwayFromTheList) {
+    const QString statePath = RevocationState::statePath(QString::fromStdString(listPath));
+    EXPECT_FALSE(statePath.startsWith(QString::fromStdString(TestKeys::instance().directory)));
+    EXPECT_NE(statePath, RevocationState::statePath(QString::fromStdString(listPath + ".other")));
+}
+
+TEST_F(RevocationStateTest, DeletingListAndStateFailsClosed) {
+    ASSERT_TRUE(RevocationPublisher::update(listPath, {"machine-b"}, {}, signer));
+    EXPECT_EQ(validate(), LicenseValidator::Status::Valid);
+
+    ASSERT_TRUE(RevocationPublisher::update(listPath, {Fingerprint}, {}, signer));
+    EXPECT_EQ(validate(), LicenseValidator::Status::Revoked);
+
+    fs::remove(listPath);
+    QFile::remove(RevocationState::statePath(QString::fromStdString(listPath)));
+    EXPECT_TRUE(RevocationState::exists(QString::fromStdString(listPath)));
+    EXPECT_EQ(validate(), LicenseValidator::Status::RevocationUnavailable);
+}
+
+TEST_F(RevocationStateTest, RejectsRolledBackList) {
+    ASSERT_TRUE(RevocationPublisher::update(listPath, {"machine-b"}, {}, signer));
+    std::string older;
+    ASSERT_TRUE(RevocationPublisher::readFile(listPath, older));
+    ASSERT_TRUE(RevocationPublisher::update(listPath, {Fingerprint}, {}, signer));
+    EXPECT_EQ(validate(), LicenseValidator::Status::Revoked);
+
+    fs::remove(listPath);
+    {
+        std::ofstream out(listPath, std::ios::binary);
+        out << older;
+    }
+    EXPECT_EQ(validate(), LicenseValidator::Status::RevocationUnavailable);
+}
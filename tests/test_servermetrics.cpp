@@ -0,0 +1,77 @@
+#include "servermetrics.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+/**
+ * @brief Checks that the exposition text contains a complete line.
+ * @param text Rendered metrics.
+ * @param line Expected line without the line break.
+ * @return Assertion result naming the missing line.
+ */
+::testing::AssertionResult hasLine(const std::string &text, const std::string &line) {
+    if (text.compare(0, line.size() + 1, line + '\n') == 0 || text.find('\n' + line + '\n') != std::string::npos)
+        return ::testing::AssertionSuccess();
+    return ::testing::AssertionFailure() << "missing line: " << line;
+}
+
+} // namespace
+
+TEST(ServerMetricsTest, SumsHistogramsOverWorkers) {
+    ServerMetrics metrics(2);
+    metrics.thread(0).record(ServerMetrics::Sign, 20000);      // <= 25 µs
+    metrics.thread(0).record(ServerMetrics::Sign, 30000);      // <= 50 µs
+    metrics.thread(1).record(ServerMetrics::Sign, 2000000000); // beyond the last bound
+    metrics.thread(1).record(ServerMetrics::Write, 1000000);   // exactly on a bound
+
+    const std::string text = metrics.render();
+    const std::string sign = "license_server_stage_duration_seconds_bucket{stage=\"sign\",le=";
+    EXPECT_TRUE(hasLine(text, sign + "\"2.5e-05\"} 1"));
+    EXPECT_TRUE(hasLine(text, sign + "\"5e-05\"} 2"));
+    EXPECT_TRUE(hasLine(text, sign + "\"1\"} 2"));
+    EXPECT_TRUE(hasLine(text, sign + "\"+Inf\"} 3"));
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_sum{stage=\"sign\"} 2.00005"));
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_count{stage=\"sign\"} 3"));
+
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_bucket{stage=\"write\",le=\"0.0005\"} 0"));
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_bucket{stage=\"write\",le=\"0.001\"} 1"));
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_sum{stage=\"write\"} 0.001"));
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_count{stage=\"write\"} 1"));
+
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_bucket{stage=\"parse\",le=\"+Inf\"} 0"));
+    EXPECT_TRUE(hasLine(text, "license_server_stage_duration_seconds_count{stage=\"parse\"} 0"));
+    EXPECT_TRUE(hasLine(text, "# TYPE license_server_stage_duration_seconds histogram"));
+}
+
+TEST(ServerMetricsTest, ReportsCountersAndCacheHitRatio) {
+    ServerMetrics metrics(2);
+    EXPECT_TRUE(hasLine(metrics.render(), "license_server_cache_hit_ratio 0"));
+
+    ServerMetrics::ThreadCounters::increment(metrics.thread(0).cacheHits);
+    ServerMetrics::ThreadCounters::increment(metrics.thread(0).cacheHits);
+    ServerMetrics::ThreadCounters::increment(metrics.thread(1).cacheHits);
+    ServerMetrics::ThreadCounters::increment(metrics.thread(1).cacheMisses);
+    ServerMetrics::ThreadCounters::increment(metrics.thread(1).signatures);
+    metrics.thread(0).queueDepth.store(2);
+
+    const std::string text = metrics.render();
+    EXPECT_TRUE(hasLine(text, "license_server_cache_requests_total{result=\"hit\"} 3"));
+    EXPECT_TRUE(hasLine(text, "license_server_cache_requests_total{result=\"miss\"} 1"));
+    EXPECT_TRUE(hasLine(text, "license_server_cache_hit_ratio 0.75"));
+    EXPECT_TRUE(hasLine(text, "license_server_signatures_total{worker=\"0\"} 0"));
+    EXPECT_TRUE(hasLine(text, "license_server_signatures_total{worker=\"1\"} 1"));
+    EXPECT_TRUE(hasLine(text, "license_server_queue_depth{worker=\"0\"} 2"));
+}
+
+TEST(ServerMetricsTest, TimerRecordsOnce) {
+    ServerMetrics metrics(1);
+    {
+        ServerMetrics::Timer timer(metrics.thread(0), ServerMetrics::Encode);
+        timer.stop();
+        timer.stop();
+    }
+    EXPECT_TRUE(hasLine(metrics.render(), "license_server_stage_duration_seconds_count{stage=\"encode\"} 1"));
+}
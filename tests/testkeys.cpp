@@ -0,0 +1,47 @@
+#include "testkeys.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+
+/**
+ * @brief Returns the process-wide keys, creating them on first use.
+ * @return Shared keys.
+ */
+const TestKeys &TestKeys::instance()
+{
+    static const TestKeys keys = [] {
+        TestKeys k;
+        // One directory per process, so test processes run in parallel do not share files
+        std::filesystem::path dir = std::filesystem::temp_directory_path() /
+                                    ("cryptotests-" + std::to_string(std::random_device()()));
+        std::filesystem::create_directories(dir);
+        k.directory = dir.string();
+        k.privateKeyPath = (dir / "ed25519_private.pem").string();
+        k.publicKeyPath = (dir / "ed25519_public.pem").string();
+
+        EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+        EVP_PKEY *key = nullptr;
+        bool generated = ctx && EVP_PKEY_keygen_init(ctx) == 1 && EVP_PKEY_keygen(ctx, &key) == 1;
+        EVP_PKEY_CTX_free(ctx);
+        if (!generated)
+            throw std::runtime_error("key generation failed");
+
+        FILE *privateFile = fopen(k.privateKeyPath.c_str(), "w");
+        FILE *publicFile = fopen(k.publicKeyPath.c_str(), "w");
+        bool ok = privateFile && publicFile &&
+                  PEM_write_PrivateKey(privateFile, key, nullptr, nullptr, 0, nullptr, nullptr) == 1 &&
+                  PEM_write_PUBKEY(publicFile, key) == 1;
+        if (privateFile) fclose(privateFile);
+        if (publicFile) fclose(publicFile);
+        EVP_PKEY_free(key);
+        if (!ok)
+            throw std::runtime_error("could not write key pair");
+        return k;
+    }();
+    return keys;
+}
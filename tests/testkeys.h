@@ -0,0 +1,25 @@
+#ifndef TESTKEYS_H
+#define TESTKEYS_H
+
+#include <string>
+
+/**
+ * @brief Signing keys shared by all tests.
+ *
+ * Created once per process in its own temporary directory: an Ed25519 key pair,
+ * which is fast to generate and to use.
+ */
+struct TestKeys
+{
+    std::string directory;      ///< Temporary working directory
+    std::string privateKeyPath; ///< Ed25519 private key (PEM)
+    std::string publicKeyPath;  ///< Ed25519 public key (PEM)
+
+    /**
+     * @brief Returns the process-wide keys, creating them on first use.
+     * @return Shared keys.
+     */
+    static const TestKeys &instance();
+};
+
+#endif // TESTKEYS_H